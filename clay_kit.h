@@ -105,6 +105,54 @@ typedef ClayKit_TextDimensions (*ClayKit_MeasureTextCallback)(
     void *user_data
 );
 
+/* One text to measure in a batch. text is not NUL-terminated. */
+typedef struct ClayKit_MeasureRequest {
+    const char *text;
+    uint32_t length;
+    uint16_t font_id;
+    uint16_t font_size;
+} ClayKit_MeasureRequest;
+
+/* Measures count requests into out[0..count). The requests are independent,
+ * so a backend can look up each font once, or split a batch across threads. */
+typedef void (*ClayKit_MeasureTextBatchCallback)(
+    const ClayKit_MeasureRequest *requests,
+    ClayKit_TextDimensions *out,
+    uint32_t count,
+    void *user_data
+);
+
+/* Returns a time in seconds, e.g. raylib's GetTime */
+typedef double (*ClayKit_ClockCallback)(void);
+
+/* Most requests ClayKit batches into one measure_text_batch call (at
+ * least 4) */
+#ifndef CLAYKIT_MEASURE_BATCH
+#define CLAYKIT_MEASURE_BATCH 16
+#endif
+
+/* Kerning adjustment added between codepoints left and right */
+typedef struct ClayKit_KerningPair {
+    uint32_t left;
+    uint32_t right;
+    float amount;
+} ClayKit_KerningPair;
+
+/* Advance widths of one font at one size, so ClayKit can measure text in
+ * it without calling measure_text. The struct and its arrays are user
+ * memory and must outlive the registration. */
+typedef struct ClayKit_FontMetrics {
+    uint16_t font_id;
+    uint16_t font_size;
+    uint32_t first;                    /* Codepoint of advances[0], e.g. 32 */
+    uint32_t count;                    /* Entries in advances */
+    const float *advances;             /* advances[cp - first]: width of codepoint cp */
+    float fallback;                    /* Width of codepoints outside the table */
+    const ClayKit_KerningPair *kerning; /* Sorted by (left, right), NULL for none */
+    uint32_t kerning_count;
+    struct ClayKit_FontMetrics *next;  /* Set by ClayKit_RegisterFontMetrics */
+} ClayKit_FontMetrics;
+
 /* ============================================================================
  * Component State
  * ============================================================================ */
@@ -114,8 +162,97 @@ struct ClayKit_State {
     uint32_t id;
     uint32_t flags;  /* component-specific bits */
     float value;     /* for sliders, progress, etc. */
+    uint32_t frame;  /* ctx->frame when last looked up */
+    uint32_t blob;   /* State pool handle (0 = none), see ClayKit_GetStateBlob */
 };
 
+/* State pool: variable-size per-element state blobs in user memory.
+ * Blobs are bucketed into power-of-two size classes from 16 to 256 bytes.
+ * The pool is split into fixed-size pages, and each page holds blobs of a
+ * single class, so blobs of one kind sit next to each other in memory. */
+#define CLAYKIT_POOL_CLASS_COUNT 5
+#define CLAYKIT_POOL_MIN_BLOB 16
+#define CLAYKIT_POOL_MAX_BLOB 256
+#ifndef CLAYKIT_POOL_PAGE_SIZE
+#define CLAYKIT_POOL_PAGE_SIZE 1024
+#endif
+/* A page must hold at least one blob of the largest class, keep blobs
+ * 16-byte aligned, and hold few enough blobs for a u8 live count */
+#if CLAYKIT_POOL_PAGE_SIZE < CLAYKIT_POOL_MAX_BLOB || CLAYKIT_POOL_PAGE_SIZE % CLAYKIT_POOL_MIN_BLOB != 0 \
+    || CLAYKIT_POOL_PAGE_SIZE / CLAYKIT_POOL_MIN_BLOB > 255
+#error "CLAYKIT_POOL_PAGE_SIZE must be a multiple of 16 from 256 to 4080"
+#endif
+
+/* Seconds between two presses at the same offset that make a double-click */
+#ifndef CLAYKIT_DOUBLE_CLICK_TIME
+#define CLAYKIT_DOUBLE_CLICK_TIME 0.4f
+#endif
+
+/* Appended to truncated text. ASCII by default, as not every font has
+ * U+2026 (define as "\xe2\x80\xa6" for a single-glyph ellipsis). */
+#ifndef CLAYKIT_ELLIPSIS
+#define CLAYKIT_ELLIPSIS "..."
+#endif
+
+/* Width truncated text assumes on its first frame, before its container
+ * has a width from a previous layout */
+#ifndef CLAYKIT_TRUNCATE_INITIAL_WIDTH
+#define CLAYKIT_TRUNCATE_INITIAL_WIDTH 1024.0f
+#endif
+
+typedef struct ClayKit_StatePool {
+    uint8_t *pages;        /* page_count pages, 16-byte aligned */
+    uint8_t *page_class;   /* Size class of each page */
+    uint8_t *page_live;    /* Live blobs on each page, at most 255 */
+    uint32_t page_count;
+    uint32_t pages_used;   /* Pages carved so far (high-water mark) */
+    uint32_t free_head[CLAYKIT_POOL_CLASS_COUNT];  /* Free list per class (offset + 1, 0 = empty) */
+    uint32_t free_pages;   /* Empty carved pages (page + 1, 0 = none) */
+    uint32_t free_page_count;
+    uint32_t blob_count;   /* Live blobs */
+} ClayKit_StatePool;
+
+/* ============================================================================
+ * Stats
+ * ============================================================================ */
+
+/* Usage of one fixed-capacity pool. Peaks and overflow counts are kept per
+ * frame (reset by ClayKit_BeginFrame) and for all time (reset by
+ * ClayKit_ResetStats), so buffers can be sized from real workloads. */
+typedef struct ClayKit_PoolStats {
+    uint32_t used;             /* Current usage */
+    uint32_t capacity;         /* 0 = bounded only by the frame arena */
+    uint32_t frame_peak;       /* High-water mark this frame */
+    uint32_t peak;             /* All-time high-water mark */
+    uint32_t frame_overflows;  /* Failed requests this frame */
+    uint32_t overflows;        /* All-time failed requests */
+} ClayKit_PoolStats;
+
+/* Text measurement counters. measure_frame covers the current frame (reset
+ * by ClayKit_BeginFrame), measure all time (reset by ClayKit_ResetStats). */
+typedef struct ClayKit_MeasureStats {
+    uint64_t calls;         /* measure_text and measure_text_batch calls */
+    uint64_t texts;         /* Texts measured, by the callbacks or font metrics */
+    uint64_t bytes;         /* Bytes in those texts */
+    double seconds;         /* Time spent in the callbacks, see ClayKit_SetMeasureClock */
+    uint64_t clay_lookups;  /* Clay measure-cache lookups, see ClayKit_EndFrame */
+    uint64_t clay_misses;   /* Lookups Clay had to measure text for */
+} ClayKit_MeasureStats;
+
+typedef struct ClayKit_Stats {
+    ClayKit_PoolStats state_slots;        /* ClayKit_State table entries */
+    ClayKit_PoolStats state_pool_pages;   /* ClayKit_SetStatePool pages */
+    ClayKit_PoolStats frame_arena;        /* Frame arena bytes */
+    ClayKit_PoolStats icons;              /* Icon render data (from the frame arena) */
+    ClayKit_PoolStats list_numbers;       /* Ordered-list numbers (from the frame arena) */
+    ClayKit_PoolStats clay_elements;      /* Clay layout elements, see ClayKit_EndFrame */
+    ClayKit_PoolStats clay_measure_words; /* Clay measure-text cache words */
+    uint64_t style_cache_hits;            /* See ClayKit_SetStyleCache */
+    uint64_t style_cache_misses;
+    ClayKit_MeasureStats measure_frame;   /* Text measurement this frame */
+    ClayKit_MeasureStats measure;         /* Text measurement, all time */
+} ClayKit_Stats;
+
 /* ============================================================================
  * Theme System
  * ============================================================================ */
@@ -170,10 +307,40 @@ struct ClayKit_Theme {
     ClayKit_FontSizeScale font_size;
 };
 
+#define CLAYKIT_SIZE_COUNT 5          /* Entries in a per-size table, XS..XL */
+#define CLAYKIT_COLOR_SCHEME_COUNT 5  /* Entries in a per-scheme table */
+
+/* A theme flattened into dense tables indexed by ClayKit_Size or
+ * ClayKit_ColorScheme, so metric lookups are a single load. The context keeps
+ * one and recompiles it when theme_ptr or theme_generation changes. */
+typedef struct ClayKit_CompiledTheme {
+    const ClayKit_Theme *source;     /* Theme the tables were compiled from */
+    uint32_t generation;             /* Context theme_generation at compile time */
+
+    Clay_Color scheme[CLAYKIT_COLOR_SCHEME_COUNT];        /* ClayKit_GetSchemeColor */
+    Clay_Color scheme_hover[CLAYKIT_COLOR_SCHEME_COUNT];  /* Scheme darkened 10% */
+
+    uint16_t spacing[CLAYKIT_SIZE_COUNT];
+    uint16_t font_size[CLAYKIT_SIZE_COUNT];
+    uint16_t radius[CLAYKIT_SIZE_COUNT];          /* ClayKit_GetRadius */
+    uint16_t heading_font_size[CLAYKIT_SIZE_COUNT];
+
+    uint16_t button_pad_x[CLAYKIT_SIZE_COUNT];
+    uint16_t button_pad_y[CLAYKIT_SIZE_COUNT];
+    uint16_t input_pad_x[CLAYKIT_SIZE_COUNT];
+    uint16_t input_pad_y[CLAYKIT_SIZE_COUNT];
+    uint16_t checkbox_size[CLAYKIT_SIZE_COUNT];   /* Also radio size */
+    uint16_t switch_width[CLAYKIT_SIZE_COUNT];
+    uint16_t switch_height[CLAYKIT_SIZE_COUNT];
+    uint16_t switch_knob_size[CLAYKIT_SIZE_COUNT];
+} ClayKit_CompiledTheme;
+
 /* ============================================================================
  * Context
  * ============================================================================ */
 
+typedef struct ClayKit_StyleCacheEntry ClayKit_StyleCacheEntry;
+
 typedef struct ClayKit_Context ClayKit_Context;
 struct ClayKit_Context {
     ClayKit_Theme *theme_ptr;
@@ -186,9 +353,99 @@ struct ClayKit_Context {
     void *icon_user_data;
     ClayKit_MeasureTextCallback measure_text;
     void *measure_text_user_data;
+    ClayKit_FontMetrics *font_metrics; /* See ClayKit_RegisterFontMetrics */
+    ClayKit_MeasureTextBatchCallback measure_text_batch; /* See ClayKit_SetMeasureTextBatch */
+    void *measure_text_batch_user_data;
+    ClayKit_ClockCallback measure_clock; /* Times measure calls, see ClayKit_SetMeasureClock */
     float cursor_blink_time;  /* Accumulator for cursor blinking */
+    uint32_t frame;           /* Frame generation, advanced by ClayKit_BeginFrame */
+    uint32_t state_max_age;   /* If non-zero, BeginFrame evicts states unused for this many frames */
+
+    /* Frame arena: user memory for transient data that must live until the
+     * frame is rendered (icon render data, list numbers). Reset by BeginFrame. */
+    uint8_t *frame_arena;
+    uint32_t frame_arena_cap;
+    uint32_t frame_arena_used;
+
+    ClayKit_StatePool state_pool;   /* See ClayKit_SetStatePool */
+
+    ClayKit_Stats stats;                 /* Pool usage and overflow telemetry */
+    Clay_ErrorHandler clay_error_handler; /* Forwarded to by ClayKit_ClayErrorHandler */
+
+    ClayKit_StyleCacheEntry *style_cache; /* See ClayKit_SetStyleCache */
+    uint32_t style_cache_cap;
+    uint32_t theme_generation;           /* Bumped by ClayKit_ThemeChanged */
+
+    ClayKit_CompiledTheme compiled_theme; /* Lookup tables for theme_ptr, see ClayKit_CompileTheme */
 };
 
+/* ============================================================================
+ * Memory Planning
+ * ============================================================================ */
+
+/* Expected number of each component per frame */
+typedef struct ClayKit_MemoryCounts {
+    uint32_t containers;          /* App-owned Clay elements (boxes, rows, ...) */
+    uint32_t texts;               /* App-owned text elements */
+    uint32_t truncated_texts;     /* ClayKit_TextTruncated calls */
+    uint32_t badges;
+    uint32_t tags;
+    uint32_t stats;
+    uint32_t lists;
+    uint32_t list_items;
+    uint32_t ordered_list_items;  /* Subset of list_items in ordered lists */
+    uint32_t tables;
+    uint32_t table_rows;          /* Including header rows */
+    uint32_t table_cells;         /* Including header cells */
+    uint32_t buttons;
+    uint32_t icons;               /* Button and alert icons */
+    uint32_t checkboxes;
+    uint32_t radios;
+    uint32_t switches;
+    uint32_t sliders;
+    uint32_t progress_bars;
+    uint32_t spinners;
+    uint32_t alerts;
+    uint32_t tooltips;
+    uint32_t tabs;
+    uint32_t links;
+    uint32_t breadcrumbs;
+    uint32_t breadcrumb_items;    /* Each with its separator */
+    uint32_t accordions;
+    uint32_t accordion_items;
+    uint32_t menus;
+    uint32_t menu_items;          /* Including separators */
+    uint32_t selects;
+    uint32_t select_options;
+    uint32_t text_inputs;
+    uint32_t text_areas;
+    uint32_t text_area_rows;      /* Visible rows across all text areas */
+    uint32_t drawers;
+    uint32_t popovers;
+    uint32_t words_per_text;      /* Average words per text element (0 = 3) */
+    uint32_t stateful_elements;   /* Ids used with GetOrCreateState or state blobs */
+    uint32_t state_blobs;         /* State blobs alive at once */
+    uint32_t state_blob_size;     /* Largest state blob in bytes */
+    uint32_t style_cache_entries; /* Entries for ClayKit_SetStyleCache, 0 = no cache */
+} ClayKit_MemoryCounts;
+
+/* Budgets derived from ClayKit_MemoryCounts */
+typedef struct ClayKit_MemoryRequirements {
+    uint32_t elements;            /* Clay layout elements per frame, text included */
+    uint32_t element_configs;     /* Clay element configs per frame */
+    uint32_t text_elements;       /* Clay text elements per frame */
+    uint32_t clay_max_elements;   /* For Clay_SetMaxElementCount */
+    uint32_t clay_measure_words;  /* For Clay_SetMaxMeasureTextCacheWordCount */
+    uint32_t clay_bytes;          /* Clay_MinMemorySize() with the two settings above,
+                                   * 0 unless built with CLAY_IMPLEMENTATION */
+    uint32_t state_slots;         /* ClayKit_State buffer length */
+    uint32_t state_bytes;
+    uint32_t state_pool_bytes;    /* For ClayKit_SetStatePool */
+    uint32_t frame_arena_bytes;   /* For ClayKit_SetFrameArena */
+    uint32_t style_cache_bytes;   /* For ClayKit_SetStyleCache */
+    uint32_t total_bytes;         /* Sum of all the byte budgets above */
+} ClayKit_MemoryRequirements;
+
 /* ============================================================================
  * Size Variants
  * ============================================================================ */
@@ -221,9 +478,66 @@ typedef enum ClayKit_InputFlags {
     CLAYKIT_INPUT_FOCUSED  = 1 << 0,
     CLAYKIT_INPUT_PASSWORD = 1 << 1,
     CLAYKIT_INPUT_READONLY = 1 << 2,
-    CLAYKIT_INPUT_DISABLED = 1 << 3
+    CLAYKIT_INPUT_DISABLED = 1 << 3,
+    CLAYKIT_INPUT_GAP_BUFFER = 1 << 4, /* Set by ClayKit_InputSetGapBuffer */
+    CLAYKIT_INPUT_DRAGGING = 1 << 5    /* Pointer pressed in the input and still down */
 } ClayKit_InputFlags;
 
+/* Undo history for a text input, kept in user-provided memory. Edits are
+ * stored as deltas (position, removed bytes, inserted bytes) in a byte ring;
+ * when it fills up the oldest entries are dropped. Set up with
+ * ClayKit_InputSetHistory. */
+typedef struct ClayKit_InputHistory {
+    uint8_t *buf;
+    uint32_t cap;
+    uint32_t start;     /* Ring offset of the oldest entry */
+    uint32_t undo_len;  /* Bytes of entries that can be undone */
+    uint32_t redo_len;  /* Bytes of undone entries after them */
+    bool open;          /* Typing may extend the newest entry */
+} ClayKit_InputHistory;
+
+/* Cached prefix widths for hit-testing a text input, in user-provided
+ * memory. x[i] is the width of the first i bytes of text; edits invalidate
+ * the entries after the edit point. Set up with ClayKit_InputSetAdvanceCache. */
+typedef struct ClayKit_InputAdvanceCache {
+    float *x;
+    uint32_t cap;       /* Entries in x; caches text of up to cap - 1 bytes */
+    uint32_t valid;     /* Leading entries of x that are up to date */
+    uint16_t font_id;
+    uint16_t font_size;
+} ClayKit_InputAdvanceCache;
+
+/* Line starts of a multi-line text, in user-provided memory, kept up to date
+ * by every edit. Like the text in gap-buffer mode the array has a gap, at the
+ * line of the last edit: entries before it are offsets from the start of the
+ * text and the last count - gap entries are distances from its end, so an
+ * edit only touches the lines it adds or removes. Set up with
+ * ClayKit_InputSetLineIndex. */
+typedef struct ClayKit_InputLineIndex {
+    uint32_t *starts;
+    uint32_t cap;       /* Entries in starts; the most lines the text can have */
+    uint32_t count;     /* Lines in the text, at least 1 */
+    uint32_t gap;       /* Entries before the gap hold offsets */
+    uint32_t page;      /* Lines moved by PageUp/PageDown, set by ClayKit_TextArea */
+} ClayKit_InputLineIndex;
+
+/* Where the text changed since the delta was last taken: bytes
+ * [start, start + removed) of the old text became [start, start + inserted)
+ * of the new. Several edits merge into one range covering all of them, so
+ * a filter or highlighter can update just that range once per keystroke or
+ * per frame. Attach with ClayKit_InputSetDelta. */
+typedef struct ClayKit_InputDelta {
+    uint32_t start;
+    uint32_t removed;   /* Bytes replaced, counted in the old text */
+    uint32_t inserted;  /* Bytes in their place, counted in the new text */
+    uint32_t edits;     /* Edits merged in, 0 if the text is unchanged */
+} ClayKit_InputDelta;
+
+/* Text lives in buf, which holds at most cap - 1 bytes. Normally the text is
+ * contiguous in buf[0..len). In gap-buffer mode the free space sits at logical
+ * offset gap instead: the text is buf[0..gap) followed by the last len - gap
+ * bytes of buf, so edits at the gap only touch the bytes they change. Read it
+ * through ClayKit_InputText in that mode. */
 typedef struct ClayKit_InputState {
     char *buf;
     uint32_t cap;
@@ -231,6 +545,11 @@ typedef struct ClayKit_InputState {
     uint32_t cursor;
     uint32_t select_start;  /* == cursor when no selection */
     uint8_t flags;
+    uint32_t gap;           /* Gap-buffer mode: logical offset of the gap */
+    ClayKit_InputHistory *history;  /* Optional undo history, NULL for none */
+    ClayKit_InputAdvanceCache *advances;  /* Optional hit-test cache, NULL for none */
+    ClayKit_InputLineIndex *lines;  /* Optional line index, makes the input multi-line */
+    ClayKit_InputDelta *delta;      /* Optional edit delta, NULL for none */
 } ClayKit_InputState;
 
 /* Common keys (user maps platform keys to these) */
@@ -243,7 +562,13 @@ typedef enum ClayKit_Key {
     CLAYKIT_KEY_HOME = 5,
     CLAYKIT_KEY_END = 6,
     CLAYKIT_KEY_ENTER = 7,
-    CLAYKIT_KEY_TAB = 8
+    CLAYKIT_KEY_TAB = 8,
+    CLAYKIT_KEY_Z = 9,          /* Ctrl+Z undo, Ctrl+Shift+Z redo */
+    CLAYKIT_KEY_Y = 10,         /* Ctrl+Y redo */
+    CLAYKIT_KEY_UP = 11,        /* Multi-line inputs only */
+    CLAYKIT_KEY_DOWN = 12,
+    CLAYKIT_KEY_PAGE_UP = 13,
+    CLAYKIT_KEY_PAGE_DOWN = 14
 } ClayKit_Key;
 
 typedef enum ClayKit_Modifier {
@@ -705,6 +1030,79 @@ void ClayKit_Init(ClayKit_Context *ctx, ClayKit_Theme *theme,
                   ClayKit_State *state_buf, uint32_t state_cap);
 ClayKit_State* ClayKit_GetState(ClayKit_Context *ctx, uint32_t id);
 ClayKit_State* ClayKit_GetOrCreateState(ClayKit_Context *ctx, uint32_t id);
+uint32_t ClayKit_EvictStaleStates(ClayKit_Context *ctx, uint32_t max_age);
+
+/* Font metrics - text in a registered (font_id, font_size) is measured
+ * from its advance table; measure_text is only called for other fonts.
+ * Registering the same font and size again replaces the earlier table. */
+void ClayKit_RegisterFontMetrics(ClayKit_Context *ctx, ClayKit_FontMetrics *metrics);
+
+/* Text measurement shared with Clay - sets ctx->measure_text and installs
+ * ClayKit_ClayMeasureText as the current Clay context's measure function,
+ * so Clay and ClayKit measure through the same callback and font metrics.
+ * Call after Clay_Initialize (before it, only ClayKit is set up). The
+ * callback gets Clay's text in place, so it must use length rather than
+ * expect a NUL terminator. */
+void ClayKit_SetMeasureText(ClayKit_Context *ctx, ClayKit_MeasureTextCallback callback, void *user_data);
+Clay_Dimensions ClayKit_ClayMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *user_data);
+
+/* Batched measurement - optional. Hit-testing and advance cache fills then
+ * measure up to CLAYKIT_MEASURE_BATCH independent texts per call instead of
+ * one. It also stands in for measure_text when that is not set. Requests in
+ * a registered font are still measured from its metrics. */
+void ClayKit_SetMeasureTextBatch(ClayKit_Context *ctx, ClayKit_MeasureTextBatchCallback callback, void *user_data);
+void ClayKit_MeasureTextBatch(ClayKit_Context *ctx, const ClayKit_MeasureRequest *requests,
+                              ClayKit_TextDimensions *out, uint32_t count);
+
+/* State Pool */
+void ClayKit_SetStatePool(ClayKit_Context *ctx, void *mem, uint32_t size);
+void* ClayKit_GetStateBlob(ClayKit_Context *ctx, uint32_t id, uint32_t size);
+void* ClayKit_FindStateBlob(ClayKit_Context *ctx, uint32_t id);
+#define CLAYKIT_STATE_BLOB(ctx, id, type) ((type *)ClayKit_GetStateBlob((ctx), (id), (uint32_t)sizeof(type)))
+
+/* Frame Arena */
+void ClayKit_SetFrameArena(ClayKit_Context *ctx, void *mem, uint32_t cap);
+void* ClayKit_FrameAlloc(ClayKit_Context *ctx, uint32_t size, uint32_t align);
+
+/* Stats */
+Clay_ErrorHandler ClayKit_ClayErrorHandler(ClayKit_Context *ctx, Clay_ErrorHandler user_handler);
+void ClayKit_EndFrame(ClayKit_Context *ctx);
+void ClayKit_ResetStats(ClayKit_Context *ctx);
+
+/* Times every measure callback call into stats.measure*.seconds. Costs two
+ * clock reads per call; pass NULL to stop timing. */
+void ClayKit_SetMeasureClock(ClayKit_Context *ctx, ClayKit_ClockCallback clock);
+
+/* Clay_SetMaxMeasureTextCacheWordCount value for the busiest frame seen: the
+ * all-time peak of stats.clay_measure_words plus half again, in multiples of
+ * 32. If the cache overflowed the peak undercounts, so it is twice the
+ * capacity instead. 0 until ClayKit_EndFrame has sampled a frame. */
+uint32_t ClayKit_RecommendClayMeasureWords(const ClayKit_Context *ctx);
+
+/* Re-creates the current Clay context with room for words measured words,
+ * keeping its layout size, error handler and element limit. With memory
+ * NULL, returns the bytes that needs. Otherwise re-creates it only if memory
+ * holds at least that many and returns the bytes used, or 0 if it did
+ * nothing; only after a non-zero return can the old arena be freed. Clay's layout state and measure
+ * cache start over, ClayKit's state is kept. Call between frames. Like
+ * ClayKit_EndFrame, it needs Clay's internals, so it only re-creates the
+ * context where the implementation shares a file with CLAY_IMPLEMENTATION. */
+uint32_t ClayKit_ResizeClayMeasureCache(ClayKit_Context *ctx, uint32_t words, void *memory, uint32_t size);
+
+/* Snapshot - little-endian binary image of the state table, state blobs,
+ * focus ids and the given text inputs. Save returns the snapshot size and
+ * writes it only when out_cap is large enough (pass NULL to query the size),
+ * or 0 if an input is NULL. Load restores all of it or, if the data is
+ * invalid (including repeated state ids) or does not fit the context and
+ * inputs, nothing. */
+#define CLAYKIT_SNAPSHOT_VERSION 1
+uint32_t ClayKit_SaveSnapshot(ClayKit_Context *ctx, ClayKit_InputState **inputs, uint32_t input_count,
+                              void *out, uint32_t out_cap);
+bool ClayKit_LoadSnapshot(ClayKit_Context *ctx, ClayKit_InputState **inputs, uint32_t input_count,
+                          const void *data, uint32_t size);
+
+/* Memory Planning */
+ClayKit_MemoryRequirements ClayKit_ComputeMemoryRequirements(const ClayKit_MemoryCounts *counts);
 
 /* Focus Management */
 void ClayKit_SetFocus(ClayKit_Context *ctx, Clay_ElementId id);
@@ -718,17 +1116,59 @@ void ClayKit_BeginFrame(ClayKit_Context *ctx);
 /* Text Input */
 bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods);
 bool ClayKit_InputHandleChar(ClayKit_InputState *s, uint32_t codepoint);
+void ClayKit_InputSetGapBuffer(ClayKit_InputState *s, bool enabled);
+const char* ClayKit_InputText(ClayKit_InputState *s);
+uint32_t ClayKit_InputInsertText(ClayKit_InputState *s, const char *text, uint32_t len);
+uint32_t ClayKit_InputReplaceRange(ClayKit_InputState *s, uint32_t start, uint32_t end, const char *text, uint32_t len);
+/* Selects the word, punctuation or whitespace run at offset. Words are ASCII
+ * letters, digits, '_' and any non-ASCII codepoint; an offset just after a
+ * word (e.g. the end of the text) selects that word. */
+void ClayKit_InputSelectWord(ClayKit_InputState *s, uint32_t offset);
+void ClayKit_InputSetHistory(ClayKit_InputState *s, ClayKit_InputHistory *history, void *mem, uint32_t size);
+void ClayKit_InputClearHistory(ClayKit_InputState *s);
+bool ClayKit_InputUndo(ClayKit_InputState *s);
+bool ClayKit_InputRedo(ClayKit_InputState *s);
+void ClayKit_InputSetAdvanceCache(ClayKit_InputState *s, ClayKit_InputAdvanceCache *cache, float *mem, uint32_t count);
+
+/* Edit delta - attaching one (NULL detaches) makes every edit, from the key
+ * and char handlers, bulk inserts, undo/redo or a snapshot load, report the
+ * range it changed. Take returns the merged delta and starts a new one. */
+void ClayKit_InputSetDelta(ClayKit_InputState *s, ClayKit_InputDelta *delta);
+ClayKit_InputDelta ClayKit_InputTakeDelta(ClayKit_InputState *s);
+
+/* Line index - attaching one makes the input multi-line: Enter inserts a
+ * newline and Up/Down/PageUp/PageDown move between lines. Returns false,
+ * and attaches nothing, if the text has more than count lines. Without an
+ * index the text is a single line. */
+bool ClayKit_InputSetLineIndex(ClayKit_InputState *s, ClayKit_InputLineIndex *index, uint32_t *mem, uint32_t count);
+uint32_t ClayKit_InputLineCount(const ClayKit_InputState *s);
+uint32_t ClayKit_InputLineAt(const ClayKit_InputState *s, uint32_t offset);
+uint32_t ClayKit_InputLineStart(const ClayKit_InputState *s, uint32_t line);
+uint32_t ClayKit_InputLineEnd(const ClayKit_InputState *s, uint32_t line);
 
 /* Theme Helpers */
 Clay_Color ClayKit_GetSchemeColor(ClayKit_Theme *theme, ClayKit_ColorScheme scheme);
 uint16_t ClayKit_GetSpacing(ClayKit_Theme *theme, ClayKit_Size size);
 uint16_t ClayKit_GetFontSize(ClayKit_Theme *theme, ClayKit_Size size);
 uint16_t ClayKit_GetRadius(ClayKit_Theme *theme, ClayKit_Size size);
+void ClayKit_CompileTheme(ClayKit_Theme *theme, ClayKit_CompiledTheme *out);
 
 /* Typography - these return Clay_TextElementConfig for use with CLAY_TEXT */
 Clay_TextElementConfig ClayKit_TextStyle(ClayKit_Context *ctx, ClayKit_TextConfig cfg);
 Clay_TextElementConfig ClayKit_HeadingStyle(ClayKit_Context *ctx, ClayKit_HeadingConfig cfg);
 
+/* Truncation - TruncateText returns how many bytes of text fit in max_width
+ * with CLAYKIT_ELLIPSIS after them (trailing spaces dropped), or length if
+ * the whole text fits. Only about as much of the text as fits is measured.
+ * TextTruncated emits text in a growing element with the given id, cut to
+ * the width that element had in the previous frame, and returns true if it
+ * was cut. The element needs a parent with a width to give it (fixed, grow
+ * or percent). The shortened copy is built in the frame arena. */
+uint32_t ClayKit_TruncateText(ClayKit_Context *ctx, const char *text, uint32_t length,
+                              Clay_TextElementConfig config, float max_width);
+bool ClayKit_TextTruncated(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                           const char *text, int32_t text_len, Clay_TextElementConfig config);
+
 /* Compute badge style - returns styling info for custom renderers */
 ClayKit_BadgeStyle ClayKit_ComputeBadgeStyle(ClayKit_Context *ctx, ClayKit_BadgeConfig cfg);
 
@@ -1179,6 +1619,7 @@ typedef struct ClayKit_InputConfig {
     Clay_Color cursor_color;     /* Cursor color (default: theme fg) */
     Clay_Color selection_color;  /* Selection background (default: primary with alpha) */
     uint16_t width;              /* Fixed width (0 = grow to fill) */
+    uint16_t rows;               /* Visible lines of a text area (0 = 8) */
 } ClayKit_InputConfig;
 
 /* Input computed style */
@@ -1215,6 +1656,8 @@ Clay_Color ClayKit_InputBorderColor(ClayKit_Context *ctx, ClayKit_InputConfig cf
 ClayKit_InputStyle ClayKit_ComputeInputStyle(ClayKit_Context *ctx, ClayKit_InputConfig cfg, bool focused);
 float ClayKit_MeasureTextWidth(ClayKit_Context *ctx, const char *text, uint32_t length, uint16_t font_id, uint16_t font_size);
 uint32_t ClayKit_InputGetCursorFromX(ClayKit_Context *ctx, const char *text, uint32_t length, uint16_t font_id, uint16_t font_size, float x_offset);
+uint32_t ClayKit_InputHitTest(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size, float x_offset);
+float ClayKit_InputOffsetX(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size, uint32_t offset);
 
 /* Checkbox helper functions */
 uint16_t ClayKit_CheckboxSize(ClayKit_Context *ctx, ClayKit_Size size);
@@ -1327,11 +1770,117 @@ void ClayKit_SelectDropdownEnd(void);
 
 /* Text input rendering - renders input box with text, cursor, and optional placeholder
  * id/id_len: element ID for later lookup via Clay_GetElementData
+ * Text wider than the box scrolls horizontally to keep the cursor visible,
+ * and only the visible slice is laid out. Scrolling needs an id.
  * Returns true if hovered (for click detection to set focus) */
 bool ClayKit_TextInput(ClayKit_Context *ctx, const char *id, int32_t id_len,
                        ClayKit_InputState *state, ClayKit_InputConfig cfg,
                        const char *placeholder, int32_t placeholder_len);
 
+/* Horizontal scroll of a text input: the text x shown at the left padding
+ * edge. Add it to a click's local x before ClayKit_InputHitTest. */
+float ClayKit_TextInputScroll(ClayKit_Context *ctx, const char *id, int32_t id_len);
+
+/* Pointer handling for a text input rendered last frame; call once per frame
+ * before the layout. A press inside focuses the input and places the cursor
+ * (Shift extends the selection), a press outside unfocuses it, and moving
+ * while still down drags the selection. A second press on the cursor within
+ * CLAYKIT_DOUBLE_CLICK_TIME (timed with cursor_blink_time, which presses
+ * reset) selects the word there. Dragging hit-tests through the advance
+ * cache when one is attached.
+ * Returns true if the cursor, selection or focus changed */
+bool ClayKit_TextInputPointer(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                              ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                              float x, float y, bool pressed, bool down, uint32_t mods);
+
+/* Multi-line text area - renders cfg.rows lines of an input with a line
+ * index, scrolled to keep the cursor in view. Only the visible lines are
+ * laid out, inside a clipped container.
+ * Returns true if hovered */
+bool ClayKit_TextArea(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                      ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                      const char *placeholder, int32_t placeholder_len);
+
+/* Text offset under pointer position (x, y) in a text area rendered last
+ * frame, or the cursor if the area isn't found. Points above or below the
+ * area map to the lines scrolled out of view there. */
+uint32_t ClayKit_TextAreaHitTest(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                                 ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                                 float x, float y);
+
+/* ClayKit_TextInputPointer for a text area. Dragging past the top or bottom
+ * edge scrolls. */
+bool ClayKit_TextAreaPointer(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                             ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                             float x, float y, bool pressed, bool down, uint32_t mods);
+
+/* ============================================================================
+ * Style Cache
+ * ============================================================================ */
+
+/* Memoizes ClayKit_Compute*Style results keyed by (component, config bytes,
+ * theme). Entries are user memory; a direct-mapped table, so a colliding
+ * key just replaces the entry. */
+typedef union ClayKit_StyleCacheConfig {
+    ClayKit_BadgeConfig badge;
+    ClayKit_TagConfig tag;
+    ClayKit_StatConfig stat;
+    ClayKit_ListConfig list;
+    ClayKit_TableConfig table;
+    ClayKit_InputConfig input;
+    ClayKit_ProgressConfig progress;
+    ClayKit_SliderConfig slider;
+    ClayKit_AlertConfig alert;
+    ClayKit_TooltipConfig tooltip;
+    ClayKit_TabsConfig tabs;
+    ClayKit_ModalConfig modal;
+    ClayKit_SpinnerConfig spinner;
+    ClayKit_DrawerConfig drawer;
+    ClayKit_PopoverConfig popover;
+    ClayKit_LinkConfig link;
+    ClayKit_BreadcrumbConfig breadcrumb;
+    ClayKit_AccordionConfig accordion;
+    ClayKit_MenuConfig menu;
+    ClayKit_SelectConfig select;
+} ClayKit_StyleCacheConfig;
+
+typedef union ClayKit_StyleCacheStyle {
+    ClayKit_BadgeStyle badge;
+    ClayKit_TagStyle tag;
+    ClayKit_StatStyle stat;
+    ClayKit_ListStyle list;
+    ClayKit_TableStyle table;
+    ClayKit_InputStyle input;
+    ClayKit_ProgressStyle progress;
+    ClayKit_SliderStyle slider;
+    ClayKit_AlertStyle alert;
+    ClayKit_TooltipStyle tooltip;
+    ClayKit_TabsStyle tabs;
+    ClayKit_ModalStyle modal;
+    ClayKit_SpinnerStyle spinner;
+    ClayKit_DrawerStyle drawer;
+    ClayKit_PopoverStyle popover;
+    ClayKit_LinkStyle link;
+    ClayKit_BreadcrumbStyle breadcrumb;
+    ClayKit_AccordionStyle accordion;
+    ClayKit_MenuStyle menu;
+    ClayKit_SelectStyle select;
+} ClayKit_StyleCacheStyle;
+
+struct ClayKit_StyleCacheEntry {
+    uint32_t hash;
+    uint16_t kind;                 /* Component, 0 = empty */
+    uint16_t variant;              /* Focused / hovered flag for styles that take one */
+    uint32_t theme_generation;
+    const ClayKit_Theme *theme;
+    ClayKit_StyleCacheConfig cfg;
+    ClayKit_StyleCacheStyle style;
+};
+
+void ClayKit_SetStyleCache(ClayKit_Context *ctx, ClayKit_StyleCacheEntry *entries, uint32_t count);
+/* Call after modifying the theme in place (swapping theme_ptr is detected) */
+void ClayKit_ThemeChanged(ClayKit_Context *ctx);
+
 /* ============================================================================
  * Theme Presets (defined in implementation)
  * ============================================================================ */
@@ -1345,8 +1894,28 @@ extern const ClayKit_Theme CLAYKIT_THEME_DARK;
 
 #ifdef CLAYKIT_IMPLEMENTATION
 
+#include <string.h>
+
+/* Text scanning uses SSE2 on x86, NEON on ARM and plain loops elsewhere.
+ * Define CLAYKIT_NO_SIMD to force the scalar path. */
+#if !defined(CLAYKIT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CLAYKIT_SIMD_SSE2
+#include <emmintrin.h>
+#elif !defined(CLAYKIT_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define CLAYKIT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 /* Forward declarations for internal helpers */
-static void claykit_emit_icon(ClayKit_Icon icon, Clay_Color color);
+static void claykit_emit_icon(ClayKit_Context *ctx, ClayKit_Icon icon, Clay_Color color);
+static void claykit_pool_free(ClayKit_StatePool *pool, uint32_t handle);
+static void claykit_stat_use(ClayKit_PoolStats *p, uint32_t used);
+static void claykit_stat_overflow(ClayKit_PoolStats *p);
+static Clay_Color claykit_color_darken(Clay_Color c, float amount);
+static void claykit_input_copy_text(const ClayKit_InputState *s, void *dst);
+static uint32_t claykit_count_newlines(const char *text, uint32_t n);
+static bool claykit_lines_rebuild(ClayKit_InputState *s);
+static void claykit_input_delta_add(ClayKit_InputState *s, uint32_t pos, uint32_t count, uint32_t n);
 
 /* ----------------------------------------------------------------------------
  * Theme Presets
@@ -1420,43 +1989,916 @@ void ClayKit_Init(ClayKit_Context *ctx, ClayKit_Theme *theme,
     ctx->prev_focused_id = 0;
     ctx->icon_callback = NULL;
     ctx->icon_user_data = NULL;
+    ctx->measure_text = NULL;
+    ctx->measure_text_user_data = NULL;
+    ctx->font_metrics = NULL;
+    ctx->measure_text_batch = NULL;
+    ctx->measure_text_batch_user_data = NULL;
+    ctx->measure_clock = NULL;
+    ctx->cursor_blink_time = 0.0f;
+    ctx->frame = 0;
+    ctx->state_max_age = 0;
+    ctx->frame_arena = NULL;
+    ctx->frame_arena_cap = 0;
+    ctx->frame_arena_used = 0;
+    memset(&ctx->state_pool, 0, sizeof(ctx->state_pool));
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->stats.state_slots.capacity = state_cap;
+    ctx->clay_error_handler.errorHandlerFunction = NULL;
+    ctx->clay_error_handler.userData = NULL;
+    ctx->style_cache = NULL;
+    ctx->style_cache_cap = 0;
+    ctx->theme_generation = 0;
+    ClayKit_CompileTheme(theme, &ctx->compiled_theme);
 
     /* Zero out state buffer */
     for (uint32_t i = 0; i < state_cap; i++) {
         state_buf[i].id = 0;
         state_buf[i].flags = 0;
         state_buf[i].value = 0.0f;
+        state_buf[i].frame = 0;
+        state_buf[i].blob = 0;
     }
 }
 
-ClayKit_State* ClayKit_GetState(ClayKit_Context *ctx, uint32_t id) {
-    for (uint32_t i = 0; i < ctx->state_count; i++) {
-        if (ctx->state_ptr[i].id == id) {
-            return &ctx->state_ptr[i];
+/* The state buffer is an open-addressing hash table keyed by element id.
+ * Clay ids are hash+1 and never 0, so id 0 marks an empty slot. The home
+ * slot maps a multiplicative hash onto [0, state_cap) without a division,
+ * and collisions probe linearly (wrapping) until the id or an empty slot. */
+static uint32_t claykit_state_home(uint32_t id, uint32_t cap) {
+    return (uint32_t)(((uint64_t)(id * 0x9E3779B1u) * cap) >> 32);
+}
+
+/* Returns the slot holding id, or the empty slot where it would be inserted.
+ * Returns NULL only if the id is absent and the table is full. */
+static ClayKit_State* claykit_state_probe(ClayKit_Context *ctx, uint32_t id) {
+    uint32_t cap = ctx->state_cap;
+    if (cap == 0) return NULL;
+    uint32_t i = claykit_state_home(id, cap);
+    for (uint32_t n = 0; n < cap; n++) {
+        ClayKit_State *s = &ctx->state_ptr[i];
+        if (s->id == id || s->id == 0) {
+            return s;
         }
+        if (++i == cap) i = 0;
     }
     return NULL;
 }
 
+ClayKit_State* ClayKit_GetState(ClayKit_Context *ctx, uint32_t id) {
+    if (id == 0) return NULL;
+    ClayKit_State *s = claykit_state_probe(ctx, id);
+    if (!s || s->id != id) return NULL;
+    s->frame = ctx->frame;
+    return s;
+}
+
 ClayKit_State* ClayKit_GetOrCreateState(ClayKit_Context *ctx, uint32_t id) {
-    /* First, try to find existing */
-    ClayKit_State *existing = ClayKit_GetState(ctx, id);
-    if (existing) {
-        return existing;
+    if (id == 0) return NULL;
+    ClayKit_State *s = claykit_state_probe(ctx, id);
+
+    /* Out of state slots */
+    if (!s) {
+        claykit_stat_overflow(&ctx->stats.state_slots);
+        return NULL;
     }
 
-    /* Create new if we have capacity */
-    if (ctx->state_count < ctx->state_cap) {
-        ClayKit_State *s = &ctx->state_ptr[ctx->state_count];
+    if (s->id == 0) {
         s->id = id;
         s->flags = 0;
         s->value = 0.0f;
+        s->blob = 0;
         ctx->state_count++;
-        return s;
+        claykit_stat_use(&ctx->stats.state_slots, ctx->state_count);
     }
+    s->frame = ctx->frame;
+    return s;
+}
 
-    /* Out of state slots */
-    return NULL;
+/* Empties slot i, shifting later members of its probe chain back so that
+ * lookups never stop early at the hole. */
+static void claykit_state_remove_at(ClayKit_Context *ctx, uint32_t i) {
+    uint32_t cap = ctx->state_cap;
+    ClayKit_State *buf = ctx->state_ptr;
+    uint32_t j = i;
+    if (buf[i].blob) {
+        claykit_pool_free(&ctx->state_pool, buf[i].blob);
+    }
+    for (uint32_t n = 1; n < cap; n++) {
+        if (++j == cap) j = 0;
+        if (buf[j].id == 0) break;
+        uint32_t home = claykit_state_home(buf[j].id, cap);
+        /* Entry at j stays put if its home lies cyclically in (i, j] */
+        bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            buf[i] = buf[j];
+            i = j;
+        }
+    }
+    buf[i].id = 0;
+    buf[i].flags = 0;
+    buf[i].value = 0.0f;
+    buf[i].frame = 0;
+    buf[i].blob = 0;
+    ctx->state_count--;
+    ctx->stats.state_slots.used = ctx->state_count;
+}
+
+uint32_t ClayKit_EvictStaleStates(ClayKit_Context *ctx, uint32_t max_age) {
+    uint32_t evicted = 0;
+    uint32_t i = 0;
+    while (i < ctx->state_cap && ctx->state_count > 0) {
+        ClayKit_State *s = &ctx->state_ptr[i];
+        if (s->id != 0 && ctx->frame - s->frame > max_age) {
+            /* Removal may shift another entry into slot i, so re-check it */
+            claykit_state_remove_at(ctx, i);
+            evicted++;
+        } else {
+            i++;
+        }
+    }
+    return evicted;
+}
+
+/* ----------------------------------------------------------------------------
+ * State Pool
+ * ---------------------------------------------------------------------------- */
+
+static uint32_t claykit_pool_class(uint32_t size) {
+    uint32_t c = 0;
+    uint32_t blob = CLAYKIT_POOL_MIN_BLOB;
+    while (blob < size) { blob <<= 1; c++; }
+    return c;
+}
+
+static uint32_t claykit_pool_class_size(uint32_t c) {
+    return (uint32_t)CLAYKIT_POOL_MIN_BLOB << c;
+}
+
+/* Class byte of a page on the empty-page list */
+#define CLAYKIT_POOL_PAGE_EMPTY 0xFF
+
+/* Pages holding a size class */
+static uint32_t claykit_pool_pages_in_use(const ClayKit_StatePool *pool) {
+    return pool->pages_used - pool->free_page_count;
+}
+
+/* Free blobs store the next free handle in their first four bytes */
+static void claykit_pool_free(ClayKit_StatePool *pool, uint32_t handle) {
+    uint32_t offset = handle - 1;
+    uint32_t page = offset / CLAYKIT_POOL_PAGE_SIZE;
+    uint32_t c = pool->page_class[page];
+    memcpy(pool->pages + offset, &pool->free_head[c], sizeof(uint32_t));
+    pool->free_head[c] = handle;
+    pool->page_live[page]--;
+    pool->blob_count--;
+}
+
+/* Moves pages with no live blobs to the empty-page list so any class can
+ * reuse them. Their blobs are unlinked from their class's free list first. */
+static void claykit_pool_reclaim(ClayKit_StatePool *pool) {
+    for (uint32_t c = 0; c < CLAYKIT_POOL_CLASS_COUNT; c++) {
+        uint8_t *link = (uint8_t *)&pool->free_head[c];
+        uint32_t handle = pool->free_head[c];
+        while (handle) {
+            uint8_t *blob = pool->pages + handle - 1;
+            uint32_t next;
+            memcpy(&next, blob, sizeof(uint32_t));
+            if (pool->page_live[(handle - 1) / CLAYKIT_POOL_PAGE_SIZE] == 0) {
+                memcpy(link, &next, sizeof(uint32_t));
+            } else {
+                link = blob;
+            }
+            handle = next;
+        }
+    }
+    for (uint32_t page = 0; page < pool->pages_used; page++) {
+        if (pool->page_live[page] == 0 && pool->page_class[page] != CLAYKIT_POOL_PAGE_EMPTY) {
+            pool->page_class[page] = CLAYKIT_POOL_PAGE_EMPTY;
+            memcpy(pool->pages + page * CLAYKIT_POOL_PAGE_SIZE, &pool->free_pages, sizeof(uint32_t));
+            pool->free_pages = page + 1;
+            pool->free_page_count++;
+        }
+    }
+}
+
+/* Returns a handle (offset + 1) to a zeroed blob of class c, or 0 */
+static uint32_t claykit_pool_alloc(ClayKit_StatePool *pool, uint32_t c) {
+    uint32_t blob_size = claykit_pool_class_size(c);
+    if (pool->free_head[c] == 0) {
+        /* Empty pages stay with their class until the pool runs out */
+        if (pool->free_pages == 0 && pool->pages_used >= pool->page_count) {
+            claykit_pool_reclaim(pool);
+        }
+
+        uint32_t page;
+        if (pool->free_pages) {
+            page = pool->free_pages - 1;
+            memcpy(&pool->free_pages, pool->pages + page * CLAYKIT_POOL_PAGE_SIZE, sizeof(uint32_t));
+            pool->free_page_count--;
+        } else if (pool->pages_used < pool->page_count) {
+            page = pool->pages_used++;
+        } else {
+            return 0;
+        }
+
+        /* Carve the page into blobs, linked in address order */
+        uint32_t base = page * CLAYKIT_POOL_PAGE_SIZE;
+        uint32_t n = CLAYKIT_POOL_PAGE_SIZE / blob_size;
+        pool->page_class[page] = (uint8_t)c;
+        pool->page_live[page] = 0;
+        for (uint32_t k = n; k > 0; k--) {
+            uint32_t offset = base + (k - 1) * blob_size;
+            memcpy(pool->pages + offset, &pool->free_head[c], sizeof(uint32_t));
+            pool->free_head[c] = offset + 1;
+        }
+    }
+
+    uint32_t handle = pool->free_head[c];
+    memcpy(&pool->free_head[c], pool->pages + handle - 1, sizeof(uint32_t));
+    memset(pool->pages + handle - 1, 0, blob_size);
+    pool->page_live[(handle - 1) / CLAYKIT_POOL_PAGE_SIZE]++;
+    pool->blob_count++;
+    return handle;
+}
+
+void ClayKit_SetStatePool(ClayKit_Context *ctx, void *mem, uint32_t size) {
+    ClayKit_StatePool *pool = &ctx->state_pool;
+    memset(pool, 0, sizeof(*pool));
+    /* Handles point into the old memory, so every blob is dropped */
+    for (uint32_t i = 0; i < ctx->state_cap; i++) {
+        ctx->state_ptr[i].blob = 0;
+    }
+    memset(&ctx->stats.state_pool_pages, 0, sizeof(ctx->stats.state_pool_pages));
+    if (!mem) return;
+
+    /* Align pages to 16 bytes; the page class and live count bytes go after the pages */
+    uintptr_t addr = (uintptr_t)mem;
+    uint32_t pad = (uint32_t)((16 - (addr & 15)) & 15);
+    if (size <= pad) return;
+    uint32_t usable = size - pad;
+
+    pool->pages = (uint8_t *)mem + pad;
+    pool->page_count = usable / (CLAYKIT_POOL_PAGE_SIZE + 2);
+    pool->page_class = pool->pages + pool->page_count * CLAYKIT_POOL_PAGE_SIZE;
+    pool->page_live = pool->page_class + pool->page_count;
+    ctx->stats.state_pool_pages.capacity = pool->page_count;
+}
+
+void* ClayKit_GetStateBlob(ClayKit_Context *ctx, uint32_t id, uint32_t size) {
+    if (size == 0 || size > CLAYKIT_POOL_MAX_BLOB) return NULL;
+
+    ClayKit_State *s = ClayKit_GetOrCreateState(ctx, id);
+    if (!s) return NULL;
+
+    ClayKit_StatePool *pool = &ctx->state_pool;
+    uint32_t c = claykit_pool_class(size);
+    if (s->blob) {
+        uint32_t old_c = pool->page_class[(s->blob - 1) / CLAYKIT_POOL_PAGE_SIZE];
+        if (old_c >= c) {
+            return pool->pages + s->blob - 1;
+        }
+        /* Grew past its size class: move to a larger blob */
+        uint32_t handle = claykit_pool_alloc(pool, c);
+        claykit_stat_use(&ctx->stats.state_pool_pages, claykit_pool_pages_in_use(pool));
+        if (!handle) {
+            claykit_stat_overflow(&ctx->stats.state_pool_pages);
+            return NULL;
+        }
+        memcpy(pool->pages + handle - 1, pool->pages + s->blob - 1, claykit_pool_class_size(old_c));
+        claykit_pool_free(pool, s->blob);
+        s->blob = handle;
+        return pool->pages + handle - 1;
+    }
+
+    s->blob = claykit_pool_alloc(pool, c);
+    claykit_stat_use(&ctx->stats.state_pool_pages, claykit_pool_pages_in_use(pool));
+    if (!s->blob) {
+        claykit_stat_overflow(&ctx->stats.state_pool_pages);
+        return NULL;
+    }
+    return pool->pages + s->blob - 1;
+}
+
+void* ClayKit_FindStateBlob(ClayKit_Context *ctx, uint32_t id) {
+    ClayKit_State *s = ClayKit_GetState(ctx, id);
+    if (!s || !s->blob) return NULL;
+    return ctx->state_pool.pages + s->blob - 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * Frame Arena
+ * ---------------------------------------------------------------------------- */
+
+void ClayKit_SetFrameArena(ClayKit_Context *ctx, void *mem, uint32_t cap) {
+    ctx->frame_arena = (uint8_t *)mem;
+    ctx->frame_arena_cap = mem ? cap : 0;
+    ctx->frame_arena_used = 0;
+    memset(&ctx->stats.frame_arena, 0, sizeof(ctx->stats.frame_arena));
+    ctx->stats.frame_arena.capacity = ctx->frame_arena_cap;
+}
+
+void* ClayKit_FrameAlloc(ClayKit_Context *ctx, uint32_t size, uint32_t align) {
+    if (align == 0) align = 1;
+    uintptr_t base = (uintptr_t)ctx->frame_arena;
+    uintptr_t start = (base + ctx->frame_arena_used + (align - 1)) & ~(uintptr_t)(align - 1);
+    uint32_t offset = (uint32_t)(start - base);
+
+    if (!ctx->frame_arena || offset > ctx->frame_arena_cap ||
+        size > ctx->frame_arena_cap - offset) {
+        claykit_stat_overflow(&ctx->stats.frame_arena);
+        return NULL;
+    }
+
+    ctx->frame_arena_used = offset + size;
+    claykit_stat_use(&ctx->stats.frame_arena, ctx->frame_arena_used);
+    return ctx->frame_arena + offset;
+}
+
+/* ----------------------------------------------------------------------------
+ * Stats
+ * ---------------------------------------------------------------------------- */
+
+static void claykit_stat_use(ClayKit_PoolStats *p, uint32_t used) {
+    p->used = used;
+    if (used > p->frame_peak) p->frame_peak = used;
+    if (used > p->peak) p->peak = used;
+}
+
+static void claykit_stat_overflow(ClayKit_PoolStats *p) {
+    p->frame_overflows++;
+    p->overflows++;
+}
+
+/* Starts a new frame's window; per-frame pools also drop back to zero use */
+static void claykit_stat_begin_frame(ClayKit_PoolStats *p, bool per_frame) {
+    if (per_frame) p->used = 0;
+    p->frame_peak = p->used;
+    p->frame_overflows = 0;
+}
+
+static void claykit_clay_error(Clay_ErrorData error) {
+    ClayKit_Context *ctx = (ClayKit_Context *)error.userData;
+    if (error.errorType == CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED) {
+        claykit_stat_overflow(&ctx->stats.clay_elements);
+    } else if (error.errorType == CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED) {
+        claykit_stat_overflow(&ctx->stats.clay_measure_words);
+    }
+    if (ctx->clay_error_handler.errorHandlerFunction) {
+        error.userData = ctx->clay_error_handler.userData;
+        ctx->clay_error_handler.errorHandlerFunction(error);
+    }
+}
+
+Clay_ErrorHandler ClayKit_ClayErrorHandler(ClayKit_Context *ctx, Clay_ErrorHandler user_handler) {
+    Clay_ErrorHandler handler;
+    ctx->clay_error_handler = user_handler;
+    handler.errorHandlerFunction = claykit_clay_error;
+    handler.userData = ctx;
+    return handler;
+}
+
+void ClayKit_EndFrame(ClayKit_Context *ctx) {
+    Clay_Context *clay = Clay_GetCurrentContext();
+    if (!clay) return;
+    ctx->stats.clay_elements.capacity = (uint32_t)Clay_GetMaxElementCount();
+    ctx->stats.clay_measure_words.capacity = (uint32_t)Clay_GetMaxMeasureTextCacheWordCount();
+#ifdef CLAY__MAXFLOAT
+    /* Clay's internals are only visible in the file that implements Clay.
+     * clay.h undefines CLAY_IMPLEMENTATION, so test for one of its macros. */
+    claykit_stat_use(&ctx->stats.clay_elements, (uint32_t)clay->layoutElements.length);
+    claykit_stat_use(&ctx->stats.clay_measure_words,
+                     (uint32_t)(clay->measuredWords.length - clay->measuredWordsFreeList.length));
+    /* Running out of layout elements only sets a flag, it never reaches the
+     * error handler */
+    if (clay->booleanWarnings.maxElementsExceeded) {
+        claykit_stat_overflow(&ctx->stats.clay_elements);
+    }
+    /* Each text element looks itself up in the measure cache once */
+    ctx->stats.measure_frame.clay_lookups += (uint64_t)clay->textElementData.length;
+    ctx->stats.measure.clay_lookups += (uint64_t)clay->textElementData.length;
+#endif
+}
+
+void ClayKit_ResetStats(ClayKit_Context *ctx) {
+    ClayKit_PoolStats *all[] = {
+        &ctx->stats.state_slots, &ctx->stats.state_pool_pages, &ctx->stats.frame_arena,
+        &ctx->stats.icons, &ctx->stats.list_numbers,
+        &ctx->stats.clay_elements, &ctx->stats.clay_measure_words
+    };
+    for (uint32_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+        all[i]->frame_peak = all[i]->used;
+        all[i]->peak = all[i]->used;
+        all[i]->frame_overflows = 0;
+        all[i]->overflows = 0;
+    }
+    ctx->stats.style_cache_hits = 0;
+    ctx->stats.style_cache_misses = 0;
+    memset(&ctx->stats.measure_frame, 0, sizeof(ctx->stats.measure_frame));
+    memset(&ctx->stats.measure, 0, sizeof(ctx->stats.measure));
+}
+
+void ClayKit_SetMeasureClock(ClayKit_Context *ctx, ClayKit_ClockCallback clock) {
+    ctx->measure_clock = clock;
+}
+
+uint32_t ClayKit_RecommendClayMeasureWords(const ClayKit_Context *ctx) {
+    const ClayKit_PoolStats *w = &ctx->stats.clay_measure_words;
+    uint32_t words;
+    if (w->overflows > 0 && w->capacity > 0) {
+        words = w->capacity * 2;
+    } else if (w->peak > 0) {
+        words = w->peak + w->peak / 2;
+    } else {
+        return 0;
+    }
+    /* The measure cache hashes into words / 32 buckets */
+    words = (words + 31) / 32 * 32;
+    return words < 32 ? 32 : words;
+}
+
+uint32_t ClayKit_ResizeClayMeasureCache(ClayKit_Context *ctx, uint32_t words, void *memory, uint32_t size) {
+    Clay_Context *clay = Clay_GetCurrentContext();
+    if (clay == NULL || words < 32) return 0;
+
+    /* Clay sizes its arrays from the current context's limits */
+    int32_t old_words = Clay_GetMaxMeasureTextCacheWordCount();
+    Clay_SetMaxMeasureTextCacheWordCount((int32_t)words);
+    uint32_t bytes = Clay_MinMemorySize();
+#ifdef CLAY__MAXFLOAT
+    if (memory != NULL && size >= bytes) {
+        /* Clay keeps the measure function in a global but its user data
+         * (e.g. the ClayKit context for ClayKit_ClayMeasureText) in the
+         * context, so carry it over */
+        void *measure_user_data = clay->measureTextUserData;
+        Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(size, memory);
+        Clay_Context *next = Clay_Initialize(arena, clay->layoutDimensions, clay->errorHandler);
+        next->measureTextUserData = measure_user_data;
+        ctx->stats.clay_measure_words.capacity = words;
+        ctx->stats.clay_measure_words.used = 0;
+        return bytes;
+    }
+#else
+    (void)ctx; (void)size;
+#endif
+    Clay_SetMaxMeasureTextCacheWordCount(old_words);
+    /* A query returns the size; a resize that didn't happen returns 0 so
+     * the caller doesn't free the arena Clay is still using */
+    return memory == NULL ? bytes : 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Style Cache
+ * ---------------------------------------------------------------------------- */
+
+enum {
+    CLAYKIT_STYLE_BADGE = 1,
+    CLAYKIT_STYLE_TAG,
+    CLAYKIT_STYLE_STAT,
+    CLAYKIT_STYLE_LIST,
+    CLAYKIT_STYLE_TABLE,
+    CLAYKIT_STYLE_INPUT,
+    CLAYKIT_STYLE_PROGRESS,
+    CLAYKIT_STYLE_SLIDER,
+    CLAYKIT_STYLE_ALERT,
+    CLAYKIT_STYLE_TOOLTIP,
+    CLAYKIT_STYLE_TABS,
+    CLAYKIT_STYLE_MODAL,
+    CLAYKIT_STYLE_SPINNER,
+    CLAYKIT_STYLE_DRAWER,
+    CLAYKIT_STYLE_POPOVER,
+    CLAYKIT_STYLE_LINK,
+    CLAYKIT_STYLE_BREADCRUMB,
+    CLAYKIT_STYLE_ACCORDION,
+    CLAYKIT_STYLE_MENU,
+    CLAYKIT_STYLE_SELECT,
+};
+
+void ClayKit_SetStyleCache(ClayKit_Context *ctx, ClayKit_StyleCacheEntry *entries, uint32_t count) {
+    ctx->style_cache = entries;
+    ctx->style_cache_cap = entries ? count : 0;
+    if (entries) {
+        memset(entries, 0, sizeof(ClayKit_StyleCacheEntry) * count);
+    }
+}
+
+void ClayKit_ThemeChanged(ClayKit_Context *ctx) {
+    ctx->theme_generation++;
+}
+
+/* Mixes the key a word at a time; never 0 so a zeroed entry can't match by
+ * hash alone. Config structs are small, so this stays a handful of multiplies. */
+static inline uint32_t claykit_style_hash(uint16_t kind, uint16_t variant, const void *cfg, uint32_t cfg_size) {
+    const uint8_t *bytes = (const uint8_t *)cfg;
+    uint32_t h = ((uint32_t)kind << 16 | variant) * 0x9E3779B1u;
+    uint32_t i = 0;
+    for (; i + 4 <= cfg_size; i += 4) {
+        uint32_t w;
+        memcpy(&w, bytes + i, 4);
+        h = (h ^ w) * 0x85EBCA6Bu;
+        h ^= h >> 15;
+    }
+    for (; i < cfg_size; i++) {
+        h = (h ^ bytes[i]) * 0x85EBCA6Bu;
+    }
+    h ^= h >> 13;
+    return h | 1u;
+}
+
+static ClayKit_StyleCacheEntry* claykit_style_slot(ClayKit_Context *ctx, uint32_t hash) {
+    return &ctx->style_cache[(uint32_t)(((uint64_t)hash * ctx->style_cache_cap) >> 32)];
+}
+
+/* Copies the cached style for this key into style and returns true on a hit */
+static inline bool claykit_style_cache_get(ClayKit_Context *ctx, uint16_t kind, uint16_t variant,
+                                           const void *cfg, uint32_t cfg_size,
+                                           void *style, uint32_t style_size, uint32_t *hash_out) {
+    if (ctx->style_cache_cap == 0) return false;
+    uint32_t hash = claykit_style_hash(kind, variant, cfg, cfg_size);
+    *hash_out = hash;
+    ClayKit_StyleCacheEntry *e = claykit_style_slot(ctx, hash);
+    if (e->hash == hash && e->kind == kind && e->variant == variant &&
+        e->theme == ctx->theme_ptr && e->theme_generation == ctx->theme_generation &&
+        memcmp(&e->cfg, cfg, cfg_size) == 0) {
+        memcpy(style, &e->style, style_size);
+        ctx->stats.style_cache_hits++;
+        return true;
+    }
+    ctx->stats.style_cache_misses++;
+    return false;
+}
+
+/* Stores a style under the hash claykit_style_cache_get returned for its key */
+static void claykit_style_cache_put(ClayKit_Context *ctx, uint32_t hash, uint16_t kind, uint16_t variant,
+                                    const void *cfg, uint32_t cfg_size,
+                                    const void *style, uint32_t style_size) {
+    if (ctx->style_cache_cap == 0) return;
+    ClayKit_StyleCacheEntry *e = claykit_style_slot(ctx, hash);
+    e->hash = hash;
+    e->kind = kind;
+    e->variant = variant;
+    e->theme = ctx->theme_ptr;
+    e->theme_generation = ctx->theme_generation;
+    memcpy(&e->cfg, cfg, cfg_size);
+    memcpy(&e->style, style, style_size);
+}
+
+/* Body of a ClayKit_Compute*Style: returns the cached style for the
+ * (kind, variant, cfg) key, or evaluates compute and caches the result */
+#define CLAYKIT_CACHED_STYLE(ctx, type, kind, variant, cfg, compute)                          \
+    do {                                                                                      \
+        type cached_style_;                                                                   \
+        uint32_t cached_hash_ = 0;                                                            \
+        if (!claykit_style_cache_get((ctx), (kind), (uint16_t)(variant), &(cfg), sizeof(cfg), \
+                                     &cached_style_, sizeof(cached_style_), &cached_hash_)) { \
+            cached_style_ = (compute);                                                        \
+            claykit_style_cache_put((ctx), cached_hash_, (kind), (uint16_t)(variant), &(cfg), \
+                                    sizeof(cfg), &cached_style_, sizeof(cached_style_));      \
+        }                                                                                     \
+        return cached_style_;                                                                 \
+    } while (0)
+
+/* ----------------------------------------------------------------------------
+ * Snapshot
+ * ---------------------------------------------------------------------------- */
+
+/* Layout, all fields u32 little-endian:
+ *   header: magic "CKSN", version, total size, frame, focused_id,
+ *           prev_focused_id, state count, input count
+ *   state:  id, flags, value bits, frame, blob size, then the blob bytes
+ *   input:  len, cursor, select_start, flags, then the text padded to 4 */
+#define CLAYKIT_SNAPSHOT_MAGIC 0x4E534B43u
+#define CLAYKIT_SNAPSHOT_HEADER_SIZE 32u
+
+/* Input flags a snapshot restores. Gap-buffer mode belongs to the target
+ * input's buffer layout and dragging to the live pointer, so both are kept. */
+#define CLAYKIT_SNAPSHOT_INPUT_FLAGS \
+    (CLAYKIT_INPUT_FOCUSED | CLAYKIT_INPUT_PASSWORD | CLAYKIT_INPUT_READONLY | CLAYKIT_INPUT_DISABLED)
+
+static void claykit_put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t claykit_get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t claykit_pad4(uint32_t n) {
+    return (n + 3u) & ~3u;
+}
+
+static uint32_t claykit_state_blob_size(ClayKit_Context *ctx, ClayKit_State *s) {
+    if (!s->blob) return 0;
+    return claykit_pool_class_size(ctx->state_pool.page_class[(s->blob - 1) / CLAYKIT_POOL_PAGE_SIZE]);
+}
+
+uint32_t ClayKit_SaveSnapshot(ClayKit_Context *ctx, ClayKit_InputState **inputs, uint32_t input_count,
+                              void *out, uint32_t out_cap) {
+    uint32_t size = CLAYKIT_SNAPSHOT_HEADER_SIZE;
+    for (uint32_t i = 0; i < ctx->state_cap; i++) {
+        ClayKit_State *s = &ctx->state_ptr[i];
+        if (s->id != 0) size += 20 + claykit_state_blob_size(ctx, s);
+    }
+    for (uint32_t i = 0; i < input_count; i++) {
+        /* Load rejects a missing input, so don't save one */
+        if (!inputs[i]) return 0;
+        size += 16 + claykit_pad4(inputs[i]->len);
+    }
+    if (!out || out_cap < size) return size;
+
+    uint8_t *p = (uint8_t *)out;
+    claykit_put_u32(p + 0, CLAYKIT_SNAPSHOT_MAGIC);
+    claykit_put_u32(p + 4, CLAYKIT_SNAPSHOT_VERSION);
+    claykit_put_u32(p + 8, size);
+    claykit_put_u32(p + 12, ctx->frame);
+    claykit_put_u32(p + 16, ctx->focused_id);
+    claykit_put_u32(p + 20, ctx->prev_focused_id);
+    claykit_put_u32(p + 24, ctx->state_count);
+    claykit_put_u32(p + 28, input_count);
+    p += CLAYKIT_SNAPSHOT_HEADER_SIZE;
+
+    for (uint32_t i = 0; i < ctx->state_cap; i++) {
+        ClayKit_State *s = &ctx->state_ptr[i];
+        if (s->id == 0) continue;
+        uint32_t value_bits;
+        uint32_t blob_size = claykit_state_blob_size(ctx, s);
+        memcpy(&value_bits, &s->value, sizeof(value_bits));
+        claykit_put_u32(p + 0, s->id);
+        claykit_put_u32(p + 4, s->flags);
+        claykit_put_u32(p + 8, value_bits);
+        claykit_put_u32(p + 12, s->frame);
+        claykit_put_u32(p + 16, blob_size);
+        p += 20;
+        if (blob_size) {
+            memcpy(p, ctx->state_pool.pages + s->blob - 1, blob_size);
+            p += blob_size;
+        }
+    }
+
+    for (uint32_t i = 0; i < input_count; i++) {
+        ClayKit_InputState *in = inputs[i];
+        uint32_t padded = claykit_pad4(in->len);
+        claykit_put_u32(p + 0, in->len);
+        claykit_put_u32(p + 4, in->cursor);
+        claykit_put_u32(p + 8, in->select_start);
+        claykit_put_u32(p + 12, in->flags);
+        p += 16;
+        claykit_input_copy_text(in, p);
+        memset(p + in->len, 0, padded - in->len);
+        p += padded;
+    }
+    return size;
+}
+
+/* Checks that the snapshot is well formed and that its states, blobs and
+ * texts fit this context and these inputs, without changing anything */
+static bool claykit_snapshot_validate(ClayKit_Context *ctx, ClayKit_InputState **inputs,
+                                      uint32_t input_count, const uint8_t *data, uint32_t size) {
+    if (!data || size < CLAYKIT_SNAPSHOT_HEADER_SIZE) return false;
+    if (claykit_get_u32(data + 0) != CLAYKIT_SNAPSHOT_MAGIC) return false;
+    if (claykit_get_u32(data + 4) != CLAYKIT_SNAPSHOT_VERSION) return false;
+    uint32_t total = claykit_get_u32(data + 8);
+    uint32_t state_count = claykit_get_u32(data + 24);
+    if (total < CLAYKIT_SNAPSHOT_HEADER_SIZE || total > size) return false;
+    if (state_count > ctx->state_cap) return false;
+    if (claykit_get_u32(data + 28) != input_count) return false;
+
+    uint32_t blobs_per_class[CLAYKIT_POOL_CLASS_COUNT] = {0};
+    uint32_t off = CLAYKIT_SNAPSHOT_HEADER_SIZE;
+    for (uint32_t i = 0; i < state_count; i++) {
+        if (total - off < 20) return false;
+        uint32_t id = claykit_get_u32(data + off);
+        uint32_t blob_size = claykit_get_u32(data + off + 16);
+        if (id == 0) return false;
+        /* A repeated id would share a slot and blob, breaking the counts
+         * below. Earlier records are already checked, so walking them is safe. */
+        for (uint32_t prev = CLAYKIT_SNAPSHOT_HEADER_SIZE; prev < off;
+             prev += 20 + claykit_get_u32(data + prev + 16)) {
+            if (claykit_get_u32(data + prev) == id) return false;
+        }
+        off += 20;
+        if (blob_size) {
+            if (blob_size > CLAYKIT_POOL_MAX_BLOB) return false;
+            uint32_t c = claykit_pool_class(blob_size);
+            if (claykit_pool_class_size(c) != blob_size) return false;
+            if (total - off < blob_size) return false;
+            blobs_per_class[c]++;
+            off += blob_size;
+        }
+    }
+
+    uint32_t pages = 0;
+    for (uint32_t c = 0; c < CLAYKIT_POOL_CLASS_COUNT; c++) {
+        uint32_t per_page = CLAYKIT_POOL_PAGE_SIZE / claykit_pool_class_size(c);
+        pages += (blobs_per_class[c] + per_page - 1) / per_page;
+    }
+    if (pages > ctx->state_pool.page_count) return false;
+
+    for (uint32_t i = 0; i < input_count; i++) {
+        if (total - off < 16) return false;
+        uint32_t len = claykit_get_u32(data + off);
+        uint32_t cursor = claykit_get_u32(data + off + 4);
+        uint32_t select_start = claykit_get_u32(data + off + 8);
+        off += 16;
+        if (!inputs[i] || len >= inputs[i]->cap) return false;
+        if (cursor > len || select_start > len) return false;
+        if (total - off < claykit_pad4(len)) return false;
+        if (inputs[i]->lines && claykit_count_newlines((const char *)data + off, len) >= inputs[i]->lines->cap) {
+            return false;
+        }
+        off += claykit_pad4(len);
+    }
+    return off == total;
+}
+
+bool ClayKit_LoadSnapshot(ClayKit_Context *ctx, ClayKit_InputState **inputs, uint32_t input_count,
+                          const void *data, uint32_t size) {
+    const uint8_t *p = (const uint8_t *)data;
+    if (!claykit_snapshot_validate(ctx, inputs, input_count, p, size)) return false;
+
+    /* Start from an empty table and pool, keeping the pool's memory */
+    for (uint32_t i = 0; i < ctx->state_cap; i++) {
+        ClayKit_State *s = &ctx->state_ptr[i];
+        s->id = 0;
+        s->flags = 0;
+        s->value = 0.0f;
+        s->frame = 0;
+        s->blob = 0;
+    }
+    ctx->state_count = 0;
+    ctx->stats.state_slots.used = 0;
+    ctx->state_pool.pages_used = 0;
+    ctx->state_pool.blob_count = 0;
+    ctx->state_pool.free_pages = 0;
+    ctx->state_pool.free_page_count = 0;
+    memset(ctx->state_pool.free_head, 0, sizeof(ctx->state_pool.free_head));
+    ctx->stats.state_pool_pages.used = 0;
+
+    ctx->frame = claykit_get_u32(p + 12);
+    ctx->focused_id = claykit_get_u32(p + 16);
+    ctx->prev_focused_id = claykit_get_u32(p + 20);
+    uint32_t state_count = claykit_get_u32(p + 24);
+    p += CLAYKIT_SNAPSHOT_HEADER_SIZE;
+
+    /* Validation checked ids are unique and the slot and page counts, so
+     * every state and blob finds room */
+    for (uint32_t i = 0; i < state_count; i++) {
+        uint32_t id = claykit_get_u32(p);
+        uint32_t flags = claykit_get_u32(p + 4);
+        uint32_t value_bits = claykit_get_u32(p + 8);
+        uint32_t frame = claykit_get_u32(p + 12);
+        uint32_t blob_size = claykit_get_u32(p + 16);
+        p += 20;
+        if (blob_size) {
+            void *blob = ClayKit_GetStateBlob(ctx, id, blob_size);
+            if (!blob) return false;
+            memcpy(blob, p, blob_size);
+            p += blob_size;
+        }
+        ClayKit_State *s = ClayKit_GetOrCreateState(ctx, id);
+        if (!s) return false;
+        s->flags = flags;
+        memcpy(&s->value, &value_bits, sizeof(s->value));
+        s->frame = frame;
+    }
+
+    for (uint32_t i = 0; i < input_count; i++) {
+        ClayKit_InputState *in = inputs[i];
+        uint32_t old_len = in->len;
+        in->len = claykit_get_u32(p);
+        claykit_input_delta_add(in, 0, old_len, in->len);
+        in->cursor = claykit_get_u32(p + 4);
+        in->select_start = claykit_get_u32(p + 8);
+        in->flags = (uint8_t)((in->flags & ~CLAYKIT_SNAPSHOT_INPUT_FLAGS)
+                            | (claykit_get_u32(p + 12) & CLAYKIT_SNAPSHOT_INPUT_FLAGS));
+        p += 16;
+        memcpy(in->buf, p, in->len);
+        in->gap = in->len;
+        ClayKit_InputClearHistory(in);
+        if (in->advances && in->advances->valid > 1) in->advances->valid = 1;
+        if (in->lines) claykit_lines_rebuild(in);
+        p += claykit_pad4(in->len);
+    }
+    return true;
+}
+
+/* ----------------------------------------------------------------------------
+ * Memory Planning
+ * ---------------------------------------------------------------------------- */
+
+/* Adds n components that each emit the given number of Clay layout elements
+ * (text included), element configs and text elements. Keep these in sync
+ * with the component implementations below. */
+static void claykit_budget_add(ClayKit_MemoryRequirements *r, uint32_t n,
+                               uint32_t elements, uint32_t configs, uint32_t texts) {
+    r->elements += n * elements;
+    r->element_configs += n * configs;
+    r->text_elements += n * texts;
+}
+
+#ifdef CLAY__MAXFLOAT
+/* Clay_MinMemorySize() for these limits. Clay's arrays are laid out in a
+ * local context, so Clay's defaults and current context are left alone. */
+static uint32_t claykit_clay_min_memory(uint32_t max_elements, uint32_t max_words) {
+    Clay_Context probe;
+    memset(&probe, 0, sizeof(probe));
+    probe.maxElementCount = (int32_t)max_elements;
+    probe.maxMeasureTextCacheWordCount = (int32_t)max_words;
+    probe.internalArena.capacity = SIZE_MAX;
+    Clay__Context_Allocate_Arena(&probe.internalArena);
+    Clay__InitializePersistentMemory(&probe);
+    Clay__InitializeEphemeralMemory(&probe);
+    return (uint32_t)probe.internalArena.nextAllocation + 128;
+}
+#endif
+
+ClayKit_MemoryRequirements ClayKit_ComputeMemoryRequirements(const ClayKit_MemoryCounts *c) {
+    ClayKit_MemoryRequirements r;
+    memset(&r, 0, sizeof(r));
+
+    claykit_budget_add(&r, c->containers,       1, 2, 0);
+    claykit_budget_add(&r, c->texts,            1, 1, 1);
+    claykit_budget_add(&r, c->truncated_texts,  3, 1, 1);
+    claykit_budget_add(&r, c->badges,           2, 2, 1);
+    claykit_budget_add(&r, c->tags,             2, 2, 1);
+    claykit_budget_add(&r, c->stats,            4, 3, 3);
+    claykit_budget_add(&r, c->lists,            1, 0, 0);
+    claykit_budget_add(&r, c->list_items,       4, 2, 2);
+    claykit_budget_add(&r, c->tables,           1, 1, 0);
+    claykit_budget_add(&r, c->table_rows,       1, 1, 0);
+    claykit_budget_add(&r, c->table_cells,      1, 1, 0);
+    claykit_budget_add(&r, c->buttons,          2, 2, 1);
+    claykit_budget_add(&r, c->icons,            1, 1, 0);
+    claykit_budget_add(&r, c->checkboxes,       2, 3, 0);
+    claykit_budget_add(&r, c->radios,           2, 3, 0);
+    claykit_budget_add(&r, c->switches,         2, 2, 0);
+    claykit_budget_add(&r, c->sliders,          3, 2, 0);
+    claykit_budget_add(&r, c->progress_bars,    2, 2, 0);
+    claykit_budget_add(&r, c->spinners,         2, 2, 0);
+    claykit_budget_add(&r, c->alerts,           2, 3, 1);
+    claykit_budget_add(&r, c->tooltips,         2, 2, 1);
+    claykit_budget_add(&r, c->tabs,             3, 2, 1);
+    claykit_budget_add(&r, c->links,            3, 2, 1);
+    claykit_budget_add(&r, c->breadcrumbs,      1, 0, 0);
+    claykit_budget_add(&r, c->breadcrumb_items, 3, 2, 2);
+    claykit_budget_add(&r, c->accordions,       1, 1, 0);
+    claykit_budget_add(&r, c->accordion_items,  6, 5, 2);
+    claykit_budget_add(&r, c->menus,            1, 3, 0);
+    claykit_budget_add(&r, c->menu_items,       2, 2, 1);
+    claykit_budget_add(&r, c->selects,          6, 7, 2);
+    claykit_budget_add(&r, c->select_options,   2, 2, 1);
+    claykit_budget_add(&r, c->text_inputs,      7, 7, 3);
+    claykit_budget_add(&r, c->text_areas,       5, 6, 2);
+    claykit_budget_add(&r, c->text_area_rows,   3, 2, 1);
+    claykit_budget_add(&r, c->drawers,          2, 4, 0);
+    claykit_budget_add(&r, c->popovers,         1, 3, 0);
+
+    /* Clay's arrays reserve one slot, and Clay_BeginLayout adds a root
+     * element. Render commands never outnumber element configs. */
+    uint32_t widest = r.elements > r.element_configs ? r.elements : r.element_configs;
+    r.clay_max_elements = widest + 2;
+
+    /* The measure cache hashes into words / 32 buckets, so keep at least 32 */
+    uint32_t words_per_text = c->words_per_text ? c->words_per_text : 3;
+    r.clay_measure_words = r.text_elements * words_per_text + 1;
+    if (r.clay_measure_words < 32) r.clay_measure_words = 32;
+
+    /* Size the Clay arena as Clay_MinMemorySize() would for these settings */
+#ifdef CLAY__MAXFLOAT
+    r.clay_bytes = claykit_clay_min_memory(r.clay_max_elements, r.clay_measure_words);
+#endif
+
+    /* State table at 75% load keeps probe chains short */
+    {
+        /* Each text input and area keeps its scroll offset in a state slot */
+        uint32_t stateful = c->stateful_elements + c->text_inputs + c->text_areas;
+        uint32_t live = stateful > c->state_blobs ? stateful : c->state_blobs;
+        r.state_slots = live + (live + 2) / 3;
+        r.state_bytes = r.state_slots * (uint32_t)sizeof(ClayKit_State);
+    }
+
+    /* Pages of the blob size class, plus two bookkeeping bytes each and alignment slack */
+    if (c->state_blobs > 0 && c->state_blob_size <= CLAYKIT_POOL_MAX_BLOB) {
+        uint32_t blob_size = claykit_pool_class_size(claykit_pool_class(c->state_blob_size));
+        uint32_t per_page = CLAYKIT_POOL_PAGE_SIZE / blob_size;
+        uint32_t pages = (c->state_blobs + per_page - 1) / per_page;
+        r.state_pool_bytes = pages * (CLAYKIT_POOL_PAGE_SIZE + 2) + 15;
+    }
+
+    /* Icon render data (4-byte aligned) and 12-byte list numbers */
+    if (c->icons > 0 || c->ordered_list_items > 0) {
+        r.frame_arena_bytes = c->icons * (uint32_t)sizeof(ClayKit_IconRenderData)
+                            + c->ordered_list_items * 12 + 3;
+    }
+
+    r.style_cache_bytes = c->style_cache_entries * (uint32_t)sizeof(ClayKit_StyleCacheEntry);
+
+    r.total_bytes = r.clay_bytes + r.state_bytes + r.state_pool_bytes + r.frame_arena_bytes
+                  + r.style_cache_bytes;
+    return r;
 }
 
 /* ----------------------------------------------------------------------------
@@ -1465,6 +2907,20 @@ ClayKit_State* ClayKit_GetOrCreateState(ClayKit_Context *ctx, uint32_t id) {
 
 void ClayKit_BeginFrame(ClayKit_Context *ctx) {
     ctx->prev_focused_id = ctx->focused_id;
+    ctx->frame++;
+    ctx->frame_arena_used = 0;
+    if (ctx->state_max_age > 0) {
+        ClayKit_EvictStaleStates(ctx, ctx->state_max_age);
+    }
+
+    claykit_stat_begin_frame(&ctx->stats.state_slots, false);
+    claykit_stat_begin_frame(&ctx->stats.state_pool_pages, false);
+    claykit_stat_begin_frame(&ctx->stats.frame_arena, true);
+    claykit_stat_begin_frame(&ctx->stats.icons, true);
+    claykit_stat_begin_frame(&ctx->stats.list_numbers, true);
+    claykit_stat_begin_frame(&ctx->stats.clay_elements, false);
+    claykit_stat_begin_frame(&ctx->stats.clay_measure_words, false);
+    memset(&ctx->stats.measure_frame, 0, sizeof(ctx->stats.measure_frame));
 }
 
 void ClayKit_SetFocus(ClayKit_Context *ctx, Clay_ElementId id) {
@@ -1541,32 +2997,696 @@ uint16_t ClayKit_GetRadius(ClayKit_Theme *theme, ClayKit_Size size) {
     }
 }
 
-/* ----------------------------------------------------------------------------
- * Text Input Handling
- * ---------------------------------------------------------------------------- */
-
-static uint32_t claykit_min_u32(uint32_t a, uint32_t b) {
-    return a < b ? a : b;
+/* Out-of-range sizes and schemes fall back like the switches above */
+static inline uint32_t claykit_size_index(ClayKit_Size size) {
+    return (uint32_t)size < CLAYKIT_SIZE_COUNT ? (uint32_t)size : (uint32_t)CLAYKIT_SIZE_MD;
 }
 
-static uint32_t claykit_max_u32(uint32_t a, uint32_t b) {
-    return a > b ? a : b;
+static inline uint32_t claykit_scheme_index(ClayKit_ColorScheme scheme) {
+    return (uint32_t)scheme < CLAYKIT_COLOR_SCHEME_COUNT ? (uint32_t)scheme : (uint32_t)CLAYKIT_COLOR_PRIMARY;
 }
 
-static void claykit_input_delete_selection(ClayKit_InputState *s) {
-    if (s->cursor == s->select_start) return;
-
-    uint32_t start = claykit_min_u32(s->cursor, s->select_start);
-    uint32_t end = claykit_max_u32(s->cursor, s->select_start);
-    uint32_t del_len = end - start;
+/* Component metrics that don't depend on the theme, XS..XL */
+static const uint16_t claykit_button_pad_x[CLAYKIT_SIZE_COUNT]     = {  8, 12, 16, 20, 24 };
+static const uint16_t claykit_button_pad_y[CLAYKIT_SIZE_COUNT]     = {  4,  6,  8, 12, 14 };
+static const uint16_t claykit_input_pad_x[CLAYKIT_SIZE_COUNT]      = {  6,  8, 12, 14, 16 };
+static const uint16_t claykit_input_pad_y[CLAYKIT_SIZE_COUNT]      = {  4,  6,  8, 10, 12 };
+static const uint16_t claykit_checkbox_size[CLAYKIT_SIZE_COUNT]    = { 14, 16, 18, 22, 26 };
+static const uint16_t claykit_switch_width[CLAYKIT_SIZE_COUNT]     = { 28, 34, 42, 50, 58 };
+static const uint16_t claykit_switch_height[CLAYKIT_SIZE_COUNT]    = { 16, 20, 24, 28, 32 };
+static const uint16_t claykit_switch_knob_size[CLAYKIT_SIZE_COUNT] = { 12, 16, 20, 24, 28 };
+
+void ClayKit_CompileTheme(ClayKit_Theme *theme, ClayKit_CompiledTheme *out) {
+    memset(out, 0, sizeof(*out));
+    out->source = theme;
+    if (!theme) return;
+
+    for (uint32_t i = 0; i < CLAYKIT_COLOR_SCHEME_COUNT; i++) {
+        out->scheme[i] = ClayKit_GetSchemeColor(theme, (ClayKit_ColorScheme)i);
+        out->scheme_hover[i] = claykit_color_darken(out->scheme[i], 0.1f);
+    }
 
-    /* Shift remaining text left */
-    for (uint32_t i = start; i < s->len - del_len; i++) {
-        s->buf[i] = s->buf[i + del_len];
+    for (uint32_t i = 0; i < CLAYKIT_SIZE_COUNT; i++) {
+        out->spacing[i] = ClayKit_GetSpacing(theme, (ClayKit_Size)i);
+        out->font_size[i] = ClayKit_GetFontSize(theme, (ClayKit_Size)i);
+        out->radius[i] = ClayKit_GetRadius(theme, (ClayKit_Size)i);
+    }
+
+    /* Heading sizes: XL=h1 (largest), LG=h2, MD=h3, SM=h4, XS=h5/h6 */
+    out->heading_font_size[CLAYKIT_SIZE_XS] = theme->font_size.md;
+    out->heading_font_size[CLAYKIT_SIZE_SM] = theme->font_size.lg;
+    out->heading_font_size[CLAYKIT_SIZE_MD] = theme->font_size.xl;
+    out->heading_font_size[CLAYKIT_SIZE_LG] = (uint16_t)(theme->font_size.xl + 4);
+    out->heading_font_size[CLAYKIT_SIZE_XL] = (uint16_t)(theme->font_size.xl + 8);
+
+    memcpy(out->button_pad_x, claykit_button_pad_x, sizeof(out->button_pad_x));
+    memcpy(out->button_pad_y, claykit_button_pad_y, sizeof(out->button_pad_y));
+    memcpy(out->input_pad_x, claykit_input_pad_x, sizeof(out->input_pad_x));
+    memcpy(out->input_pad_y, claykit_input_pad_y, sizeof(out->input_pad_y));
+    memcpy(out->checkbox_size, claykit_checkbox_size, sizeof(out->checkbox_size));
+    memcpy(out->switch_width, claykit_switch_width, sizeof(out->switch_width));
+    memcpy(out->switch_height, claykit_switch_height, sizeof(out->switch_height));
+    memcpy(out->switch_knob_size, claykit_switch_knob_size, sizeof(out->switch_knob_size));
+}
+
+/* The context's tables, recompiled if the theme was swapped or changed */
+static inline const ClayKit_CompiledTheme* claykit_theme_tables(ClayKit_Context *ctx) {
+    ClayKit_CompiledTheme *ct = &ctx->compiled_theme;
+    if (ct->source != ctx->theme_ptr || ct->generation != ctx->theme_generation) {
+        ClayKit_CompileTheme(ctx->theme_ptr, ct);
+        ct->generation = ctx->theme_generation;
+    }
+    return ct;
+}
+
+static inline Clay_Color claykit_scheme_color(ClayKit_Context *ctx, ClayKit_ColorScheme scheme) {
+    return claykit_theme_tables(ctx)->scheme[claykit_scheme_index(scheme)];
+}
+
+static inline Clay_Color claykit_scheme_hover(ClayKit_Context *ctx, ClayKit_ColorScheme scheme) {
+    return claykit_theme_tables(ctx)->scheme_hover[claykit_scheme_index(scheme)];
+}
+
+static inline uint16_t claykit_font_size(ClayKit_Context *ctx, ClayKit_Size size) {
+    return claykit_theme_tables(ctx)->font_size[claykit_size_index(size)];
+}
+
+static inline uint16_t claykit_radius(ClayKit_Context *ctx, ClayKit_Size size) {
+    return claykit_theme_tables(ctx)->radius[claykit_size_index(size)];
+}
+
+/* ----------------------------------------------------------------------------
+ * Text Input Handling
+ * ---------------------------------------------------------------------------- */
+
+static uint32_t claykit_min_u32(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+static uint32_t claykit_max_u32(uint32_t a, uint32_t b) {
+    return a > b ? a : b;
+}
+
+#if defined(CLAYKIT_SIMD_SSE2) || defined(CLAYKIT_SIMD_NEON)
+/* Index of the lowest / highest set bit, x != 0 */
+static uint32_t claykit_ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while (!(x & 1)) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+static uint32_t claykit_msb64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (uint32_t)__builtin_clzll(x);
+#else
+    uint32_t n = 0;
+    while (x >>= 1) n++;
+    return n;
+#endif
+}
+#endif
+
+/* Character classes for word motion and selection. Every byte of a
+ * multi-byte UTF-8 sequence is a word byte, so a change of class always
+ * falls on a codepoint boundary. */
+enum {
+    CLAYKIT_CLASS_SPACE,    /* ' ', \t, \n, \v, \f, \r */
+    CLAYKIT_CLASS_PUNCT,    /* Other ASCII, including controls */
+    CLAYKIT_CLASS_WORD      /* ASCII letters, digits, '_' and all non-ASCII */
+};
+
+static uint32_t claykit_char_class(char ch) {
+    unsigned char c = (unsigned char)ch;
+    if (c == ' ' || (c >= 9 && c <= 13)) return CLAYKIT_CLASS_SPACE;
+    if (c >= 0x80 || c == '_' || (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')) {
+        return CLAYKIT_CLASS_WORD;
+    }
+    return CLAYKIT_CLASS_PUNCT;
+}
+
+/* Mask of the bytes in p[0..16) whose class isn't cls. SSE2 gives one bit
+ * per byte, NEON four, see CLAYKIT_SCAN_BITS. Ranges are tested as
+ * (v - lo) <= span on unsigned bytes. */
+#if defined(CLAYKIT_SIMD_SSE2)
+#define CLAYKIT_SCAN_BITS 1
+static __m128i claykit_in_range16(__m128i v, char lo, char span) {
+    __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(span)), d);
+}
+
+static uint64_t claykit_class_mask16(const char *p, uint32_t cls) {
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), claykit_in_range16(v, 9, 4));
+    __m128i word = _mm_or_si128(
+        _mm_or_si128(_mm_cmplt_epi8(v, _mm_setzero_si128()), _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))),
+        _mm_or_si128(claykit_in_range16(v, '0', 9),
+                     claykit_in_range16(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 25)));
+    uint32_t m_space = (uint32_t)_mm_movemask_epi8(space);
+    uint32_t m_word = (uint32_t)_mm_movemask_epi8(word);
+    uint32_t in = cls == CLAYKIT_CLASS_SPACE ? m_space
+                : cls == CLAYKIT_CLASS_WORD ? m_word
+                : ~(m_space | m_word);
+    return ~in & 0xFFFFu;
+}
+#elif defined(CLAYKIT_SIMD_NEON)
+#define CLAYKIT_SCAN_BITS 4
+static uint8x16_t claykit_in_range16(uint8x16_t v, uint8_t lo, uint8_t span) {
+    return vcleq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(span));
+}
+
+static uint64_t claykit_class_mask16(const char *p, uint32_t cls) {
+    uint8x16_t v = vld1q_u8((const uint8_t *)p);
+    uint8x16_t space = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), claykit_in_range16(v, 9, 4));
+    uint8x16_t word = vorrq_u8(
+        vorrq_u8(vcgeq_u8(v, vdupq_n_u8(0x80)), vceqq_u8(v, vdupq_n_u8('_'))),
+        vorrq_u8(claykit_in_range16(v, '0', 9),
+                 claykit_in_range16(vorrq_u8(v, vdupq_n_u8(0x20)), 'a', 25)));
+    uint8x16_t in = cls == CLAYKIT_CLASS_SPACE ? space
+                  : cls == CLAYKIT_CLASS_WORD ? word
+                  : vmvnq_u8(vorrq_u8(space, word));
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(vmvnq_u8(in)), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+#endif
+
+/* Index of the first byte in p[0..n) whose class isn't cls, or n */
+static uint32_t claykit_scan_class_fwd(const char *p, uint32_t n, uint32_t cls) {
+    uint32_t i = 0;
+#ifdef CLAYKIT_SCAN_BITS
+    for (; i + 16 <= n; i += 16) {
+        uint64_t m = claykit_class_mask16(p + i, cls);
+        if (m) return i + claykit_ctz64(m) / CLAYKIT_SCAN_BITS;
+    }
+#endif
+    for (; i < n; i++) {
+        if (claykit_char_class(p[i]) != cls) return i;
+    }
+    return n;
+}
+
+/* One past the last byte in p[0..n) whose class isn't cls, or 0 */
+static uint32_t claykit_scan_class_back(const char *p, uint32_t n, uint32_t cls) {
+    uint32_t i = n;
+#ifdef CLAYKIT_SCAN_BITS
+    for (; i >= 16; i -= 16) {
+        uint64_t m = claykit_class_mask16(p + i - 16, cls);
+        if (m) return i - 16 + claykit_msb64(m) / CLAYKIT_SCAN_BITS + 1;
+    }
+#endif
+    for (; i > 0; i--) {
+        if (claykit_char_class(p[i - 1]) != cls) return i;
+    }
+    return 0;
+}
+
+/* Encodes a printable codepoint as UTF-8. Returns the byte count, or 0 for
+ * controls, surrogates and values past U+10FFFF. */
+static uint32_t claykit_utf8_encode(uint32_t cp, char *out) {
+    if (cp < 32 || (cp >= 0x7F && cp < 0xA0)) return 0;
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp >= 0xD800 && cp <= 0xDFFF) return 0;
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (cp > 0x10FFFF) return 0;
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+static bool claykit_utf8_is_cont(char c) {
+    return ((unsigned char)c & 0xC0) == 0x80;
+}
+
+static bool claykit_input_is_gap(const ClayKit_InputState *s) {
+    return (s->flags & CLAYKIT_INPUT_GAP_BUFFER) != 0;
+}
+
+/* Byte at logical offset i */
+static char claykit_input_at(const ClayKit_InputState *s, uint32_t i) {
+    if (claykit_input_is_gap(s) && i >= s->gap) {
+        i += s->cap - s->len;
+    }
+    return s->buf[i];
+}
+
+/* Start of the codepoint before logical offset i */
+static uint32_t claykit_input_prev_boundary(const ClayKit_InputState *s, uint32_t i) {
+    if (i == 0) return 0;
+    i--;
+    while (i > 0 && claykit_utf8_is_cont(claykit_input_at(s, i))) i--;
+    return i;
+}
+
+/* Start of the codepoint after the one at logical offset i */
+static uint32_t claykit_input_next_boundary(const ClayKit_InputState *s, uint32_t i) {
+    if (i >= s->len) return s->len;
+    i++;
+    while (i < s->len && claykit_utf8_is_cont(claykit_input_at(s, i))) i++;
+    return i;
+}
+
+/* First logical offset >= i whose class isn't cls, or len. Scans the runs
+ * before and after the gap separately. */
+static uint32_t claykit_input_scan_fwd(const ClayKit_InputState *s, uint32_t i, uint32_t cls) {
+    if (claykit_input_is_gap(s)) {
+        if (i < s->gap) {
+            uint32_t k = i + claykit_scan_class_fwd(s->buf + i, s->gap - i, cls);
+            if (k < s->gap) return k;
+            i = s->gap;
+        }
+        const char *tail = s->buf + (s->cap - s->len);
+        return i + claykit_scan_class_fwd(tail + i, s->len - i, cls);
+    }
+    return i + claykit_scan_class_fwd(s->buf + i, s->len - i, cls);
+}
+
+/* One past the last logical offset < i whose class isn't cls, or 0 */
+static uint32_t claykit_input_scan_back(const ClayKit_InputState *s, uint32_t i, uint32_t cls) {
+    if (claykit_input_is_gap(s) && i > s->gap) {
+        const char *tail = s->buf + (s->cap - s->len);
+        uint32_t k = claykit_scan_class_back(tail + s->gap, i - s->gap, cls);
+        if (k > 0) return s->gap + k;
+        i = s->gap;
+    }
+    return claykit_scan_class_back(s->buf, i, cls);
+}
+
+/* Ctrl+Right target: past the run of i's class, then past any whitespace */
+static uint32_t claykit_input_word_right(const ClayKit_InputState *s, uint32_t i) {
+    if (i >= s->len) return s->len;
+    uint32_t cls = claykit_char_class(claykit_input_at(s, i));
+    if (cls != CLAYKIT_CLASS_SPACE) i = claykit_input_scan_fwd(s, i, cls);
+    return claykit_input_scan_fwd(s, i, CLAYKIT_CLASS_SPACE);
+}
+
+/* Ctrl+Left target: back over whitespace, then to the start of the run
+ * before it */
+static uint32_t claykit_input_word_left(const ClayKit_InputState *s, uint32_t i) {
+    i = claykit_input_scan_back(s, i, CLAYKIT_CLASS_SPACE);
+    if (i == 0) return 0;
+    return claykit_input_scan_back(s, i, claykit_char_class(claykit_input_at(s, i - 1)));
+}
+
+static void claykit_input_copy_text(const ClayKit_InputState *s, void *dst) {
+    if (claykit_input_is_gap(s)) {
+        memcpy(dst, s->buf, s->gap);
+        memcpy((char *)dst + s->gap, s->buf + s->cap - (s->len - s->gap), s->len - s->gap);
+    } else {
+        memcpy(dst, s->buf, s->len);
+    }
+}
+
+/* Moves the gap to logical offset pos, shifting only the bytes in between */
+static void claykit_input_move_gap(ClayKit_InputState *s, uint32_t pos) {
+    uint32_t gap_len = s->cap - s->len;
+    if (pos < s->gap) {
+        memmove(s->buf + pos + gap_len, s->buf + pos, s->gap - pos);
+    } else if (pos > s->gap) {
+        memmove(s->buf + s->gap, s->buf + s->gap + gap_len, pos - s->gap);
+    }
+    s->gap = pos;
+}
+
+/* Removes count bytes at logical offset pos */
+static void claykit_input_remove(ClayKit_InputState *s, uint32_t pos, uint32_t count) {
+    if (claykit_input_is_gap(s)) {
+        /* Grow the gap over the removed bytes from whichever side is closer */
+        if (s->gap > pos) {
+            claykit_input_move_gap(s, pos + count);
+            s->gap = pos;
+        } else {
+            claykit_input_move_gap(s, pos);
+        }
+    } else {
+        memmove(s->buf + pos, s->buf + pos + count, s->len - pos - count);
+    }
+    s->len -= count;
+}
+
+/* Inserts count bytes at logical offset pos, capacity already checked */
+static void claykit_input_insert(ClayKit_InputState *s, uint32_t pos, const char *text, uint32_t count) {
+    if (claykit_input_is_gap(s)) {
+        claykit_input_move_gap(s, pos);
+        s->gap += count;
+    } else {
+        memmove(s->buf + pos + count, s->buf + pos, s->len - pos);
+    }
+    memcpy(s->buf + pos, text, count);
+    s->len += count;
+}
+
+static uint32_t claykit_count_newlines(const char *text, uint32_t n) {
+    if (n == 0) return 0;
+    uint32_t count = 0;
+    const char *end = text + n;
+    while (text < end && (text = (const char *)memchr(text, '\n', (size_t)(end - text))) != NULL) {
+        text++;
+        count++;
+    }
+    return count;
+}
+
+/* Start of line i */
+static uint32_t claykit_lines_get(const ClayKit_InputState *s, uint32_t i) {
+    const ClayKit_InputLineIndex *l = s->lines;
+    if (i < l->gap) return l->starts[i];
+    return s->len - l->starts[i + (l->cap - l->count)];
+}
+
+/* Last line starting at or before offset */
+static uint32_t claykit_lines_at(const ClayKit_InputState *s, uint32_t offset) {
+    uint32_t lo = 0;
+    uint32_t hi = s->lines->count;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (claykit_lines_get(s, mid) <= offset) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* Moves the index's gap to line i, converting the entries it passes */
+static void claykit_lines_move_gap(ClayKit_InputState *s, uint32_t i) {
+    ClayKit_InputLineIndex *l = s->lines;
+    uint32_t hole = l->cap - l->count;
+    while (l->gap > i) {
+        l->gap--;
+        l->starts[l->gap + hole] = s->len - l->starts[l->gap];
+    }
+    while (l->gap < i) {
+        l->starts[l->gap] = s->len - l->starts[l->gap + hole];
+        l->gap++;
+    }
+}
+
+/* Updates the index for a splice, before the text changes. Lines after the
+ * edit count from the end of the text, so they stay valid as they are. */
+static void claykit_lines_splice(ClayKit_InputState *s, uint32_t pos, uint32_t count, const char *text, uint32_t n) {
+    ClayKit_InputLineIndex *l = s->lines;
+    claykit_lines_move_gap(s, claykit_lines_at(s, pos) + 1);
+
+    /* Drop the lines whose newline is removed */
+    while (l->gap < l->count && s->len - l->starts[l->gap + (l->cap - l->count)] <= pos + count) {
+        l->count--;
+    }
+
+    /* Add one for each inserted newline; callers check there is room */
+    if (n == 0) return;
+    const char *p = text;
+    const char *end = text + n;
+    while (p < end && (p = (const char *)memchr(p, '\n', (size_t)(end - p))) != NULL && l->count < l->cap) {
+        p++;
+        l->starts[l->gap++] = pos + (uint32_t)(p - text);
+        l->count++;
     }
-    s->len -= del_len;
-    s->cursor = start;
-    s->select_start = start;
+}
+
+/* Rebuilds the index from the text; false if it has more lines than fit */
+static bool claykit_lines_rebuild(ClayKit_InputState *s) {
+    ClayKit_InputLineIndex *l = s->lines;
+    bool gap = claykit_input_is_gap(s);
+    uint32_t head = gap ? s->gap : s->len;
+    const char *runs[2] = { s->buf, s->buf + s->cap - (s->len - head) };
+    uint32_t bases[2] = { 0, head };
+    uint32_t lens[2] = { head, s->len - head };
+
+    l->count = 1;
+    l->gap = 1;
+    l->starts[0] = 0;
+    for (int r = 0; r < 2; r++) {
+        const char *p = runs[r];
+        const char *end = runs[r] + lens[r];
+        while (p < end && (p = (const char *)memchr(p, '\n', (size_t)(end - p))) != NULL) {
+            p++;
+            if (l->count == l->cap) {
+                l->count = 1;
+                l->gap = 1;
+                return false;
+            }
+            l->starts[l->count++] = bases[r] + (uint32_t)(p - runs[r]);
+        }
+    }
+    l->gap = l->count;
+    return true;
+}
+
+/* End of line i: the offset of its newline, or len for the last line */
+static uint32_t claykit_lines_end(const ClayKit_InputState *s, uint32_t i) {
+    return i + 1 < s->lines->count ? claykit_lines_get(s, i + 1) - 1 : s->len;
+}
+
+/* Pointer to the logical bytes [a, b), moving the gap past them first if it
+ * splits them. Pointers to runs before a stay valid. */
+static const char* claykit_input_span(ClayKit_InputState *s, uint32_t a, uint32_t b) {
+    if (!claykit_input_is_gap(s)) return s->buf + a;
+    if (s->gap > a && s->gap < b) claykit_input_move_gap(s, b);
+    return a >= s->gap ? s->buf + a + (s->cap - s->len) : s->buf + a;
+}
+
+/* Merges replacing count bytes at pos of the current text with n bytes into
+ * the delta. The current text already holds the earlier edits, so the new
+ * range is widened to cover them and its end mapped back to the old text. */
+static void claykit_input_delta_add(ClayKit_InputState *s, uint32_t pos, uint32_t count, uint32_t n) {
+    ClayKit_InputDelta *d = s->delta;
+    if (!d) return;
+    if (d->edits == 0) {
+        d->start = pos;
+        d->removed = count;
+        d->inserted = n;
+    } else {
+        uint32_t lo = claykit_min_u32(d->start, pos);
+        uint32_t hi = claykit_max_u32(d->start + d->inserted, pos + count);
+        d->removed = hi - d->inserted + d->removed - lo;
+        d->inserted = hi - count + n - lo;
+        d->start = lo;
+    }
+    d->edits++;
+}
+
+/* Replaces count bytes at logical offset pos with n bytes of text, capacity
+ * already checked. Moves the tail once instead of remove + insert. */
+static void claykit_input_splice(ClayKit_InputState *s, uint32_t pos, uint32_t count, const char *text, uint32_t n) {
+    claykit_input_delta_add(s, pos, count, n);
+    /* Widths of prefixes up to pos don't change */
+    if (s->advances && s->advances->valid > pos + 1) {
+        s->advances->valid = pos + 1;
+    }
+    if (s->lines) claykit_lines_splice(s, pos, count, text, n);
+    if (claykit_input_is_gap(s)) {
+        claykit_input_remove(s, pos, count);
+        if (n > 0) claykit_input_insert(s, pos, text, n);
+        return;
+    }
+    if (n != count) {
+        memmove(s->buf + pos + n, s->buf + pos + count, s->len - pos - count);
+    }
+    if (n > 0) memcpy(s->buf + pos, text, n);
+    s->len = s->len - count + n;
+}
+
+/* Each history entry is a header {pos, removed, inserted, cursor,
+ * select_start}, then the removed bytes, the inserted bytes and a trailing
+ * u32 holding the entry size, so the ring can be walked from either end.
+ * cursor and select_start are the selection from before the edit. */
+#define CLAYKIT_HISTORY_HEADER_SIZE 20u
+
+/* Ring offset of the byte off bytes past the oldest entry */
+static uint32_t claykit_history_at(const ClayKit_InputHistory *h, uint32_t off) {
+    return off < h->cap - h->start ? h->start + off : off - (h->cap - h->start);
+}
+
+static void claykit_history_write(ClayKit_InputHistory *h, uint32_t off, const void *src, uint32_t n) {
+    if (n == 0) return;
+    uint32_t at = claykit_history_at(h, off);
+    uint32_t first = claykit_min_u32(n, h->cap - at);
+    memcpy(h->buf + at, src, first);
+    memcpy(h->buf, (const uint8_t *)src + first, n - first);
+}
+
+static void claykit_history_read(const ClayKit_InputHistory *h, uint32_t off, void *dst, uint32_t n) {
+    uint32_t at = claykit_history_at(h, off);
+    uint32_t first = claykit_min_u32(n, h->cap - at);
+    memcpy(dst, h->buf + at, first);
+    memcpy((uint8_t *)dst + first, h->buf, n - first);
+}
+
+/* Copies n bytes of text at logical offset pos into the ring */
+static void claykit_history_write_text(ClayKit_InputHistory *h, uint32_t off,
+                                       const ClayKit_InputState *s, uint32_t pos, uint32_t n) {
+    if (claykit_input_is_gap(s) && pos + n > s->gap) {
+        if (pos < s->gap) {
+            uint32_t head = s->gap - pos;
+            claykit_history_write(h, off, s->buf + pos, head);
+            off += head;
+            pos += head;
+            n -= head;
+        }
+        claykit_history_write(h, off, s->buf + (s->cap - s->len) + pos, n);
+        return;
+    }
+    claykit_history_write(h, off, s->buf + pos, n);
+}
+
+/* Replaces count bytes at pos with the n ring bytes at off, which may wrap */
+static void claykit_history_apply(ClayKit_InputState *s, uint32_t pos, uint32_t count,
+                                  const ClayKit_InputHistory *h, uint32_t off, uint32_t n) {
+    uint32_t at = claykit_history_at(h, off);
+    uint32_t first = claykit_min_u32(n, h->cap - at);
+    claykit_input_splice(s, pos, count, (const char *)h->buf + at, first);
+    if (n > first) {
+        claykit_input_splice(s, pos + first, 0, (const char *)h->buf, n - first);
+    }
+}
+
+/* Drops the oldest entry and returns its size */
+static uint32_t claykit_history_drop_oldest(ClayKit_InputHistory *h) {
+    uint32_t hdr[3];
+    claykit_history_read(h, 0, hdr, sizeof(hdr));
+    uint32_t size = CLAYKIT_HISTORY_HEADER_SIZE + hdr[1] + hdr[2] + 4;
+    h->start = claykit_history_at(h, size);
+    h->undo_len -= size;
+    return size;
+}
+
+/* Records replacing count bytes at pos with text. Consecutive typing is
+ * merged into one entry until a space follows a non-space. */
+static void claykit_history_record(ClayKit_InputState *s, uint32_t pos, uint32_t count,
+                                   const char *text, uint32_t n, bool typing) {
+    ClayKit_InputHistory *h = s->history;
+    if (h->cap == 0 || (count == 0 && n == 0)) return;
+    h->redo_len = 0;
+
+    if (typing && h->open && count == 0 && h->undo_len > 0) {
+        uint32_t size;
+        uint32_t hdr[5];
+        claykit_history_read(h, h->undo_len - 4, &size, 4);
+        uint32_t top = h->undo_len - size;
+        claykit_history_read(h, top, hdr, CLAYKIT_HISTORY_HEADER_SIZE);
+        bool word_break = claykit_char_class(text[0]) == CLAYKIT_CLASS_SPACE && pos > 0 &&
+                          claykit_char_class(claykit_input_at(s, pos - 1)) != CLAYKIT_CLASS_SPACE;
+        if (pos == hdr[0] + hdr[2] && !word_break) {
+            while (h->undo_len + n > h->cap && top > 0) {
+                top -= claykit_history_drop_oldest(h);
+            }
+            if (h->undo_len + n <= h->cap) {
+                hdr[2] += n;
+                size += n;
+                claykit_history_write(h, top, hdr, CLAYKIT_HISTORY_HEADER_SIZE);
+                claykit_history_write(h, h->undo_len - 4, text, n);
+                claykit_history_write(h, h->undo_len - 4 + n, &size, 4);
+                h->undo_len += n;
+                return;
+            }
+        }
+    }
+
+    uint32_t size = CLAYKIT_HISTORY_HEADER_SIZE + count + n + 4;
+    if (size > h->cap) {
+        /* Too big to keep: nothing before this edit can be undone either */
+        ClayKit_InputClearHistory(s);
+        return;
+    }
+    while (h->undo_len + size > h->cap) {
+        claykit_history_drop_oldest(h);
+    }
+
+    uint32_t off = h->undo_len;
+    uint32_t hdr[5] = { pos, count, n, s->cursor, s->select_start };
+    claykit_history_write(h, off, hdr, CLAYKIT_HISTORY_HEADER_SIZE);
+    claykit_history_write_text(h, off + CLAYKIT_HISTORY_HEADER_SIZE, s, pos, count);
+    claykit_history_write(h, off + CLAYKIT_HISTORY_HEADER_SIZE + count, text, n);
+    claykit_history_write(h, off + size - 4, &size, 4);
+    h->undo_len += size;
+    h->open = typing;
+}
+
+/* Replaces count bytes at pos with text, recording it in the history */
+static void claykit_input_edit(ClayKit_InputState *s, uint32_t pos, uint32_t count,
+                               const char *text, uint32_t n, bool typing) {
+    if (s->history) {
+        claykit_history_record(s, pos, count, text, n, typing);
+    }
+    claykit_input_splice(s, pos, count, text, n);
+}
+
+static void claykit_input_delete_selection(ClayKit_InputState *s) {
+    if (s->cursor == s->select_start) return;
+
+    uint32_t start = claykit_min_u32(s->cursor, s->select_start);
+    uint32_t end = claykit_max_u32(s->cursor, s->select_start);
+
+    claykit_input_edit(s, start, end - start, NULL, 0, false);
+    s->cursor = start;
+    s->select_start = start;
+}
+
+/* Replaces the selection with text as one edit. If it doesn't fit, the
+ * selection is still deleted and false is returned. */
+static bool claykit_input_replace_selection(ClayKit_InputState *s, const char *text, uint32_t n, bool typing) {
+    uint32_t start = claykit_min_u32(s->cursor, s->select_start);
+    uint32_t end = claykit_max_u32(s->cursor, s->select_start);
+
+    bool fits = s->len - (end - start) + n < s->cap;
+    if (fits && s->lines) {
+        uint32_t lines = s->lines->count - (claykit_lines_at(s, end) - claykit_lines_at(s, start));
+        fits = lines + claykit_count_newlines(text, n) <= s->lines->cap;
+    }
+    if (!fits) {
+        claykit_input_delete_selection(s);
+        return false;
+    }
+
+    claykit_input_edit(s, start, end - start, text, n, typing);
+    s->cursor = start + n;
+    s->select_start = s->cursor;
+    return true;
+}
+
+/* Moves the cursor delta lines, keeping its column in codepoints. Moving
+ * past the first or last line goes to the start or end of the text. */
+static void claykit_input_move_lines(ClayKit_InputState *s, int32_t delta) {
+    uint32_t line = claykit_lines_at(s, s->cursor);
+    int64_t target = (int64_t)line + delta;
+    if (target < 0) {
+        s->cursor = 0;
+        return;
+    }
+    if (target >= (int64_t)s->lines->count) {
+        s->cursor = s->len;
+        return;
+    }
+
+    uint32_t col = 0;
+    for (uint32_t i = claykit_lines_get(s, line); i < s->cursor; i = claykit_input_next_boundary(s, i)) {
+        col++;
+    }
+    uint32_t pos = claykit_lines_get(s, (uint32_t)target);
+    uint32_t end = claykit_lines_end(s, (uint32_t)target);
+    for (; col > 0 && pos < end; col--) {
+        pos = claykit_input_next_boundary(s, pos);
+    }
+    s->cursor = pos;
 }
 
 bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods) {
@@ -1574,18 +3694,20 @@ bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods)
     bool ctrl = (mods & CLAYKIT_MOD_CTRL) != 0;
     bool changed = false;
 
+    /* Any key ends a run of typing in the history */
+    if (s->history) s->history->open = false;
+
     switch (key) {
         case CLAYKIT_KEY_BACKSPACE:
             if (s->cursor != s->select_start) {
                 claykit_input_delete_selection(s);
                 changed = true;
             } else if (s->cursor > 0) {
-                /* Delete char before cursor */
-                for (uint32_t i = s->cursor - 1; i < s->len - 1; i++) {
-                    s->buf[i] = s->buf[i + 1];
-                }
-                s->len--;
-                s->cursor--;
+                /* Delete the codepoint, or with Ctrl the word, before the cursor */
+                uint32_t start = ctrl ? claykit_input_word_left(s, s->cursor)
+                                      : claykit_input_prev_boundary(s, s->cursor);
+                claykit_input_edit(s, start, s->cursor - start, NULL, 0, false);
+                s->cursor = start;
                 s->select_start = s->cursor;
                 changed = true;
             }
@@ -1596,11 +3718,10 @@ bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods)
                 claykit_input_delete_selection(s);
                 changed = true;
             } else if (s->cursor < s->len) {
-                /* Delete char at cursor */
-                for (uint32_t i = s->cursor; i < s->len - 1; i++) {
-                    s->buf[i] = s->buf[i + 1];
-                }
-                s->len--;
+                /* Delete the codepoint, or with Ctrl the word, at the cursor */
+                uint32_t end = ctrl ? claykit_input_word_right(s, s->cursor)
+                                    : claykit_input_next_boundary(s, s->cursor);
+                claykit_input_edit(s, s->cursor, end - s->cursor, NULL, 0, false);
                 changed = true;
             }
             break;
@@ -1608,10 +3729,9 @@ bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods)
         case CLAYKIT_KEY_LEFT:
             if (ctrl) {
                 /* Move to start of previous word */
-                while (s->cursor > 0 && s->buf[s->cursor - 1] == ' ') s->cursor--;
-                while (s->cursor > 0 && s->buf[s->cursor - 1] != ' ') s->cursor--;
-            } else if (s->cursor > 0) {
-                s->cursor--;
+                s->cursor = claykit_input_word_left(s, s->cursor);
+            } else {
+                s->cursor = claykit_input_prev_boundary(s, s->cursor);
             }
             if (!shift) s->select_start = s->cursor;
             changed = true;
@@ -1619,28 +3739,56 @@ bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods)
 
         case CLAYKIT_KEY_RIGHT:
             if (ctrl) {
-                /* Move to end of next word */
-                while (s->cursor < s->len && s->buf[s->cursor] != ' ') s->cursor++;
-                while (s->cursor < s->len && s->buf[s->cursor] == ' ') s->cursor++;
-            } else if (s->cursor < s->len) {
-                s->cursor++;
+                /* Move past the next word and the whitespace after it */
+                s->cursor = claykit_input_word_right(s, s->cursor);
+            } else {
+                s->cursor = claykit_input_next_boundary(s, s->cursor);
             }
             if (!shift) s->select_start = s->cursor;
             changed = true;
             break;
 
         case CLAYKIT_KEY_HOME:
-            s->cursor = 0;
+            /* Start of the line in a multi-line input, Ctrl for the text */
+            s->cursor = s->lines && !ctrl ? claykit_lines_get(s, claykit_lines_at(s, s->cursor)) : 0;
             if (!shift) s->select_start = s->cursor;
             changed = true;
             break;
 
         case CLAYKIT_KEY_END:
-            s->cursor = s->len;
+            s->cursor = s->lines && !ctrl ? claykit_lines_end(s, claykit_lines_at(s, s->cursor)) : s->len;
             if (!shift) s->select_start = s->cursor;
             changed = true;
             break;
 
+        case CLAYKIT_KEY_UP:
+        case CLAYKIT_KEY_DOWN:
+        case CLAYKIT_KEY_PAGE_UP:
+        case CLAYKIT_KEY_PAGE_DOWN:
+            if (s->lines) {
+                int32_t step = 1;
+                if (key == CLAYKIT_KEY_PAGE_UP || key == CLAYKIT_KEY_PAGE_DOWN) {
+                    step = s->lines->page > 0 ? (int32_t)s->lines->page : 1;
+                }
+                claykit_input_move_lines(s, (key == CLAYKIT_KEY_UP || key == CLAYKIT_KEY_PAGE_UP) ? -step : step);
+                if (!shift) s->select_start = s->cursor;
+                changed = true;
+            }
+            break;
+
+        case CLAYKIT_KEY_ENTER:
+            /* Only multi-line inputs take a newline */
+            if (s->lines) changed = claykit_input_replace_selection(s, "\n", 1, false);
+            break;
+
+        case CLAYKIT_KEY_Z:
+            if (ctrl) changed = shift ? ClayKit_InputRedo(s) : ClayKit_InputUndo(s);
+            break;
+
+        case CLAYKIT_KEY_Y:
+            if (ctrl) changed = ClayKit_InputRedo(s);
+            break;
+
         default:
             break;
     }
@@ -1649,26 +3797,164 @@ bool ClayKit_InputHandleKey(ClayKit_InputState *s, uint32_t key, uint32_t mods)
 }
 
 bool ClayKit_InputHandleChar(ClayKit_InputState *s, uint32_t codepoint) {
-    /* Only handle basic ASCII for now */
-    if (codepoint < 32 || codepoint > 126) return false;
+    char utf8[4];
+    uint32_t n = claykit_utf8_encode(codepoint, utf8);
+    if (n == 0) return false;
 
-    /* Delete selection first if present */
-    if (s->cursor != s->select_start) {
-        claykit_input_delete_selection(s);
+    return claykit_input_replace_selection(s, utf8, n, true);
+}
+
+void ClayKit_InputSetGapBuffer(ClayKit_InputState *s, bool enabled) {
+    if (enabled == claykit_input_is_gap(s)) return;
+    if (enabled) {
+        /* Contiguous text is a gap buffer with the gap at the end */
+        s->gap = s->len;
+        s->flags |= CLAYKIT_INPUT_GAP_BUFFER;
+    } else {
+        claykit_input_move_gap(s, s->len);
+        s->flags &= (uint8_t)~CLAYKIT_INPUT_GAP_BUFFER;
     }
+}
 
-    /* Check capacity */
-    if (s->len >= s->cap - 1) return false;
+const char* ClayKit_InputText(ClayKit_InputState *s) {
+    if (claykit_input_is_gap(s)) {
+        claykit_input_move_gap(s, s->len);
+    }
+    return s->buf;
+}
+
+uint32_t ClayKit_InputReplaceRange(ClayKit_InputState *s, uint32_t start, uint32_t end, const char *text, uint32_t len) {
+    if (end > s->len) end = s->len;
+    if (start > end) start = end;
+
+    /* Widen the range to whole codepoints */
+    while (start > 0 && start < s->len && claykit_utf8_is_cont(claykit_input_at(s, start))) start--;
+    while (end < s->len && claykit_utf8_is_cont(claykit_input_at(s, end))) end++;
 
-    /* Insert character at cursor */
-    for (uint32_t i = s->len; i > s->cursor; i--) {
-        s->buf[i] = s->buf[i - 1];
+    /* Truncate to the free space, never splitting a codepoint */
+    uint32_t room = s->cap > s->len - (end - start) ? s->cap - 1 - (s->len - (end - start)) : 0;
+    uint32_t n = len;
+    if (n > room) {
+        n = room;
+        while (n > 0 && claykit_utf8_is_cont(text[n])) n--;
     }
-    s->buf[s->cursor] = (char)codepoint;
-    s->len++;
-    s->cursor++;
+
+    /* A multi-line input also stops at the first newline without a line */
+    if (s->lines) {
+        uint32_t lines = s->lines->cap - s->lines->count + claykit_lines_at(s, end) - claykit_lines_at(s, start);
+        for (uint32_t i = 0; i < n; i++) {
+            if (text[i] == '\n' && lines-- == 0) {
+                n = i;
+                break;
+            }
+        }
+    }
+
+    claykit_input_edit(s, start, end - start, text, n, false);
+    s->cursor = start + n;
     s->select_start = s->cursor;
+    return n;
+}
+
+void ClayKit_InputSelectWord(ClayKit_InputState *s, uint32_t offset) {
+    if (offset > s->len) offset = s->len;
+    /* Prefer the run ending at offset over whitespace starting there */
+    if (offset > 0 && (offset == s->len ||
+        (claykit_char_class(claykit_input_at(s, offset)) == CLAYKIT_CLASS_SPACE &&
+         claykit_char_class(claykit_input_at(s, offset - 1)) != CLAYKIT_CLASS_SPACE))) {
+        offset--;
+    }
+    if (offset >= s->len) {
+        s->cursor = s->select_start = s->len;
+        return;
+    }
+    uint32_t cls = claykit_char_class(claykit_input_at(s, offset));
+    s->select_start = claykit_input_scan_back(s, offset, cls);
+    s->cursor = claykit_input_scan_fwd(s, offset, cls);
+}
+
+uint32_t ClayKit_InputInsertText(ClayKit_InputState *s, const char *text, uint32_t len) {
+    return ClayKit_InputReplaceRange(s,
+        claykit_min_u32(s->cursor, s->select_start),
+        claykit_max_u32(s->cursor, s->select_start),
+        text, len);
+}
 
+void ClayKit_InputSetHistory(ClayKit_InputState *s, ClayKit_InputHistory *history, void *mem, uint32_t size) {
+    s->history = history;
+    if (history) {
+        history->buf = (uint8_t *)mem;
+        history->cap = mem ? size : 0;
+        ClayKit_InputClearHistory(s);
+    }
+}
+
+void ClayKit_InputSetDelta(ClayKit_InputState *s, ClayKit_InputDelta *delta) {
+    s->delta = delta;
+    if (delta) memset(delta, 0, sizeof(*delta));
+}
+
+ClayKit_InputDelta ClayKit_InputTakeDelta(ClayKit_InputState *s) {
+    ClayKit_InputDelta d = { 0, 0, 0, 0 };
+    if (s->delta) {
+        d = *s->delta;
+        memset(s->delta, 0, sizeof(*s->delta));
+    }
+    return d;
+}
+
+void ClayKit_InputClearHistory(ClayKit_InputState *s) {
+    ClayKit_InputHistory *h = s->history;
+    if (!h) return;
+    h->start = 0;
+    h->undo_len = 0;
+    h->redo_len = 0;
+    h->open = false;
+}
+
+bool ClayKit_InputUndo(ClayKit_InputState *s) {
+    ClayKit_InputHistory *h = s->history;
+    if (!h || h->undo_len == 0) return false;
+
+    uint32_t size;
+    uint32_t hdr[5];
+    claykit_history_read(h, h->undo_len - 4, &size, 4);
+    uint32_t top = h->undo_len - size;
+    claykit_history_read(h, top, hdr, CLAYKIT_HISTORY_HEADER_SIZE);
+    if (hdr[0] + hdr[2] > s->len) {
+        /* The text was changed behind the history's back */
+        ClayKit_InputClearHistory(s);
+        return false;
+    }
+
+    /* Put the removed bytes back in place of the inserted ones */
+    claykit_history_apply(s, hdr[0], hdr[2], h, top + CLAYKIT_HISTORY_HEADER_SIZE, hdr[1]);
+    s->cursor = hdr[3];
+    s->select_start = hdr[4];
+    h->undo_len = top;
+    h->redo_len += size;
+    h->open = false;
+    return true;
+}
+
+bool ClayKit_InputRedo(ClayKit_InputState *s) {
+    ClayKit_InputHistory *h = s->history;
+    if (!h || h->redo_len == 0) return false;
+
+    uint32_t hdr[5];
+    claykit_history_read(h, h->undo_len, hdr, CLAYKIT_HISTORY_HEADER_SIZE);
+    uint32_t size = CLAYKIT_HISTORY_HEADER_SIZE + hdr[1] + hdr[2] + 4;
+    if (hdr[0] + hdr[1] > s->len) {
+        ClayKit_InputClearHistory(s);
+        return false;
+    }
+
+    claykit_history_apply(s, hdr[0], hdr[1], h, h->undo_len + CLAYKIT_HISTORY_HEADER_SIZE + hdr[1], hdr[2]);
+    s->cursor = hdr[0] + hdr[2];
+    s->select_start = s->cursor;
+    h->undo_len += size;
+    h->redo_len -= size;
+    h->open = false;
     return true;
 }
 
@@ -1681,7 +3967,7 @@ Clay_TextElementConfig ClayKit_TextStyle(ClayKit_Context *ctx, ClayKit_TextConfi
     Clay_TextElementConfig config = {0};
 
     config.fontSize = cfg.size != 0
-        ? ClayKit_GetFontSize(theme, cfg.size)
+        ? claykit_font_size(ctx, cfg.size)
         : theme->font_size.md;
 
     config.fontId = cfg.font_id != 0 ? cfg.font_id : theme->font_id.body;
@@ -1699,17 +3985,7 @@ Clay_TextElementConfig ClayKit_HeadingStyle(ClayKit_Context *ctx, ClayKit_Headin
     ClayKit_Theme *theme = ctx->theme_ptr;
     Clay_TextElementConfig config = {0};
 
-    /* Heading sizes: XL=h1 (largest), LG=h2, MD=h3, SM=h4, XS=h5/h6 */
-    uint16_t size;
-    switch (cfg.size) {
-        case CLAYKIT_SIZE_XS: size = theme->font_size.md; break;   /* h5/h6 */
-        case CLAYKIT_SIZE_SM: size = theme->font_size.lg; break;   /* h4 */
-        case CLAYKIT_SIZE_MD: size = theme->font_size.xl; break;   /* h3 */
-        case CLAYKIT_SIZE_LG: size = theme->font_size.xl + 4; break; /* h2 */
-        case CLAYKIT_SIZE_XL: size = theme->font_size.xl + 8; break; /* h1 */
-        default:              size = theme->font_size.xl; break;
-    }
-    config.fontSize = size;
+    config.fontSize = claykit_theme_tables(ctx)->heading_font_size[claykit_size_index(cfg.size)];
 
     config.fontId = cfg.font_id != 0 ? cfg.font_id : theme->font_id.heading;
 
@@ -1749,48 +4025,24 @@ static Clay_Color claykit_color_darken(Clay_Color c, float amount) {
 }
 
 uint16_t ClayKit_ButtonPaddingX(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 8;
-        case CLAYKIT_SIZE_SM: return 12;
-        case CLAYKIT_SIZE_LG: return 20;
-        case CLAYKIT_SIZE_XL: return 24;
-        case CLAYKIT_SIZE_MD:
-        default: return 16;
-    }
+    return claykit_theme_tables(ctx)->button_pad_x[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_ButtonPaddingY(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 4;
-        case CLAYKIT_SIZE_SM: return 6;
-        case CLAYKIT_SIZE_LG: return 12;
-        case CLAYKIT_SIZE_XL: return 14;
-        case CLAYKIT_SIZE_MD:
-        default: return 8;
-    }
+    return claykit_theme_tables(ctx)->button_pad_y[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_ButtonRadius(ClayKit_Context *ctx, ClayKit_Size size) {
-    ClayKit_Theme *theme = ctx->theme_ptr;
-    switch (size) {
-        case CLAYKIT_SIZE_XS:
-        case CLAYKIT_SIZE_SM: return theme->radius.sm;
-        case CLAYKIT_SIZE_LG:
-        case CLAYKIT_SIZE_XL: return theme->radius.lg;
-        case CLAYKIT_SIZE_MD:
-        default: return theme->radius.md;
-    }
+    return claykit_theme_tables(ctx)->radius[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_ButtonFontSize(ClayKit_Context *ctx, ClayKit_Size size) {
-    return ClayKit_GetFontSize(ctx->theme_ptr, size);
+    return claykit_theme_tables(ctx)->font_size[claykit_size_index(size)];
 }
 
 Clay_Color ClayKit_ButtonBgColor(ClayKit_Context *ctx, ClayKit_ButtonConfig cfg, bool hovered) {
     ClayKit_Theme *theme = ctx->theme_ptr;
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     if (cfg.disabled) {
         return theme->border;
@@ -1798,7 +4050,7 @@ Clay_Color ClayKit_ButtonBgColor(ClayKit_Context *ctx, ClayKit_ButtonConfig cfg,
 
     switch (cfg.variant) {
         case CLAYKIT_BUTTON_SOLID:
-            return hovered ? claykit_color_darken(scheme_color, 0.1f) : scheme_color;
+            return hovered ? claykit_scheme_hover(ctx, cfg.color_scheme) : scheme_color;
         case CLAYKIT_BUTTON_OUTLINE:
         case CLAYKIT_BUTTON_GHOST:
             return hovered ? claykit_color_lighten(scheme_color, 0.9f) : (Clay_Color){ 0, 0, 0, 0 };
@@ -1809,7 +4061,7 @@ Clay_Color ClayKit_ButtonBgColor(ClayKit_Context *ctx, ClayKit_ButtonConfig cfg,
 
 Clay_Color ClayKit_ButtonTextColor(ClayKit_Context *ctx, ClayKit_ButtonConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     if (cfg.disabled) {
         return theme->muted;
@@ -1830,7 +4082,7 @@ Clay_Color ClayKit_ButtonBorderColor(ClayKit_Context *ctx, ClayKit_ButtonConfig
     if (cfg.disabled || cfg.variant != CLAYKIT_BUTTON_OUTLINE) {
         return (Clay_Color){ 0, 0, 0, 0 };
     }
-    return ClayKit_GetSchemeColor(ctx->theme_ptr, cfg.color_scheme);
+    return claykit_scheme_color(ctx, cfg.color_scheme);
 }
 
 uint16_t ClayKit_ButtonBorderWidth(ClayKit_ButtonConfig cfg) {
@@ -1842,31 +4094,15 @@ uint16_t ClayKit_ButtonBorderWidth(ClayKit_ButtonConfig cfg) {
  * ---------------------------------------------------------------------------- */
 
 uint16_t ClayKit_InputPaddingX(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 6;
-        case CLAYKIT_SIZE_SM: return 8;
-        case CLAYKIT_SIZE_LG: return 14;
-        case CLAYKIT_SIZE_XL: return 16;
-        case CLAYKIT_SIZE_MD:
-        default: return 12;
-    }
+    return claykit_theme_tables(ctx)->input_pad_x[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_InputPaddingY(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 4;
-        case CLAYKIT_SIZE_SM: return 6;
-        case CLAYKIT_SIZE_LG: return 10;
-        case CLAYKIT_SIZE_XL: return 12;
-        case CLAYKIT_SIZE_MD:
-        default: return 8;
-    }
+    return claykit_theme_tables(ctx)->input_pad_y[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_InputFontSize(ClayKit_Context *ctx, ClayKit_Size size) {
-    return ClayKit_GetFontSize(ctx->theme_ptr, size);
+    return claykit_theme_tables(ctx)->font_size[claykit_size_index(size)];
 }
 
 Clay_Color ClayKit_InputBorderColor(ClayKit_Context *ctx, ClayKit_InputConfig cfg, bool focused) {
@@ -1878,7 +4114,7 @@ Clay_Color ClayKit_InputBorderColor(ClayKit_Context *ctx, ClayKit_InputConfig cf
     return (cfg.border_color.a != 0) ? cfg.border_color : theme->border;
 }
 
-ClayKit_InputStyle ClayKit_ComputeInputStyle(ClayKit_Context *ctx, ClayKit_InputConfig cfg, bool focused) {
+static ClayKit_InputStyle claykit_compute_input_style(ClayKit_Context *ctx, ClayKit_InputConfig cfg, bool focused) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_InputStyle style;
 
@@ -1914,31 +4150,736 @@ ClayKit_InputStyle ClayKit_ComputeInputStyle(ClayKit_Context *ctx, ClayKit_Input
     return style;
 }
 
+ClayKit_InputStyle ClayKit_ComputeInputStyle(ClayKit_Context *ctx, ClayKit_InputConfig cfg, bool focused) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_InputStyle, CLAYKIT_STYLE_INPUT, focused, cfg,
+                         claykit_compute_input_style(ctx, cfg, focused));
+}
+
+void ClayKit_RegisterFontMetrics(ClayKit_Context *ctx, ClayKit_FontMetrics *metrics) {
+    /* Unlink any table already registered for this font and size */
+    ClayKit_FontMetrics **link = &ctx->font_metrics;
+    while (*link) {
+        if (*link != metrics && ((*link)->font_id != metrics->font_id || (*link)->font_size != metrics->font_size)) {
+            link = &(*link)->next;
+        } else {
+            *link = (*link)->next;
+        }
+    }
+    metrics->next = ctx->font_metrics;
+    ctx->font_metrics = metrics;
+}
+
+static const ClayKit_FontMetrics* claykit_font_metrics(const ClayKit_Context *ctx, uint16_t font_id, uint16_t font_size) {
+    for (const ClayKit_FontMetrics *m = ctx->font_metrics; m; m = m->next) {
+        if (m->font_id == font_id && m->font_size == font_size) return m;
+    }
+    return NULL;
+}
+
+static bool claykit_can_measure(const ClayKit_Context *ctx, uint16_t font_id, uint16_t font_size) {
+    return ctx->measure_text != NULL || ctx->measure_text_batch != NULL ||
+           claykit_font_metrics(ctx, font_id, font_size) != NULL;
+}
+
+/* Decodes the codepoint at p[0..n), n > 0. Returns its byte count; a
+ * malformed sequence decodes as U+FFFD, one byte at a time. */
+static uint32_t claykit_utf8_decode(const char *p, uint32_t n, uint32_t *cp) {
+    unsigned char c = (unsigned char)p[0];
+    uint32_t len = c < 0xC0 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    if (c >= 0x80 && (c < 0xC0 || len > n)) {
+        *cp = 0xFFFD;
+        return 1;
+    }
+    uint32_t v = len == 1 ? c : c & (0x7Fu >> len);
+    for (uint32_t k = 1; k < len; k++) {
+        if (!claykit_utf8_is_cont(p[k])) {
+            *cp = 0xFFFD;
+            return 1;
+        }
+        v = (v << 6) | ((unsigned char)p[k] & 0x3F);
+    }
+    *cp = v;
+    return len;
+}
+
+static float claykit_metrics_advance(const ClayKit_FontMetrics *m, uint32_t cp) {
+    return cp - m->first < m->count ? m->advances[cp - m->first] : m->fallback;
+}
+
+static float claykit_metrics_kerning(const ClayKit_FontMetrics *m, uint32_t left, uint32_t right) {
+    uint32_t lo = 0;
+    uint32_t hi = m->kerning_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const ClayKit_KerningPair *k = &m->kerning[mid];
+        if (k->left < left || (k->left == left && k->right < right)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < m->kerning_count && m->kerning[lo].left == left && m->kerning[lo].right == right) {
+        return m->kerning[lo].amount;
+    }
+    return 0.0f;
+}
+
+/* Sums advances plus kerning. Runs of ASCII go four bytes per step into
+ * independent sums, so the loads and adds overlap instead of forming one
+ * dependency chain. */
+static float claykit_metrics_width(const ClayKit_FontMetrics *m, const char *text, uint32_t length) {
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    uint32_t i = 0;
+    while (i < length) {
+        for (; i + 4 <= length; i += 4) {
+            uint32_t w;
+            memcpy(&w, text + i, 4);
+            if (w & 0x80808080u) break;
+            sum[0] += claykit_metrics_advance(m, (uint8_t)text[i]);
+            sum[1] += claykit_metrics_advance(m, (uint8_t)text[i + 1]);
+            sum[2] += claykit_metrics_advance(m, (uint8_t)text[i + 2]);
+            sum[3] += claykit_metrics_advance(m, (uint8_t)text[i + 3]);
+        }
+        if (i >= length) break;
+        uint32_t cp;
+        i += claykit_utf8_decode(text + i, length - i, &cp);
+        sum[0] += claykit_metrics_advance(m, cp);
+    }
+
+    if (m->kerning_count > 0) {
+        uint32_t prev;
+        i = claykit_utf8_decode(text, length, &prev);
+        while (i < length) {
+            uint32_t cp;
+            i += claykit_utf8_decode(text + i, length - i, &cp);
+            sum[1] += claykit_metrics_kerning(m, prev, cp);
+            prev = cp;
+        }
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+static double claykit_measure_clock(const ClayKit_Context *ctx) {
+    return ctx->measure_clock ? ctx->measure_clock() : 0.0;
+}
+
+static void claykit_measure_count(ClayKit_Context *ctx, uint32_t calls, uint32_t texts, uint64_t bytes, double seconds) {
+    ClayKit_MeasureStats *all[2] = { &ctx->stats.measure_frame, &ctx->stats.measure };
+    for (int i = 0; i < 2; i++) {
+        all[i]->calls += calls;
+        all[i]->texts += texts;
+        all[i]->bytes += bytes;
+        all[i]->seconds += seconds;
+    }
+}
+
+/* Measures with the font's registered metrics, else measure_text, else
+ * measure_text_batch, else returns a zero width */
+static ClayKit_TextDimensions claykit_measure(ClayKit_Context *ctx, const char *text, uint32_t length,
+                                              uint16_t font_id, uint16_t font_size) {
+    ClayKit_TextDimensions dims = { 0.0f, (float)font_size };
+    if (length == 0) {
+        return dims;
+    }
+    const ClayKit_FontMetrics *m = claykit_font_metrics(ctx, font_id, font_size);
+    if (m != NULL) {
+        dims.width = claykit_metrics_width(m, text, length);
+        claykit_measure_count(ctx, 0, 1, length, 0.0);
+    } else if (ctx->measure_text != NULL || ctx->measure_text_batch != NULL) {
+        double start = claykit_measure_clock(ctx);
+        if (ctx->measure_text != NULL) {
+            dims = ctx->measure_text(text, length, font_id, font_size, ctx->measure_text_user_data);
+        } else {
+            ClayKit_MeasureRequest req = { text, length, font_id, font_size };
+            ctx->measure_text_batch(&req, &dims, 1, ctx->measure_text_batch_user_data);
+        }
+        claykit_measure_count(ctx, 1, 1, length, claykit_measure_clock(ctx) - start);
+    }
+    return dims;
+}
+
+/* True if text in this font goes to measure_text_batch, so callers gain
+ * from gathering their measurements into batches */
+static bool claykit_measure_batched(const ClayKit_Context *ctx, uint16_t font_id, uint16_t font_size) {
+    return ctx->measure_text_batch != NULL && claykit_font_metrics(ctx, font_id, font_size) == NULL;
+}
+
+void ClayKit_SetMeasureTextBatch(ClayKit_Context *ctx, ClayKit_MeasureTextBatchCallback callback, void *user_data) {
+    ctx->measure_text_batch = callback;
+    ctx->measure_text_batch_user_data = user_data;
+}
+
+void ClayKit_MeasureTextBatch(ClayKit_Context *ctx, const ClayKit_MeasureRequest *requests,
+                              ClayKit_TextDimensions *out, uint32_t count) {
+    uint32_t i = 0;
+    while (i < count) {
+        /* Consecutive requests the metrics can't answer go out in one call */
+        uint32_t end = i;
+        while (end < count && requests[end].length > 0 &&
+               claykit_measure_batched(ctx, requests[end].font_id, requests[end].font_size)) {
+            end++;
+        }
+        if (end > i) {
+            uint64_t bytes = 0;
+            for (uint32_t k = i; k < end; k++) bytes += requests[k].length;
+            double start = claykit_measure_clock(ctx);
+            ctx->measure_text_batch(requests + i, out + i, end - i, ctx->measure_text_batch_user_data);
+            claykit_measure_count(ctx, 1, end - i, bytes, claykit_measure_clock(ctx) - start);
+            i = end;
+        } else {
+            out[i] = claykit_measure(ctx, requests[i].text, requests[i].length,
+                                     requests[i].font_id, requests[i].font_size);
+            i++;
+        }
+    }
+}
+
 float ClayKit_MeasureTextWidth(ClayKit_Context *ctx, const char *text, uint32_t length, uint16_t font_id, uint16_t font_size) {
-    if (ctx->measure_text == NULL || length == 0) {
+    return claykit_measure(ctx, text, length, font_id, font_size).width;
+}
+
+void ClayKit_SetMeasureText(ClayKit_Context *ctx, ClayKit_MeasureTextCallback callback, void *user_data) {
+    ctx->measure_text = callback;
+    ctx->measure_text_user_data = user_data;
+    if (Clay_GetCurrentContext() != NULL) {
+        Clay_SetMeasureTextFunction(ClayKit_ClayMeasureText, ctx);
+    }
+}
+
+Clay_Dimensions ClayKit_ClayMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *user_data) {
+    ClayKit_Context *ctx = (ClayKit_Context *)user_data;
+    uint32_t length = text.length > 0 ? (uint32_t)text.length : 0;
+    ClayKit_TextDimensions dims = claykit_measure(ctx, text.chars, length, config->fontId, config->fontSize);
+
+#ifdef CLAY__MAXFLOAT
+    /* On a cache miss Clay first measures a lone space for its space width.
+     * Words never contain spaces, so that call marks one miss. The final
+     * layout in Clay_EndLayout measures the same space again for wrapped
+     * text. Clay_BeginLayout leaves two entries on the open-element stack
+     * and Clay_EndLayout pops one before the final layout, so more than one
+     * entry means the UI is still being declared. */
+    if (length == 1 && text.chars[0] == ' ' && text.chars == text.baseChars &&
+        Clay_GetCurrentContext()->openLayoutElementStack.length > 1) {
+        ctx->stats.measure_frame.clay_misses++;
+        ctx->stats.measure.clay_misses++;
+    }
+#endif
+
+    /* Clay expects letter spacing after every codepoint and removes the
+     * trailing one from each line itself */
+    if (config->letterSpacing > 0) {
+        uint32_t codepoints = 0;
+        for (uint32_t i = 0; i < length; i++) {
+            codepoints += !claykit_utf8_is_cont(text.chars[i]);
+        }
+        dims.width += (float)config->letterSpacing * (float)codepoints;
+    }
+    Clay_Dimensions d = { dims.width, dims.height };
+    return d;
+}
+
+/* ClayKit_InputGetCursorFromX with a batch callback. Each round measures
+ * up to CLAYKIT_MEASURE_BATCH prefixes spread evenly over (lo, hi) in one
+ * call and keeps the two around x_offset, so a short text takes about
+ * log16(length) calls rather than log2(length). Every prefix is measured
+ * from the start, so a round is limited to about 64 bytes per request;
+ * past that, measuring costs more than the calls saved and long texts get
+ * one prefix per round, as in a binary search. */
+static uint32_t claykit_cursor_from_x_batched(ClayKit_Context *ctx, const char *text, uint32_t length,
+                                              uint16_t font_id, uint16_t font_size, float x_offset) {
+    ClayKit_MeasureRequest req[CLAYKIT_MEASURE_BATCH];
+    ClayKit_TextDimensions dims[CLAYKIT_MEASURE_BATCH];
+    uint32_t lo = 0;
+    uint32_t hi = length;
+    float lo_width = 0.0f;
+    float hi_width = 0.0f;
+    bool hi_known = false;
+
+    for (;;) {
+        /* The first round also measures the whole text */
+        uint32_t splits = hi_known ? CLAYKIT_MEASURE_BATCH : CLAYKIT_MEASURE_BATCH - 1;
+        uint32_t budget = (CLAYKIT_MEASURE_BATCH * 64) / hi;
+        if (splits > budget) splits = budget > 0 ? budget : 1;
+        uint32_t n = 0;
+        uint32_t last = lo;
+        for (uint32_t k = 1; k <= splits; k++) {
+            uint32_t p = lo + (uint32_t)((uint64_t)(hi - lo) * k / (splits + 1));
+            while (p > last && claykit_utf8_is_cont(text[p])) p--;
+            if (p == last) {
+                /* No boundary below; take the next one up */
+                p++;
+                while (p < hi && claykit_utf8_is_cont(text[p])) p++;
+                if (p >= hi) break;
+            }
+            req[n].text = text;
+            req[n].length = p;
+            req[n].font_id = font_id;
+            req[n].font_size = font_size;
+            n++;
+            last = p;
+        }
+        if (!hi_known) {
+            req[n].text = text;
+            req[n].length = length;
+            req[n].font_id = font_id;
+            req[n].font_size = font_size;
+            n++;
+        } else if (n == 0) {
+            break;  /* lo and hi are adjacent boundaries */
+        }
+        ClayKit_MeasureTextBatch(ctx, req, dims, n);
+        if (!hi_known) {
+            hi_known = true;
+            hi_width = dims[--n].width;
+            if (x_offset > hi_width) {
+                return length;
+            }
+        }
+
+        uint32_t k = 0;
+        while (k < n && dims[k].width < x_offset) k++;
+        if (k > 0) {
+            lo = req[k - 1].length;
+            lo_width = dims[k - 1].width;
+        }
+        if (k < n) {
+            hi = req[k].length;
+            hi_width = dims[k].width;
+        }
+    }
+
+    /* Pick whichever boundary the click is closer to */
+    return x_offset < (lo_width + hi_width) / 2.0f ? lo : hi;
+}
+
+uint32_t ClayKit_InputGetCursorFromX(ClayKit_Context *ctx, const char *text, uint32_t length, uint16_t font_id, uint16_t font_size, float x_offset) {
+    if (!claykit_can_measure(ctx, font_id, font_size) || length == 0 || x_offset <= 0) {
+        return 0;
+    }
+    if (claykit_measure_batched(ctx, font_id, font_size)) {
+        return claykit_cursor_from_x_batched(ctx, text, length, font_id, font_size, x_offset);
+    }
+
+    /* Prefix widths grow with length, so binary search for the pair of
+     * adjacent codepoint boundaries lo < hi with width(lo) < x <= width(hi) */
+    uint32_t lo = 0;
+    uint32_t hi = length;
+    float lo_width = 0.0f;
+    float hi_width = ClayKit_MeasureTextWidth(ctx, text, length, font_id, font_size);
+    if (x_offset > hi_width) {
+        return length;
+    }
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        while (mid > lo && claykit_utf8_is_cont(text[mid])) mid--;
+        if (mid == lo) {
+            mid = lo + (hi - lo) / 2;
+            while (mid < hi && claykit_utf8_is_cont(text[mid])) mid++;
+            if (mid == hi) break;
+        }
+        float width = ClayKit_MeasureTextWidth(ctx, text, mid, font_id, font_size);
+        if (width < x_offset) {
+            lo = mid;
+            lo_width = width;
+        } else {
+            hi = mid;
+            hi_width = width;
+        }
+    }
+
+    /* Pick whichever boundary the click is closer to */
+    return x_offset < (lo_width + hi_width) / 2.0f ? lo : hi;
+}
+
+/* ----------------------------------------------------------------------------
+ * Text truncation
+ * ---------------------------------------------------------------------------- */
+
+/* Width of text[0..length) on one Clay line: letter spacing follows every
+ * codepoint but the last */
+static float claykit_line_width(ClayKit_Context *ctx, const char *text, uint32_t length,
+                                Clay_TextElementConfig config) {
+    if (length == 0) return 0.0f;
+    float width = ClayKit_MeasureTextWidth(ctx, text, length, config.fontId, config.fontSize);
+    if (config.letterSpacing > 0) {
+        uint32_t codepoints = 0;
+        for (uint32_t i = 0; i < length; i++) {
+            codepoints += !claykit_utf8_is_cont(text[i]);
+        }
+        width += (float)config.letterSpacing * (float)(codepoints - 1);
+    }
+    return width;
+}
+
+uint32_t ClayKit_TruncateText(ClayKit_Context *ctx, const char *text, uint32_t length,
+                              Clay_TextElementConfig config, float max_width) {
+    if (length == 0 || !claykit_can_measure(ctx, config.fontId, config.fontSize)) {
+        return length;
+    }
+
+    /* Double a prefix until it overflows, so a long text is measured only
+     * about twice as far as it can be seen */
+    uint32_t hi = 64;
+    for (;;) {
+        while (hi < length && claykit_utf8_is_cont(text[hi])) hi++;
+        if (hi >= length) {
+            if (claykit_line_width(ctx, text, length, config) <= max_width) {
+                return length;
+            }
+            hi = length;
+            break;
+        }
+        if (claykit_line_width(ctx, text, hi, config) > max_width) break;
+        hi = hi > length / 2 ? length : hi * 2;
+    }
+
+    /* Binary search the longest prefix lo < hi that leaves room for the
+     * ellipsis, and the letter spacing between the two */
+    const uint32_t ellipsis_len = (uint32_t)sizeof(CLAYKIT_ELLIPSIS) - 1;
+    float room = max_width - (float)config.letterSpacing -
+                 claykit_line_width(ctx, CLAYKIT_ELLIPSIS, ellipsis_len, config);
+    uint32_t lo = 0;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        while (mid > lo && claykit_utf8_is_cont(text[mid])) mid--;
+        if (mid == lo) {
+            mid = lo + (hi - lo) / 2;
+            while (mid < hi && claykit_utf8_is_cont(text[mid])) mid++;
+            if (mid == hi) break;
+        }
+        if (claykit_line_width(ctx, text, mid, config) <= room) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    while (lo > 0 && text[lo - 1] == ' ') lo--;
+    return lo;
+}
+
+/* Opens a growing element and emits text into it, cut to the element's
+ * width in the previous frame. The text sits in a 1 px wide holder, so it
+ * never sets the element's minimum width and the element can still shrink
+ * with its parent. A clip would do the same, but Clay tracks only a few
+ * clip elements per layout. */
+static bool claykit_text_truncated(ClayKit_Context *ctx, Clay_ElementId id,
+                                   const char *text, uint32_t length,
+                                   Clay_TextElementConfig config) {
+    Clay_ElementDeclaration decl = {0};
+    decl.id = id;
+    decl.layout.sizing.width.type = CLAY__SIZING_TYPE_GROW;
+    decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIT;
+
+    Clay_ElementDeclaration holder = {0};
+    holder.layout.sizing.width.type = CLAY__SIZING_TYPE_FIT;
+    holder.layout.sizing.width.size.minMax.max = 1.0f;
+    holder.layout.sizing.height.type = CLAY__SIZING_TYPE_FIT;
+
+    /* Look up before opening: an element seen for the first time is added
+     * to Clay's map with an empty box as soon as it is configured */
+    Clay_ElementData prev = Clay_GetElementData(id);
+    float width = prev.found ? prev.boundingBox.width : CLAYKIT_TRUNCATE_INITIAL_WIDTH;
+
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(decl);
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(holder);
+
+    uint32_t cut = ClayKit_TruncateText(ctx, text, length, config, width);
+
+    Clay_String str = { false, (int32_t)cut, text };
+    if (cut == 0 && length > 0) {
+        str.chars = CLAYKIT_ELLIPSIS;
+        str.length = (int32_t)sizeof(CLAYKIT_ELLIPSIS) - 1;
+    } else if (cut < length) {
+        /* Without arena room the prefix is still emitted, just clipped
+         * without the ellipsis */
+        const uint32_t ellipsis_len = (uint32_t)sizeof(CLAYKIT_ELLIPSIS) - 1;
+        char *buf = (char *)ClayKit_FrameAlloc(ctx, cut + ellipsis_len, 1);
+        if (buf) {
+            memcpy(buf, text, cut);
+            memcpy(buf + cut, CLAYKIT_ELLIPSIS, ellipsis_len);
+            str.chars = buf;
+            str.length = (int32_t)(cut + ellipsis_len);
+        }
+    }
+
+    if (str.length > 0) {
+        config.wrapMode = CLAY_TEXT_WRAP_NONE;
+        Clay__OpenTextElement(str, Clay__StoreTextElementConfig(config));
+    }
+    Clay__CloseElement();
+    Clay__CloseElement();
+    return cut < length;
+}
+
+bool ClayKit_TextTruncated(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                           const char *text, int32_t text_len, Clay_TextElementConfig config) {
+    Clay_String id_str = { false, id_len, id };
+    uint32_t length = text_len > 0 ? (uint32_t)text_len : 0;
+    return claykit_text_truncated(ctx, Clay__HashString(id_str, 0, 0), text, length, config);
+}
+
+void ClayKit_InputSetAdvanceCache(ClayKit_InputState *s, ClayKit_InputAdvanceCache *cache, float *mem, uint32_t count) {
+    s->advances = cache;
+    if (cache) {
+        cache->x = mem;
+        cache->cap = mem ? count : 0;
+        cache->valid = cache->cap > 0 ? 1 : 0;
+        cache->font_id = 0;
+        cache->font_size = 0;
+        if (cache->cap > 0) cache->x[0] = 0.0f;
+    }
+}
+
+bool ClayKit_InputSetLineIndex(ClayKit_InputState *s, ClayKit_InputLineIndex *index, uint32_t *mem, uint32_t count) {
+    s->lines = NULL;
+    if (!index || !mem || count == 0) return index == NULL;
+    index->starts = mem;
+    index->cap = count;
+    index->page = 0;
+    s->lines = index;
+    if (!claykit_lines_rebuild(s)) {
+        s->lines = NULL;
+        return false;
+    }
+    return true;
+}
+
+uint32_t ClayKit_InputLineCount(const ClayKit_InputState *s) {
+    return s->lines ? s->lines->count : 1;
+}
+
+uint32_t ClayKit_InputLineAt(const ClayKit_InputState *s, uint32_t offset) {
+    return s->lines ? claykit_lines_at(s, offset) : 0;
+}
+
+uint32_t ClayKit_InputLineStart(const ClayKit_InputState *s, uint32_t line) {
+    if (!s->lines || line == 0) return 0;
+    if (line >= s->lines->count) line = s->lines->count - 1;
+    return claykit_lines_get(s, line);
+}
+
+uint32_t ClayKit_InputLineEnd(const ClayKit_InputState *s, uint32_t line) {
+    if (!s->lines) return s->len;
+    if (line >= s->lines->count) line = s->lines->count - 1;
+    return claykit_lines_end(s, line);
+}
+
+/* Returns the input's advance cache ready for the given font, or NULL if
+ * there is none or the text doesn't fit in it */
+static ClayKit_InputAdvanceCache* claykit_advances_for(ClayKit_InputState *s, uint16_t font_id, uint16_t font_size) {
+    ClayKit_InputAdvanceCache *c = s->advances;
+    if (c == NULL || c->cap <= s->len) return NULL;
+    if (c->font_id != font_id || c->font_size != font_size) {
+        c->font_id = font_id;
+        c->font_size = font_size;
+        c->valid = 1;
+    }
+    return c;
+}
+
+/* Codepoint boundaries for the advance cache. Malformed text can have
+ * longer runs of continuation bytes; they are measured 4 bytes at a time. */
+static uint32_t claykit_advance_prev(const ClayKit_InputState *s, uint32_t i) {
+    uint32_t start = claykit_input_prev_boundary(s, i);
+    return i - start > 4 ? i - 4 : start;
+}
+
+static uint32_t claykit_advance_next(const ClayKit_InputState *s, uint32_t i) {
+    uint32_t next = claykit_input_next_boundary(s, i);
+    return next - i > 4 ? i + 4 : next;
+}
+
+/* claykit_advances_fill with a batch callback. Codepoints are gathered in
+ * chunks, copied next to each other so every codepoint and every adjacent
+ * pair is a slice of one buffer, and a chunk is measured in one call. A
+ * chunk may run past until or x, which only fills the cache further. */
+static void claykit_advances_fill_batched(ClayKit_Context *ctx, ClayKit_InputState *s, uint32_t until, float x) {
+    ClayKit_InputAdvanceCache *c = s->advances;
+    ClayKit_MeasureRequest req[CLAYKIT_MEASURE_BATCH];
+    ClayKit_TextDimensions dims[CLAYKIT_MEASURE_BATCH];
+    char bytes[(CLAYKIT_MEASURE_BATCH / 2 + 2) * 4];
+    uint32_t i = c->valid - 1;
+    float prev_width = 0.0f;
+    bool have_prev_width = false;
+
+    while (i < until && c->x[i] < x) {
+        uint32_t start = i > 0 ? claykit_advance_prev(s, i) : 0;
+        uint32_t used = 0;
+        uint32_t n = 0;
+        for (uint32_t k = start; k < i; k++) bytes[used++] = claykit_input_at(s, k);
+        if (used > 0 && !have_prev_width) {
+            req[n].text = bytes;
+            req[n].length = used;
+            n++;
+        }
+
+        /* One request for each codepoint, one for it with the one before */
+        uint32_t prev_off = 0;
+        uint32_t prev_len = used;
+        uint32_t end = i;
+        while (end < s->len && n + 2 <= CLAYKIT_MEASURE_BATCH) {
+            uint32_t next = claykit_advance_next(s, end);
+            uint32_t cur_off = used;
+            for (uint32_t k = end; k < next; k++) bytes[used++] = claykit_input_at(s, k);
+            req[n].text = bytes + cur_off;
+            req[n].length = next - end;
+            n++;
+            if (prev_len > 0) {
+                req[n].text = bytes + prev_off;
+                req[n].length = prev_len + (next - end);
+                n++;
+            }
+            prev_off = cur_off;
+            prev_len = next - end;
+            end = next;
+        }
+        for (uint32_t k = 0; k < n; k++) {
+            req[k].font_id = c->font_id;
+            req[k].font_size = c->font_size;
+        }
+        ClayKit_MeasureTextBatch(ctx, req, dims, n);
+
+        uint32_t r = 0;
+        if (i > start && !have_prev_width) {
+            prev_width = dims[r++].width;
+        }
+        bool has_prev = i > start;
+        while (i < end) {
+            uint32_t next = claykit_advance_next(s, i);
+            float width = dims[r++].width;
+            float advance = has_prev ? dims[r++].width - prev_width : width;
+
+            /* Offsets inside a codepoint repeat the width before it */
+            for (uint32_t k = i + 1; k < next; k++) c->x[k] = c->x[i];
+            c->x[next] = c->x[i] + advance;
+            prev_width = width;
+            has_prev = true;
+            i = next;
+        }
+        have_prev_width = true;
+    }
+    c->valid = i + 1;
+}
+
+/* Extends the cached prefix widths up to byte offset until, stopping early
+ * once they reach x. Each codepoint's advance is measured together with the
+ * one before it, so letter spacing and kerning pairs are accounted for
+ * without ever measuring a long prefix. */
+static void claykit_advances_fill(ClayKit_Context *ctx, ClayKit_InputState *s, uint32_t until, float x) {
+    ClayKit_InputAdvanceCache *c = s->advances;
+    uint32_t i = c->valid - 1;
+    if (i >= until || c->x[i] >= x) return;
+    if (claykit_measure_batched(ctx, c->font_id, c->font_size)) {
+        claykit_advances_fill_batched(ctx, s, until, x);
+        return;
+    }
+
+    char pair[8];
+    uint32_t prev_len = 0;
+    float prev_width = 0.0f;
+    if (i > 0) {
+        uint32_t start = claykit_advance_prev(s, i);
+        prev_len = i - start;
+        for (uint32_t k = 0; k < prev_len; k++) pair[k] = claykit_input_at(s, start + k);
+        prev_width = ClayKit_MeasureTextWidth(ctx, pair, prev_len, c->font_id, c->font_size);
+    }
+
+    while (i < until && c->x[i] < x) {
+        uint32_t next = claykit_advance_next(s, i);
+        uint32_t cur_len = next - i;
+        for (uint32_t k = 0; k < cur_len; k++) pair[prev_len + k] = claykit_input_at(s, i + k);
+
+        float width = ClayKit_MeasureTextWidth(ctx, pair + prev_len, cur_len, c->font_id, c->font_size);
+        float advance = prev_len > 0
+            ? ClayKit_MeasureTextWidth(ctx, pair, prev_len + cur_len, c->font_id, c->font_size) - prev_width
+            : width;
+
+        /* Offsets inside a codepoint repeat the width before it */
+        for (uint32_t k = i + 1; k < next; k++) c->x[k] = c->x[i];
+        c->x[next] = c->x[i] + advance;
+
+        memmove(pair, pair + prev_len, cur_len);
+        prev_len = cur_len;
+        prev_width = width;
+        i = next;
+    }
+    c->valid = i + 1;
+}
+
+/* Codepoint boundary in [start, end] closest to x_offset, measured from
+ * start. With an advance cache the widths are relative to the cached width
+ * at start, so lines of a multi-line text share one table. */
+static uint32_t claykit_input_hit_range(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size,
+                                        uint32_t start, uint32_t end, float x_offset) {
+    if (!claykit_can_measure(ctx, font_id, font_size) || end <= start || x_offset <= 0) {
+        return start;
+    }
+
+    ClayKit_InputAdvanceCache *c = claykit_advances_for(s, font_id, font_size);
+    if (c == NULL) {
+        return start + ClayKit_InputGetCursorFromX(ctx, claykit_input_span(s, start, end), end - start,
+                                                   font_id, font_size, x_offset);
+    }
+
+    claykit_advances_fill(ctx, s, start, 3.4e38f);
+    float x = c->x[start] + x_offset;
+    claykit_advances_fill(ctx, s, end, x);
+    uint32_t lo = start;
+    uint32_t hi = c->valid - 1 < end ? c->valid - 1 : end;
+    if (c->x[hi] < x) {
+        return hi;
+    }
+
+    /* First offset whose width reaches x. Offsets inside a codepoint repeat
+     * the width before it, so this is always a codepoint boundary. */
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (c->x[mid] < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    uint32_t prev = claykit_input_prev_boundary(s, lo);
+    return x < (c->x[prev] + c->x[lo]) / 2.0f ? prev : lo;
+}
+
+uint32_t ClayKit_InputHitTest(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size, float x_offset) {
+    return claykit_input_hit_range(ctx, s, font_id, font_size, 0, s->len, x_offset);
+}
+
+float ClayKit_InputOffsetX(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size, uint32_t offset) {
+    if (offset > s->len) offset = s->len;
+    ClayKit_InputAdvanceCache *c = claykit_advances_for(s, font_id, font_size);
+    if (c == NULL) {
+        return ClayKit_MeasureTextWidth(ctx, ClayKit_InputText(s), offset, font_id, font_size);
+    }
+    if (!claykit_can_measure(ctx, font_id, font_size)) {
         return 0.0f;
     }
-    ClayKit_TextDimensions dims = ctx->measure_text(text, length, font_id, font_size, ctx->measure_text_user_data);
-    return dims.width;
+    claykit_advances_fill(ctx, s, offset, 3.4e38f);
+    return c->x[offset];
 }
 
-uint32_t ClayKit_InputGetCursorFromX(ClayKit_Context *ctx, const char *text, uint32_t length, uint16_t font_id, uint16_t font_size, float x_offset) {
-    if (ctx->measure_text == NULL || length == 0 || x_offset <= 0) {
-        return 0;
+/* Last codepoint boundary whose x is at most x */
+static uint32_t claykit_input_floor_x(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size, float x) {
+    uint32_t i = ClayKit_InputHitTest(ctx, s, font_id, font_size, x);
+    if (i > 0 && ClayKit_InputOffsetX(ctx, s, font_id, font_size, i) > x) {
+        i = claykit_input_prev_boundary(s, i);
     }
+    return i;
+}
 
-    /* Binary search would be more efficient, but linear is simpler and text inputs are usually short */
-    float prev_width = 0.0f;
-    for (uint32_t i = 1; i <= length; i++) {
-        float width = ClayKit_MeasureTextWidth(ctx, text, i, font_id, font_size);
-        /* Check if click is closer to this position or the previous one */
-        float mid = (prev_width + width) / 2.0f;
-        if (x_offset < mid) {
-            return i - 1;
-        }
-        prev_width = width;
+/* First codepoint boundary whose x is at least x */
+static uint32_t claykit_input_ceil_x(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t font_id, uint16_t font_size, float x) {
+    uint32_t i = ClayKit_InputHitTest(ctx, s, font_id, font_size, x);
+    if (i < s->len && ClayKit_InputOffsetX(ctx, s, font_id, font_size, i) < x) {
+        i = claykit_input_next_boundary(s, i);
     }
-    return length;
+    return i;
 }
 
 /* ----------------------------------------------------------------------------
@@ -1946,15 +4887,7 @@ uint32_t ClayKit_InputGetCursorFromX(ClayKit_Context *ctx, const char *text, uin
  * ---------------------------------------------------------------------------- */
 
 uint16_t ClayKit_CheckboxSize(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 14;
-        case CLAYKIT_SIZE_SM: return 16;
-        case CLAYKIT_SIZE_LG: return 22;
-        case CLAYKIT_SIZE_XL: return 26;
-        case CLAYKIT_SIZE_MD:
-        default: return 18;
-    }
+    return claykit_theme_tables(ctx)->checkbox_size[claykit_size_index(size)];
 }
 
 Clay_Color ClayKit_CheckboxBgColor(ClayKit_Context *ctx, ClayKit_CheckboxConfig cfg, bool checked, bool hovered) {
@@ -1964,10 +4897,10 @@ Clay_Color ClayKit_CheckboxBgColor(ClayKit_Context *ctx, ClayKit_CheckboxConfig
         return checked ? theme->muted : theme->border;
     }
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     if (checked) {
-        return hovered ? claykit_color_darken(scheme_color, 0.1f) : scheme_color;
+        return hovered ? claykit_scheme_hover(ctx, cfg.color_scheme) : scheme_color;
     }
 
     return hovered ? claykit_color_lighten(scheme_color, 0.95f) : theme->bg;
@@ -1981,7 +4914,7 @@ Clay_Color ClayKit_CheckboxBorderColor(ClayKit_Context *ctx, ClayKit_CheckboxCon
     }
 
     if (checked) {
-        return ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+        return claykit_scheme_color(ctx, cfg.color_scheme);
     }
 
     return theme->border;
@@ -2003,10 +4936,10 @@ Clay_Color ClayKit_RadioBgColor(ClayKit_Context *ctx, ClayKit_RadioConfig cfg, b
         return selected ? theme->muted : theme->border;
     }
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     if (selected) {
-        return hovered ? claykit_color_darken(scheme_color, 0.1f) : scheme_color;
+        return hovered ? claykit_scheme_hover(ctx, cfg.color_scheme) : scheme_color;
     }
 
     return hovered ? claykit_color_lighten(scheme_color, 0.95f) : theme->bg;
@@ -2020,7 +4953,7 @@ Clay_Color ClayKit_RadioBorderColor(ClayKit_Context *ctx, ClayKit_RadioConfig cf
     }
 
     if (selected) {
-        return ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+        return claykit_scheme_color(ctx, cfg.color_scheme);
     }
 
     return theme->border;
@@ -2031,39 +4964,15 @@ Clay_Color ClayKit_RadioBorderColor(ClayKit_Context *ctx, ClayKit_RadioConfig cf
  * ---------------------------------------------------------------------------- */
 
 uint16_t ClayKit_SwitchWidth(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 28;
-        case CLAYKIT_SIZE_SM: return 34;
-        case CLAYKIT_SIZE_LG: return 50;
-        case CLAYKIT_SIZE_XL: return 58;
-        case CLAYKIT_SIZE_MD:
-        default: return 42;
-    }
+    return claykit_theme_tables(ctx)->switch_width[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_SwitchHeight(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 16;
-        case CLAYKIT_SIZE_SM: return 20;
-        case CLAYKIT_SIZE_LG: return 28;
-        case CLAYKIT_SIZE_XL: return 32;
-        case CLAYKIT_SIZE_MD:
-        default: return 24;
-    }
+    return claykit_theme_tables(ctx)->switch_height[claykit_size_index(size)];
 }
 
 uint16_t ClayKit_SwitchKnobSize(ClayKit_Context *ctx, ClayKit_Size size) {
-    (void)ctx;
-    switch (size) {
-        case CLAYKIT_SIZE_XS: return 12;
-        case CLAYKIT_SIZE_SM: return 16;
-        case CLAYKIT_SIZE_LG: return 24;
-        case CLAYKIT_SIZE_XL: return 28;
-        case CLAYKIT_SIZE_MD:
-        default: return 20;
-    }
+    return claykit_theme_tables(ctx)->switch_knob_size[claykit_size_index(size)];
 }
 
 Clay_Color ClayKit_SwitchBgColor(ClayKit_Context *ctx, ClayKit_SwitchConfig cfg, bool on, bool hovered) {
@@ -2073,10 +4982,10 @@ Clay_Color ClayKit_SwitchBgColor(ClayKit_Context *ctx, ClayKit_SwitchConfig cfg,
         return on ? theme->muted : theme->border;
     }
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     if (on) {
-        return hovered ? claykit_color_darken(scheme_color, 0.1f) : scheme_color;
+        return hovered ? claykit_scheme_hover(ctx, cfg.color_scheme) : scheme_color;
     }
 
     return hovered ? claykit_color_darken(theme->border, 0.05f) : theme->border;
@@ -2086,9 +4995,9 @@ Clay_Color ClayKit_SwitchBgColor(ClayKit_Context *ctx, ClayKit_SwitchConfig cfg,
  * Badge
  * ---------------------------------------------------------------------------- */
 
-ClayKit_BadgeStyle ClayKit_ComputeBadgeStyle(ClayKit_Context *ctx, ClayKit_BadgeConfig cfg) {
+static ClayKit_BadgeStyle claykit_compute_badge_style(ClayKit_Context *ctx, ClayKit_BadgeConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
     ClayKit_BadgeStyle style;
 
     /* Determine padding based on size */
@@ -2139,6 +5048,11 @@ ClayKit_BadgeStyle ClayKit_ComputeBadgeStyle(ClayKit_Context *ctx, ClayKit_Badge
     return style;
 }
 
+ClayKit_BadgeStyle ClayKit_ComputeBadgeStyle(ClayKit_Context *ctx, ClayKit_BadgeConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_BadgeStyle, CLAYKIT_STYLE_BADGE, 0, cfg,
+                         claykit_compute_badge_style(ctx, cfg));
+}
+
 /* ----------------------------------------------------------------------------
  * Badge Rendering
  * ---------------------------------------------------------------------------- */
@@ -2191,9 +5105,9 @@ void ClayKit_Badge(ClayKit_Context *ctx, Clay_String text, ClayKit_BadgeConfig c
  * Tag
  * ---------------------------------------------------------------------------- */
 
-ClayKit_TagStyle ClayKit_ComputeTagStyle(ClayKit_Context *ctx, ClayKit_TagConfig cfg) {
+static ClayKit_TagStyle claykit_compute_tag_style(ClayKit_Context *ctx, ClayKit_TagConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
     ClayKit_TagStyle style;
 
     /* Determine padding and font size based on size */
@@ -2252,6 +5166,11 @@ ClayKit_TagStyle ClayKit_ComputeTagStyle(ClayKit_Context *ctx, ClayKit_TagConfig
     return style;
 }
 
+ClayKit_TagStyle ClayKit_ComputeTagStyle(ClayKit_Context *ctx, ClayKit_TagConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_TagStyle, CLAYKIT_STYLE_TAG, 0, cfg,
+                         claykit_compute_tag_style(ctx, cfg));
+}
+
 void ClayKit_TagRaw(ClayKit_Context *ctx, const char *text, int32_t text_len, ClayKit_TagConfig cfg) {
     ClayKit_TagStyle style = ClayKit_ComputeTagStyle(ctx, cfg);
     Clay_String clay_text = { false, text_len, text };
@@ -2310,7 +5229,7 @@ void ClayKit_Tag(ClayKit_Context *ctx, Clay_String text, ClayKit_TagConfig cfg)
  * Stat
  * ---------------------------------------------------------------------------- */
 
-ClayKit_StatStyle ClayKit_ComputeStatStyle(ClayKit_Context *ctx, ClayKit_StatConfig cfg) {
+static ClayKit_StatStyle claykit_compute_stat_style(ClayKit_Context *ctx, ClayKit_StatConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_StatStyle style;
 
@@ -2362,6 +5281,11 @@ ClayKit_StatStyle ClayKit_ComputeStatStyle(ClayKit_Context *ctx, ClayKit_StatCon
     return style;
 }
 
+ClayKit_StatStyle ClayKit_ComputeStatStyle(ClayKit_Context *ctx, ClayKit_StatConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_StatStyle, CLAYKIT_STYLE_STAT, 0, cfg,
+                         claykit_compute_stat_style(ctx, cfg));
+}
+
 void ClayKit_Stat(ClayKit_Context *ctx,
                   const char *label, int32_t label_len,
                   const char *value, int32_t value_len,
@@ -2432,7 +5356,7 @@ static void claykit_uint_to_str(uint32_t n, char *buf, int32_t *out_len) {
     *out_len = pos + 1;
 }
 
-ClayKit_ListStyle ClayKit_ComputeListStyle(ClayKit_Context *ctx, ClayKit_ListConfig cfg) {
+static ClayKit_ListStyle claykit_compute_list_style(ClayKit_Context *ctx, ClayKit_ListConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_ListStyle style;
 
@@ -2462,6 +5386,11 @@ ClayKit_ListStyle ClayKit_ComputeListStyle(ClayKit_Context *ctx, ClayKit_ListCon
     return style;
 }
 
+ClayKit_ListStyle ClayKit_ComputeListStyle(ClayKit_Context *ctx, ClayKit_ListConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_ListStyle, CLAYKIT_STYLE_LIST, 0, cfg,
+                         claykit_compute_list_style(ctx, cfg));
+}
+
 void ClayKit_ListBegin(ClayKit_Context *ctx, ClayKit_ListConfig cfg) {
     ClayKit_ListStyle style = ClayKit_ComputeListStyle(ctx, cfg);
 
@@ -2510,14 +5439,17 @@ void ClayKit_ListItemRaw(ClayKit_Context *ctx, const char *text, int32_t text_le
 
         if (cfg.ordered) {
             /* Clay stores string pointers and reads them at render time,
-               so the buffer must survive until after Clay_EndLayout().
-               Use a static ring of buffers — one per list item index. */
-            #define CLAYKIT_NUM_BUF_SLOTS 64
-            static char num_bufs[CLAYKIT_NUM_BUF_SLOTS][12];
-            char *num_buf = num_bufs[index % CLAYKIT_NUM_BUF_SLOTS];
-            int32_t num_len;
-            claykit_uint_to_str(index + 1, num_buf, &num_len);
-            Clay_String marker_str = { false, num_len, num_buf };
+               so the number lives in the frame arena until the next frame.
+               Without arena space the marker is left empty. */
+            char *num_buf = (char *)ClayKit_FrameAlloc(ctx, 12, 1);
+            int32_t num_len = 0;
+            if (num_buf) {
+                claykit_uint_to_str(index + 1, num_buf, &num_len);
+                claykit_stat_use(&ctx->stats.list_numbers, ctx->stats.list_numbers.used + 1);
+            } else {
+                claykit_stat_overflow(&ctx->stats.list_numbers);
+            }
+            Clay_String marker_str = { false, num_len, num_buf ? num_buf : "" };
             Clay__OpenTextElement(marker_str, Clay__StoreTextElementConfig(marker_text_cfg));
         } else {
             /* Bullet character: Unicode U+2022 */
@@ -2550,9 +5482,9 @@ void ClayKit_ListEnd(void) {
  * Table
  * ---------------------------------------------------------------------------- */
 
-ClayKit_TableStyle ClayKit_ComputeTableStyle(ClayKit_Context *ctx, ClayKit_TableConfig cfg) {
+static ClayKit_TableStyle claykit_compute_table_style(ClayKit_Context *ctx, ClayKit_TableConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
     ClayKit_TableStyle style;
 
     style.header_bg = scheme_color;
@@ -2592,6 +5524,11 @@ ClayKit_TableStyle ClayKit_ComputeTableStyle(ClayKit_Context *ctx, ClayKit_Table
     return style;
 }
 
+ClayKit_TableStyle ClayKit_ComputeTableStyle(ClayKit_Context *ctx, ClayKit_TableConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_TableStyle, CLAYKIT_STYLE_TABLE, 0, cfg,
+                         claykit_compute_table_style(ctx, cfg));
+}
+
 void ClayKit_TableBegin(ClayKit_Context *ctx, ClayKit_TableConfig cfg) {
     ClayKit_TableStyle style = ClayKit_ComputeTableStyle(ctx, cfg);
 
@@ -2686,13 +5623,13 @@ void ClayKit_TableEnd(void) { Clay__CloseElement(); }
  * Progress
  * ---------------------------------------------------------------------------- */
 
-ClayKit_ProgressStyle ClayKit_ComputeProgressStyle(ClayKit_Context *ctx, ClayKit_ProgressConfig cfg) {
+static ClayKit_ProgressStyle claykit_compute_progress_style(ClayKit_Context *ctx, ClayKit_ProgressConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_ProgressStyle style;
 
     /* Track is a lightened version of border color */
     style.track_color = claykit_color_lighten(theme->border, 0.5f);
-    style.fill_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    style.fill_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     /* Height based on size */
     switch (cfg.size) {
@@ -2709,6 +5646,11 @@ ClayKit_ProgressStyle ClayKit_ComputeProgressStyle(ClayKit_Context *ctx, ClayKit
     return style;
 }
 
+ClayKit_ProgressStyle ClayKit_ComputeProgressStyle(ClayKit_Context *ctx, ClayKit_ProgressConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_ProgressStyle, CLAYKIT_STYLE_PROGRESS, 0, cfg,
+                         claykit_compute_progress_style(ctx, cfg));
+}
+
 void ClayKit_Progress(ClayKit_Context *ctx, float value, ClayKit_ProgressConfig cfg) {
     ClayKit_ProgressStyle style = ClayKit_ComputeProgressStyle(ctx, cfg);
     float clamped = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
@@ -2752,11 +5694,11 @@ void ClayKit_Progress(ClayKit_Context *ctx, float value, ClayKit_ProgressConfig
  * Slider
  * ---------------------------------------------------------------------------- */
 
-ClayKit_SliderStyle ClayKit_ComputeSliderStyle(ClayKit_Context *ctx, ClayKit_SliderConfig cfg, bool hovered) {
+static ClayKit_SliderStyle claykit_compute_slider_style(ClayKit_Context *ctx, ClayKit_SliderConfig cfg, bool hovered) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_SliderStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     /* Track is a lightened version of border color */
     style.track_color = claykit_color_lighten(theme->border, 0.5f);
@@ -2801,15 +5743,20 @@ ClayKit_SliderStyle ClayKit_ComputeSliderStyle(ClayKit_Context *ctx, ClayKit_Sli
     return style;
 }
 
+ClayKit_SliderStyle ClayKit_ComputeSliderStyle(ClayKit_Context *ctx, ClayKit_SliderConfig cfg, bool hovered) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_SliderStyle, CLAYKIT_STYLE_SLIDER, hovered, cfg,
+                         claykit_compute_slider_style(ctx, cfg, hovered));
+}
+
 /* ----------------------------------------------------------------------------
  * Select
  * ---------------------------------------------------------------------------- */
 
-ClayKit_SelectStyle ClayKit_ComputeSelectStyle(ClayKit_Context *ctx, ClayKit_SelectConfig cfg) {
+static ClayKit_SelectStyle claykit_compute_select_style(ClayKit_Context *ctx, ClayKit_SelectConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_SelectStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     style.bg_color = theme->bg;
     style.border_color = theme->border;
@@ -2819,7 +5766,7 @@ ClayKit_SelectStyle ClayKit_ComputeSelectStyle(ClayKit_Context *ctx, ClayKit_Sel
     style.dropdown_border = theme->border;
     style.option_hover_bg = claykit_color_lighten(scheme_color, 0.9f);
     style.font_id = theme->font_id.body;
-    style.corner_radius = ClayKit_GetRadius(theme, cfg.size);
+    style.corner_radius = claykit_radius(ctx, cfg.size);
 
     switch (cfg.size) {
         case CLAYKIT_SIZE_XS:
@@ -2858,6 +5805,11 @@ ClayKit_SelectStyle ClayKit_ComputeSelectStyle(ClayKit_Context *ctx, ClayKit_Sel
     return style;
 }
 
+ClayKit_SelectStyle ClayKit_ComputeSelectStyle(ClayKit_Context *ctx, ClayKit_SelectConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_SelectStyle, CLAYKIT_STYLE_SELECT, 0, cfg,
+                         claykit_compute_select_style(ctx, cfg));
+}
+
 bool ClayKit_SelectTrigger(ClayKit_Context *ctx, const char *id, int32_t id_len,
                            const char *display_text, int32_t display_len,
                            ClayKit_SelectConfig cfg) {
@@ -2894,34 +5846,21 @@ bool ClayKit_SelectTrigger(ClayKit_Context *ctx, const char *id, int32_t id_len,
 
     Clay__ConfigureOpenElement(decl);
 
-    /* Display text (or placeholder) - grows to push arrow right */
+    /* Display text (or placeholder) - grows to push arrow right, and is
+     * cut with an ellipsis when the trigger is too narrow for it */
     {
-        Clay_ElementDeclaration text_wrapper = {0};
-        text_wrapper.layout.sizing.width.type = CLAY__SIZING_TYPE_GROW;
-        text_wrapper.layout.sizing.height.type = CLAY__SIZING_TYPE_FIT;
-
-        Clay__OpenElement();
-        Clay__ConfigureOpenElement(text_wrapper);
+        Clay_TextElementConfig text_cfg = {0};
+        text_cfg.fontSize = style.font_size;
+        text_cfg.textColor = style.text_color;
+        text_cfg.fontId = style.font_id;
 
-        if (display_text != NULL && display_len > 0) {
-            Clay_String text_str = { false, display_len, display_text };
-            Clay_TextElementConfig text_cfg = {0};
-            text_cfg.fontSize = style.font_size;
-            text_cfg.textColor = style.text_color;
-            text_cfg.fontId = style.font_id;
-            text_cfg.wrapMode = CLAY_TEXT_WRAP_NONE;
-            Clay__OpenTextElement(text_str, Clay__StoreTextElementConfig(text_cfg));
-        } else {
-            Clay_String placeholder = { false, 9, "Select..." };
-            Clay_TextElementConfig text_cfg = {0};
-            text_cfg.fontSize = style.font_size;
+        if (display_text == NULL || display_len <= 0) {
+            display_text = "Select...";
+            display_len = 9;
             text_cfg.textColor = style.placeholder_color;
-            text_cfg.fontId = style.font_id;
-            text_cfg.wrapMode = CLAY_TEXT_WRAP_NONE;
-            Clay__OpenTextElement(placeholder, Clay__StoreTextElementConfig(text_cfg));
         }
-
-        Clay__CloseElement();
+        claykit_text_truncated(ctx, Clay__HashString(id_str, 1, 0),
+                               display_text, (uint32_t)display_len, text_cfg);
     }
 
     /* Down arrow indicator */
@@ -2983,7 +5922,7 @@ bool ClayKit_SelectOption(ClayKit_Context *ctx, const char *text, int32_t text_l
 
     Clay_Color bg = (Clay_Color){ 0, 0, 0, 0 };
     if (is_selected) {
-        bg = claykit_color_lighten(ClayKit_GetSchemeColor(ctx->theme_ptr, cfg.color_scheme), 0.85f);
+        bg = claykit_color_lighten(claykit_scheme_color(ctx, cfg.color_scheme), 0.85f);
     } else if (hovered) {
         bg = style.option_hover_bg;
     }
@@ -3023,11 +5962,11 @@ void ClayKit_SelectDropdownEnd(void) {
  * Alert
  * ---------------------------------------------------------------------------- */
 
-ClayKit_AlertStyle ClayKit_ComputeAlertStyle(ClayKit_Context *ctx, ClayKit_AlertConfig cfg) {
+static ClayKit_AlertStyle claykit_compute_alert_style(ClayKit_Context *ctx, ClayKit_AlertConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_AlertStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     switch (cfg.variant) {
         case CLAYKIT_ALERT_SOLID:
@@ -3061,6 +6000,11 @@ ClayKit_AlertStyle ClayKit_ComputeAlertStyle(ClayKit_Context *ctx, ClayKit_Alert
     return style;
 }
 
+ClayKit_AlertStyle ClayKit_ComputeAlertStyle(ClayKit_Context *ctx, ClayKit_AlertConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_AlertStyle, CLAYKIT_STYLE_ALERT, 0, cfg,
+                         claykit_compute_alert_style(ctx, cfg));
+}
+
 void ClayKit_AlertText(ClayKit_Context *ctx, const char *text, int32_t text_len, ClayKit_AlertConfig cfg) {
     ClayKit_AlertStyle style = ClayKit_ComputeAlertStyle(ctx, cfg);
 
@@ -3090,7 +6034,7 @@ void ClayKit_AlertText(ClayKit_Context *ctx, const char *text, int32_t text_len,
 
     /* Icon (if configured) */
     if (cfg.icon.id > 0) {
-        claykit_emit_icon((ClayKit_Icon){ cfg.icon.id, style.icon_size }, style.icon_color);
+        claykit_emit_icon(ctx, (ClayKit_Icon){ cfg.icon.id, style.icon_size }, style.icon_color);
     }
 
     /* Text */
@@ -3109,7 +6053,7 @@ void ClayKit_AlertText(ClayKit_Context *ctx, const char *text, int32_t text_len,
  * Tooltip
  * ---------------------------------------------------------------------------- */
 
-ClayKit_TooltipStyle ClayKit_ComputeTooltipStyle(ClayKit_Context *ctx, ClayKit_TooltipConfig cfg) {
+static ClayKit_TooltipStyle claykit_compute_tooltip_style(ClayKit_Context *ctx, ClayKit_TooltipConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_TooltipStyle style;
     (void)cfg; /* Position doesn't affect style, only layout */
@@ -3126,6 +6070,11 @@ ClayKit_TooltipStyle ClayKit_ComputeTooltipStyle(ClayKit_Context *ctx, ClayKit_T
     return style;
 }
 
+ClayKit_TooltipStyle ClayKit_ComputeTooltipStyle(ClayKit_Context *ctx, ClayKit_TooltipConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_TooltipStyle, CLAYKIT_STYLE_TOOLTIP, 0, cfg,
+                         claykit_compute_tooltip_style(ctx, cfg));
+}
+
 void ClayKit_Tooltip(ClayKit_Context *ctx, const char *text, int32_t text_len, ClayKit_TooltipConfig cfg) {
     ClayKit_TooltipStyle style = ClayKit_ComputeTooltipStyle(ctx, cfg);
 
@@ -3160,11 +6109,11 @@ void ClayKit_Tooltip(ClayKit_Context *ctx, const char *text, int32_t text_len, C
  * Tabs
  * ---------------------------------------------------------------------------- */
 
-ClayKit_TabsStyle ClayKit_ComputeTabsStyle(ClayKit_Context *ctx, ClayKit_TabsConfig cfg) {
+static ClayKit_TabsStyle claykit_compute_tabs_style(ClayKit_Context *ctx, ClayKit_TabsConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_TabsStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     style.active_color = scheme_color;
     style.inactive_color = theme->muted;
@@ -3228,11 +6177,16 @@ ClayKit_TabsStyle ClayKit_ComputeTabsStyle(ClayKit_Context *ctx, ClayKit_TabsCon
     return style;
 }
 
+ClayKit_TabsStyle ClayKit_ComputeTabsStyle(ClayKit_Context *ctx, ClayKit_TabsConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_TabsStyle, CLAYKIT_STYLE_TABS, 0, cfg,
+                         claykit_compute_tabs_style(ctx, cfg));
+}
+
 /* ----------------------------------------------------------------------------
  * Modal
  * ---------------------------------------------------------------------------- */
 
-ClayKit_ModalStyle ClayKit_ComputeModalStyle(ClayKit_Context *ctx, ClayKit_ModalConfig cfg) {
+static ClayKit_ModalStyle claykit_compute_modal_style(ClayKit_Context *ctx, ClayKit_ModalConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_ModalStyle style;
 
@@ -3269,15 +6223,20 @@ ClayKit_ModalStyle ClayKit_ComputeModalStyle(ClayKit_Context *ctx, ClayKit_Modal
     return style;
 }
 
+ClayKit_ModalStyle ClayKit_ComputeModalStyle(ClayKit_Context *ctx, ClayKit_ModalConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_ModalStyle, CLAYKIT_STYLE_MODAL, 0, cfg,
+                         claykit_compute_modal_style(ctx, cfg));
+}
+
 /* ----------------------------------------------------------------------------
  * Spinner
  * ---------------------------------------------------------------------------- */
 
-ClayKit_SpinnerStyle ClayKit_ComputeSpinnerStyle(ClayKit_Context *ctx, ClayKit_SpinnerConfig cfg) {
+static ClayKit_SpinnerStyle claykit_compute_spinner_style(ClayKit_Context *ctx, ClayKit_SpinnerConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_SpinnerStyle style;
 
-    style.color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    style.color = claykit_scheme_color(ctx, cfg.color_scheme);
     style.track_color = claykit_color_lighten(theme->border, 0.5f);
     style.speed = cfg.speed > 0.0f ? cfg.speed : 1.0f;
 
@@ -3308,6 +6267,11 @@ ClayKit_SpinnerStyle ClayKit_ComputeSpinnerStyle(ClayKit_Context *ctx, ClayKit_S
     return style;
 }
 
+ClayKit_SpinnerStyle ClayKit_ComputeSpinnerStyle(ClayKit_Context *ctx, ClayKit_SpinnerConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_SpinnerStyle, CLAYKIT_STYLE_SPINNER, 0, cfg,
+                         claykit_compute_spinner_style(ctx, cfg));
+}
+
 float ClayKit_SpinnerAngle(ClayKit_Context *ctx, ClayKit_SpinnerConfig cfg) {
     float speed = cfg.speed > 0.0f ? cfg.speed : 1.0f;
     float angle = ctx->cursor_blink_time * speed * 360.0f;
@@ -3375,7 +6339,7 @@ void ClayKit_Spinner(ClayKit_Context *ctx, ClayKit_SpinnerConfig cfg) {
  * Drawer
  * ---------------------------------------------------------------------------- */
 
-ClayKit_DrawerStyle ClayKit_ComputeDrawerStyle(ClayKit_Context *ctx, ClayKit_DrawerConfig cfg) {
+static ClayKit_DrawerStyle claykit_compute_drawer_style(ClayKit_Context *ctx, ClayKit_DrawerConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_DrawerStyle style;
 
@@ -3389,6 +6353,11 @@ ClayKit_DrawerStyle ClayKit_ComputeDrawerStyle(ClayKit_Context *ctx, ClayKit_Dra
     return style;
 }
 
+ClayKit_DrawerStyle ClayKit_ComputeDrawerStyle(ClayKit_Context *ctx, ClayKit_DrawerConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_DrawerStyle, CLAYKIT_STYLE_DRAWER, 0, cfg,
+                         claykit_compute_drawer_style(ctx, cfg));
+}
+
 bool ClayKit_DrawerBegin(ClayKit_Context *ctx, const char *id, int32_t id_len, ClayKit_DrawerConfig cfg) {
     ClayKit_DrawerStyle style = ClayKit_ComputeDrawerStyle(ctx, cfg);
 
@@ -3503,7 +6472,7 @@ void ClayKit_DrawerEnd(void) {
  * Popover
  * ---------------------------------------------------------------------------- */
 
-ClayKit_PopoverStyle ClayKit_ComputePopoverStyle(ClayKit_Context *ctx, ClayKit_PopoverConfig cfg) {
+static ClayKit_PopoverStyle claykit_compute_popover_style(ClayKit_Context *ctx, ClayKit_PopoverConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_PopoverStyle style;
 
@@ -3516,6 +6485,11 @@ ClayKit_PopoverStyle ClayKit_ComputePopoverStyle(ClayKit_Context *ctx, ClayKit_P
     return style;
 }
 
+ClayKit_PopoverStyle ClayKit_ComputePopoverStyle(ClayKit_Context *ctx, ClayKit_PopoverConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_PopoverStyle, CLAYKIT_STYLE_POPOVER, 0, cfg,
+                         claykit_compute_popover_style(ctx, cfg));
+}
+
 void ClayKit_PopoverBegin(ClayKit_Context *ctx, const char *id, int32_t id_len, ClayKit_PopoverConfig cfg) {
     ClayKit_PopoverStyle style = ClayKit_ComputePopoverStyle(ctx, cfg);
 
@@ -3582,14 +6556,19 @@ void ClayKit_PopoverEnd(void) {
  * Icon Emission
  * ---------------------------------------------------------------------------- */
 
-static ClayKit_IconRenderData claykit_icon_slots[32];
-static uint32_t claykit_icon_slot_idx = 0;
-
-static void claykit_emit_icon(ClayKit_Icon icon, Clay_Color color) {
-    ClayKit_IconRenderData *data = &claykit_icon_slots[claykit_icon_slot_idx++ % 32];
-    data->type = CLAYKIT_CUSTOM_ICON;
-    data->icon_id = icon.id;
-    data->color = color;
+/* Render data lives in the frame arena. If it is exhausted the icon still
+ * takes up its space but has no custom data, so nothing is drawn. */
+static void claykit_emit_icon(ClayKit_Context *ctx, ClayKit_Icon icon, Clay_Color color) {
+    ClayKit_IconRenderData *data = (ClayKit_IconRenderData *)ClayKit_FrameAlloc(
+        ctx, sizeof(ClayKit_IconRenderData), sizeof(uint32_t));
+    if (data) {
+        data->type = CLAYKIT_CUSTOM_ICON;
+        data->icon_id = icon.id;
+        data->color = color;
+        claykit_stat_use(&ctx->stats.icons, ctx->stats.icons.used + 1);
+    } else {
+        claykit_stat_overflow(&ctx->stats.icons);
+    }
 
     uint16_t sz = icon.size > 0 ? icon.size : 20;
 
@@ -3653,7 +6632,7 @@ bool ClayKit_Button(ClayKit_Context *ctx, const char *text, int32_t text_len, Cl
     if (cfg.icon_left.id > 0) {
         ClayKit_Icon left = cfg.icon_left;
         if (left.size == 0) left.size = font_size;
-        claykit_emit_icon(left, text_color);
+        claykit_emit_icon(ctx, left, text_color);
     }
 
     Clay_String clay_text = { false, text_len, text };
@@ -3669,7 +6648,7 @@ bool ClayKit_Button(ClayKit_Context *ctx, const char *text, int32_t text_len, Cl
     if (cfg.icon_right.id > 0) {
         ClayKit_Icon right = cfg.icon_right;
         if (right.size == 0) right.size = font_size;
-        claykit_emit_icon(right, text_color);
+        claykit_emit_icon(ctx, right, text_color);
     }
 
     Clay__CloseElement();
@@ -3990,6 +6969,67 @@ bool ClayKit_Tab(ClayKit_Context *ctx, const char *label, int32_t label_len, boo
  * Text Input Rendering
  * ---------------------------------------------------------------------------- */
 
+/* Cursor bar of a text input or area; alpha controls blink visibility */
+static void claykit_input_cursor(ClayKit_InputStyle style, bool visible) {
+    Clay_ElementDeclaration cursor_decl = {0};
+    cursor_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_FIXED;
+    cursor_decl.layout.sizing.width.size.minMax.min = (float)style.cursor_width;
+    cursor_decl.layout.sizing.width.size.minMax.max = (float)style.cursor_width;
+    cursor_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIXED;
+    cursor_decl.layout.sizing.height.size.minMax.min = (float)style.font_size;
+    cursor_decl.layout.sizing.height.size.minMax.max = (float)style.font_size;
+    cursor_decl.backgroundColor = style.cursor_color;
+    if (!visible) {
+        cursor_decl.backgroundColor.a = 0;
+    }
+
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(cursor_decl);
+    Clay__CloseElement();
+}
+
+static void claykit_input_run(ClayKit_InputState *s, uint32_t start, uint32_t end, Clay_TextElementConfig config) {
+    if (end <= start) return;
+    Clay_String str = { false, (int32_t)(end - start), claykit_input_span(s, start, end) };
+    Clay__OpenTextElement(str, Clay__StoreTextElementConfig(config));
+}
+
+/* Emits the text [start, end) as at most three runs: before the selection,
+ * the selected part on a highlight, and after it. Without a selection the
+ * text is split at the cursor instead, where a gap buffer's gap sits after
+ * typing, and the cursor bar goes there when focused. Runs are emitted in
+ * text order, so moving the gap for a later run never invalidates an
+ * earlier one. */
+static void claykit_input_runs(ClayKit_InputState *s, ClayKit_InputStyle style, uint32_t start, uint32_t end,
+                               bool focused, bool show_cursor, Clay_TextElementConfig config) {
+    uint32_t cursor = s->cursor < s->len ? s->cursor : s->len;
+    uint32_t anchor = s->select_start < s->len ? s->select_start : s->len;
+    uint32_t lo = cursor < anchor ? cursor : anchor;
+    uint32_t hi = cursor < anchor ? anchor : cursor;
+    if (lo < start) lo = start;
+    if (hi > end) hi = end;
+    bool here = cursor >= start && cursor <= end;
+    bool bar = focused && here;
+    if (lo >= hi) {
+        lo = hi = here ? cursor : end;
+    }
+
+    claykit_input_run(s, start, lo, config);
+    if (bar && cursor == lo) claykit_input_cursor(style, show_cursor);
+    if (hi > lo) {
+        Clay_ElementDeclaration sel_decl = {0};
+        sel_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_FIT;
+        sel_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIT;
+        sel_decl.backgroundColor = style.selection_color;
+        Clay__OpenElement();
+        Clay__ConfigureOpenElement(sel_decl);
+        claykit_input_run(s, lo, hi, config);
+        Clay__CloseElement();
+        if (bar && cursor == hi) claykit_input_cursor(style, show_cursor);
+    }
+    claykit_input_run(s, hi, end, config);
+}
+
 bool ClayKit_TextInput(ClayKit_Context *ctx, const char *id, int32_t id_len,
                        ClayKit_InputState *state, ClayKit_InputConfig cfg,
                        const char *placeholder, int32_t placeholder_len) {
@@ -4035,6 +7075,43 @@ bool ClayKit_TextInput(ClayKit_Context *ctx, const char *id, int32_t id_len,
 
     Clay__ConfigureOpenElement(outer_decl);
 
+    uint32_t cursor_pos = state->cursor;
+    if (cursor_pos > state->len) cursor_pos = state->len;
+
+    /* Only the slice [first, last) that fits the viewport is emitted. The
+     * scroll position is kept in whole codepoints, as the x of first, in the
+     * element's state, and moves just enough to keep the cursor in view. The
+     * viewport width comes from the previous frame's layout. */
+    uint32_t first = 0;
+    uint32_t last = state->len;
+    Clay_ElementData prev = Clay_GetElementData(outer_decl.id);
+    float view = prev.found ? prev.boundingBox.width - 2.0f * (float)style.padding_x - (float)style.cursor_width : 0.0f;
+    if (outer_decl.id.id != 0 && state->len > 0 && view > 0.0f) {
+        uint16_t font_id = style.font_id;
+        uint16_t font_size = style.font_size;
+        ClayKit_State *vs = ClayKit_GetOrCreateState(ctx, outer_decl.id.id);
+        float scroll = vs ? vs->value : 0.0f;
+        float cursor_x = ClayKit_InputOffsetX(ctx, state, font_id, font_size, cursor_pos);
+
+        if (cursor_x < scroll) {
+            first = cursor_pos;
+        } else if (cursor_x > scroll + view) {
+            first = claykit_input_ceil_x(ctx, state, font_id, font_size, cursor_x - view);
+        } else {
+            first = claykit_input_ceil_x(ctx, state, font_id, font_size, scroll);
+        }
+        scroll = ClayKit_InputOffsetX(ctx, state, font_id, font_size, first);
+
+        last = claykit_input_floor_x(ctx, state, font_id, font_size, scroll + view);
+        if (last == state->len && first > 0) {
+            /* Scroll back over any space left after the end by deletions */
+            float end_x = ClayKit_InputOffsetX(ctx, state, font_id, font_size, last);
+            first = end_x > view ? claykit_input_ceil_x(ctx, state, font_id, font_size, end_x - view) : 0;
+            scroll = ClayKit_InputOffsetX(ctx, state, font_id, font_size, first);
+        }
+        if (vs) vs->value = scroll;
+    }
+
     /* Inner content container (horizontal layout) */
     Clay_ElementDeclaration inner_decl = {0};
     inner_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_GROW;
@@ -4045,97 +7122,331 @@ bool ClayKit_TextInput(ClayKit_Context *ctx, const char *id, int32_t id_len,
     Clay__OpenElement();
     Clay__ConfigureOpenElement(inner_decl);
 
-    uint32_t cursor_pos = state->cursor;
-    if (cursor_pos > state->len) cursor_pos = state->len;
-
     Clay_TextElementConfig text_config = {0};
     text_config.fontSize = style.font_size;
     text_config.fontId = style.font_id;
     text_config.wrapMode = CLAY_TEXT_WRAP_NONE;
 
     if (state->len > 0) {
-        /* Text before cursor */
-        if (cursor_pos > 0) {
-            Clay_String text_before = { false, (int32_t)cursor_pos, state->buf };
-            text_config.textColor = style.text_color;
-            Clay__OpenTextElement(text_before, Clay__StoreTextElementConfig(text_config));
+        /* Split at the cursor and selection ends. A gap buffer only needs its
+         * gap moved when it falls inside a run; right after typing it
+         * already sits at the cursor. */
+        text_config.textColor = style.text_color;
+        claykit_input_runs(state, style, first, last, focused, show_cursor, text_config);
+    } else {
+        /* No text - show cursor or placeholder */
+        if (focused) {
+            claykit_input_cursor(style, show_cursor);
+        } else if (placeholder != NULL && placeholder_len > 0) {
+            Clay_String placeholder_str = { false, placeholder_len, placeholder };
+            text_config.textColor = style.placeholder_color;
+            Clay__OpenTextElement(placeholder_str, Clay__StoreTextElementConfig(text_config));
         }
+    }
 
-        /* Cursor (render when focused, alpha controls visibility) */
-        if (focused) {
-            Clay_ElementDeclaration cursor_decl = {0};
-            cursor_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_FIXED;
-            cursor_decl.layout.sizing.width.size.minMax.min = (float)style.cursor_width;
-            cursor_decl.layout.sizing.width.size.minMax.max = (float)style.cursor_width;
-            cursor_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIXED;
-            cursor_decl.layout.sizing.height.size.minMax.min = (float)style.font_size;
-            cursor_decl.layout.sizing.height.size.minMax.max = (float)style.font_size;
-            cursor_decl.backgroundColor = style.cursor_color;
-            if (!show_cursor) {
-                cursor_decl.backgroundColor.a = 0;
-            }
+    Clay__CloseElement(); /* inner */
+    Clay__CloseElement(); /* outer */
+    return hovered;
+}
 
-            Clay__OpenElement();
-            Clay__ConfigureOpenElement(cursor_decl);
-            Clay__CloseElement();
-        }
+float ClayKit_TextInputScroll(ClayKit_Context *ctx, const char *id, int32_t id_len) {
+    if (id == NULL || id_len <= 0) return 0.0f;
+    Clay_String id_str = { false, id_len, id };
+    ClayKit_State *vs = ClayKit_GetState(ctx, Clay__HashString(id_str, 0, 0).id);
+    return vs ? vs->value : 0.0f;
+}
 
-        /* Text after cursor */
-        if (cursor_pos < state->len) {
-            Clay_String text_after = { false, (int32_t)(state->len - cursor_pos), state->buf + cursor_pos };
-            text_config.textColor = style.text_color;
-            Clay__OpenTextElement(text_after, Clay__StoreTextElementConfig(text_config));
+/* Press and drag bookkeeping shared by text inputs and areas. Updates focus
+ * and the drag flag, and returns true with the element's last bounding box
+ * when the pointer should move the cursor this frame. */
+static bool claykit_input_pointer(ClayKit_Context *ctx, ClayKit_InputState *s, const char *id, int32_t id_len,
+                                  float x, float y, bool pressed, bool down, Clay_BoundingBox *box,
+                                  bool *repeat) {
+    Clay_ElementData elem = { {0}, false };
+    if (id != NULL && id_len > 0) {
+        Clay_String id_str = { false, id_len, id };
+        elem = Clay_GetElementData(Clay__HashString(id_str, 0, 0));
+    }
+    Clay_BoundingBox b = elem.boundingBox;
+
+    if (pressed) {
+        if (!elem.found || x < b.x || y < b.y || x >= b.x + b.width || y >= b.y + b.height) {
+            s->flags &= ~(CLAYKIT_INPUT_FOCUSED | CLAYKIT_INPUT_DRAGGING);
+            return false;
         }
+        *repeat = (s->flags & CLAYKIT_INPUT_FOCUSED) && ctx->cursor_blink_time < CLAYKIT_DOUBLE_CLICK_TIME;
+        s->flags |= CLAYKIT_INPUT_FOCUSED | CLAYKIT_INPUT_DRAGGING;
+        ctx->cursor_blink_time = 0;
+    } else if (!down) {
+        s->flags &= ~CLAYKIT_INPUT_DRAGGING;
+        return false;
+    } else if (!(s->flags & CLAYKIT_INPUT_DRAGGING) || !elem.found) {
+        return false;
+    }
+    *box = b;
+    return true;
+}
+
+/* Moves the cursor to a pointer hit; a press without Shift also collapses
+ * the selection there. A repeated press on the collapsed cursor selects the
+ * word instead and ends the drag so holding the button keeps it. */
+static void claykit_input_pointer_move(ClayKit_InputState *s, uint32_t hit, bool pressed, bool repeat,
+                                       uint32_t mods) {
+    if (pressed && repeat && !(mods & CLAYKIT_MOD_SHIFT) && hit == s->cursor && hit == s->select_start) {
+        ClayKit_InputSelectWord(s, hit);
+        s->flags &= ~CLAYKIT_INPUT_DRAGGING;
+        return;
+    }
+    s->cursor = hit;
+    if (pressed && !(mods & CLAYKIT_MOD_SHIFT)) {
+        s->select_start = hit;
+    }
+}
+
+bool ClayKit_TextInputPointer(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                              ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                              float x, float y, bool pressed, bool down, uint32_t mods) {
+    uint32_t cursor = state->cursor;
+    uint32_t select_start = state->select_start;
+    uint8_t flags = state->flags;
+    Clay_BoundingBox box;
+    bool repeat = false;
+    if (claykit_input_pointer(ctx, state, id, id_len, x, y, pressed, down, &box, &repeat)) {
+        ClayKit_InputStyle style = ClayKit_ComputeInputStyle(ctx, cfg, true);
+        float local_x = x - box.x - (float)style.padding_x + ClayKit_TextInputScroll(ctx, id, id_len);
+        claykit_input_pointer_move(state, ClayKit_InputHitTest(ctx, state, style.font_id, style.font_size, local_x),
+                                   pressed, repeat, mods);
+    }
+    return state->cursor != cursor || state->select_start != select_start
+        || ((state->flags ^ flags) & CLAYKIT_INPUT_FOCUSED) != 0;
+}
+
+/* ----------------------------------------------------------------------------
+ * Text Area
+ * ---------------------------------------------------------------------------- */
+
+static float claykit_text_area_line_height(ClayKit_InputStyle style) {
+    return (float)(style.font_size + style.font_size / 4);
+}
+
+/* Horizontal scroll that keeps the cursor inside a view of the given width.
+ * With an advance cache the cursor's x within its line is a difference of
+ * two cached widths. */
+static float claykit_text_area_scroll_x(ClayKit_Context *ctx, ClayKit_InputState *s,
+                                        ClayKit_InputStyle style, uint32_t cursor, float view) {
+    if (view <= 0.0f) return 0.0f;
+    uint32_t start = ClayKit_InputLineStart(s, ClayKit_InputLineAt(s, cursor));
+    float x;
+    if (claykit_advances_for(s, style.font_id, style.font_size)) {
+        x = ClayKit_InputOffsetX(ctx, s, style.font_id, style.font_size, cursor)
+          - ClayKit_InputOffsetX(ctx, s, style.font_id, style.font_size, start);
     } else {
-        /* No text - show cursor or placeholder */
-        if (focused) {
-            Clay_ElementDeclaration cursor_decl = {0};
-            cursor_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_FIXED;
-            cursor_decl.layout.sizing.width.size.minMax.min = (float)style.cursor_width;
-            cursor_decl.layout.sizing.width.size.minMax.max = (float)style.cursor_width;
-            cursor_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIXED;
-            cursor_decl.layout.sizing.height.size.minMax.min = (float)style.font_size;
-            cursor_decl.layout.sizing.height.size.minMax.max = (float)style.font_size;
-            cursor_decl.backgroundColor = style.cursor_color;
-            if (!show_cursor) {
-                cursor_decl.backgroundColor.a = 0;
-            }
+        x = ClayKit_MeasureTextWidth(ctx, claykit_input_span(s, start, cursor), cursor - start,
+                                     style.font_id, style.font_size);
+    }
+    return x > view ? x - view : 0.0f;
+}
 
-            Clay__OpenElement();
-            Clay__ConfigureOpenElement(cursor_decl);
-            Clay__CloseElement();
-        } else if (placeholder != NULL && placeholder_len > 0) {
+bool ClayKit_TextArea(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                      ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                      const char *placeholder, int32_t placeholder_len) {
+    bool focused = (state->flags & CLAYKIT_INPUT_FOCUSED) != 0;
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(ctx, cfg, focused);
+    bool show_cursor = focused && (((int)(ctx->cursor_blink_time * 2) % 2) == 0);
+    uint32_t rows = cfg.rows > 0 ? cfg.rows : 8;
+    float line_height = claykit_text_area_line_height(style);
+
+    Clay__OpenElement();
+    bool hovered = Clay_Hovered();
+
+    /* Outer container, sized to exactly rows lines */
+    Clay_ElementDeclaration outer_decl = {0};
+    if (id != NULL && id_len > 0) {
+        Clay_String id_str = { false, id_len, id };
+        outer_decl.id = Clay__HashString(id_str, 0, 0);
+    }
+    if (cfg.width > 0) {
+        outer_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_FIXED;
+        outer_decl.layout.sizing.width.size.minMax.min = (float)cfg.width;
+        outer_decl.layout.sizing.width.size.minMax.max = (float)cfg.width;
+    } else {
+        outer_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_GROW;
+    }
+    float height = (float)rows * line_height + 2.0f * (float)style.padding_y;
+    outer_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIXED;
+    outer_decl.layout.sizing.height.size.minMax.min = height;
+    outer_decl.layout.sizing.height.size.minMax.max = height;
+    outer_decl.layout.padding.left = style.padding_x;
+    outer_decl.layout.padding.right = style.padding_x;
+    outer_decl.layout.padding.top = style.padding_y;
+    outer_decl.layout.padding.bottom = style.padding_y;
+    outer_decl.backgroundColor = style.bg_color;
+    outer_decl.cornerRadius.topLeft = (float)style.corner_radius;
+    outer_decl.cornerRadius.topRight = (float)style.corner_radius;
+    outer_decl.cornerRadius.bottomLeft = (float)style.corner_radius;
+    outer_decl.cornerRadius.bottomRight = (float)style.corner_radius;
+    outer_decl.border.color = style.border_color;
+    outer_decl.border.width.left = 1;
+    outer_decl.border.width.right = 1;
+    outer_decl.border.width.top = 1;
+    outer_decl.border.width.bottom = 1;
+
+    Clay__ConfigureOpenElement(outer_decl);
+
+    uint32_t cursor_pos = state->cursor;
+    if (cursor_pos > state->len) cursor_pos = state->len;
+    uint32_t line_count = ClayKit_InputLineCount(state);
+    uint32_t cursor_line = ClayKit_InputLineAt(state, cursor_pos);
+
+    /* Scroll in whole lines, kept in the element's state, just enough to
+     * keep the cursor's line visible */
+    uint32_t first = 0;
+    ClayKit_State *vs = outer_decl.id.id != 0 ? ClayKit_GetOrCreateState(ctx, outer_decl.id.id) : NULL;
+    if (vs) first = (uint32_t)vs->value;
+    if (cursor_line < first) first = cursor_line;
+    if (cursor_line >= first + rows) first = cursor_line - rows + 1;
+    if (first + rows > line_count) first = line_count > rows ? line_count - rows : 0;
+    if (vs) vs->value = (float)first;
+    if (state->lines) state->lines->page = rows;
+    uint32_t last = first + rows < line_count ? first + rows : line_count;
+
+    /* Long lines scroll sideways to the cursor, using last frame's width */
+    Clay_ElementData prev = Clay_GetElementData(outer_decl.id);
+    float view = prev.found ? prev.boundingBox.width - 2.0f * (float)style.padding_x - (float)style.cursor_width : 0.0f;
+    float scroll_x = claykit_text_area_scroll_x(ctx, state, style, cursor_pos, view);
+
+    /* Clipped viewport holding one row per visible line */
+    Clay_ElementDeclaration view_decl = {0};
+    view_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_GROW;
+    view_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_GROW;
+    view_decl.layout.layoutDirection = CLAY_TOP_TO_BOTTOM;
+    view_decl.clip.horizontal = true;
+    view_decl.clip.vertical = true;
+    view_decl.clip.childOffset.x = -scroll_x;
+
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(view_decl);
+
+    Clay_ElementDeclaration row_decl = {0};
+    row_decl.layout.sizing.width.type = CLAY__SIZING_TYPE_FIT;
+    row_decl.layout.sizing.height.type = CLAY__SIZING_TYPE_FIXED;
+    row_decl.layout.sizing.height.size.minMax.min = line_height;
+    row_decl.layout.sizing.height.size.minMax.max = line_height;
+    row_decl.layout.layoutDirection = CLAY_LEFT_TO_RIGHT;
+    row_decl.layout.childAlignment.y = CLAY_ALIGN_Y_CENTER;
+
+    Clay_TextElementConfig text_config = {0};
+    text_config.fontSize = style.font_size;
+    text_config.fontId = style.font_id;
+    text_config.wrapMode = CLAY_TEXT_WRAP_NONE;
+    text_config.textColor = style.text_color;
+
+    /* Rows go in text order, so the gap moves forward at most once */
+    for (uint32_t line = first; line < last; line++) {
+        Clay__OpenElement();
+        Clay__ConfigureOpenElement(row_decl);
+        if (state->len == 0 && !focused && placeholder != NULL && placeholder_len > 0) {
             Clay_String placeholder_str = { false, placeholder_len, placeholder };
             text_config.textColor = style.placeholder_color;
             Clay__OpenTextElement(placeholder_str, Clay__StoreTextElementConfig(text_config));
+            text_config.textColor = style.text_color;
+        } else {
+            claykit_input_runs(state, style, ClayKit_InputLineStart(state, line), ClayKit_InputLineEnd(state, line),
+                               focused, show_cursor, text_config);
         }
+        Clay__CloseElement();
     }
 
-    Clay__CloseElement(); /* inner */
+    Clay__CloseElement(); /* viewport */
     Clay__CloseElement(); /* outer */
     return hovered;
 }
 
+/* Text offset under (x, y) given the area's last bounding box */
+static uint32_t claykit_text_area_hit(ClayKit_Context *ctx, ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                                      Clay_ElementId elem_id, Clay_BoundingBox box, float x, float y) {
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(ctx, cfg, (state->flags & CLAYKIT_INPUT_FOCUSED) != 0);
+    float line_height = claykit_text_area_line_height(style);
+    uint32_t cursor_pos = state->cursor;
+    if (cursor_pos > state->len) cursor_pos = state->len;
+
+    /* Same scroll as the last ClayKit_TextArea call */
+    ClayKit_State *vs = ClayKit_GetState(ctx, elem_id.id);
+    uint32_t first = vs ? (uint32_t)vs->value : 0;
+    float view = box.width - 2.0f * (float)style.padding_x - (float)style.cursor_width;
+    float scroll_x = claykit_text_area_scroll_x(ctx, state, style, cursor_pos, view);
+
+    /* Rows outside the area continue the line grid in both directions */
+    float local_y = y - box.y - (float)style.padding_y;
+    uint32_t count = ClayKit_InputLineCount(state);
+    uint32_t line;
+    if (local_y < 0.0f) {
+        uint32_t above = (uint32_t)(-local_y / line_height) + 1;
+        line = above < first ? first - above : 0;
+    } else {
+        uint32_t row = (uint32_t)(local_y / line_height);
+        line = row < count - first ? first + row : count - 1;
+    }
+
+    uint32_t start = ClayKit_InputLineStart(state, line);
+    uint32_t end = ClayKit_InputLineEnd(state, line);
+    float local_x = x - box.x - (float)style.padding_x + scroll_x;
+    return claykit_input_hit_range(ctx, state, style.font_id, style.font_size, start, end, local_x);
+}
+
+uint32_t ClayKit_TextAreaHitTest(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                                 ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                                 float x, float y) {
+    if (id == NULL || id_len <= 0) return state->cursor;
+    Clay_String id_str = { false, id_len, id };
+    Clay_ElementId elem_id = Clay__HashString(id_str, 0, 0);
+    Clay_ElementData elem = Clay_GetElementData(elem_id);
+    if (!elem.found) return state->cursor;
+    return claykit_text_area_hit(ctx, state, cfg, elem_id, elem.boundingBox, x, y);
+}
+
+bool ClayKit_TextAreaPointer(ClayKit_Context *ctx, const char *id, int32_t id_len,
+                             ClayKit_InputState *state, ClayKit_InputConfig cfg,
+                             float x, float y, bool pressed, bool down, uint32_t mods) {
+    uint32_t cursor = state->cursor;
+    uint32_t select_start = state->select_start;
+    uint8_t flags = state->flags;
+    Clay_BoundingBox box;
+    bool repeat = false;
+    if (claykit_input_pointer(ctx, state, id, id_len, x, y, pressed, down, &box, &repeat)) {
+        Clay_String id_str = { false, id_len, id };
+        uint32_t hit = claykit_text_area_hit(ctx, state, cfg, Clay__HashString(id_str, 0, 0), box, x, y);
+        claykit_input_pointer_move(state, hit, pressed, repeat, mods);
+    }
+    return state->cursor != cursor || state->select_start != select_start
+        || ((state->flags ^ flags) & CLAYKIT_INPUT_FOCUSED) != 0;
+}
+
 /* ----------------------------------------------------------------------------
  * Link
  * ---------------------------------------------------------------------------- */
 
-ClayKit_LinkStyle ClayKit_ComputeLinkStyle(ClayKit_Context *ctx, ClayKit_LinkConfig cfg) {
+static ClayKit_LinkStyle claykit_compute_link_style(ClayKit_Context *ctx, ClayKit_LinkConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_LinkStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     style.text_color = scheme_color;
     style.hover_color = claykit_color_darken(scheme_color, 0.15f);
     style.disabled_color = theme->muted;
-    style.font_size = ClayKit_GetFontSize(theme, cfg.size);
+    style.font_size = claykit_font_size(ctx, cfg.size);
     style.font_id = theme->font_id.body;
     style.underline_height = 1;
 
     return style;
 }
 
+ClayKit_LinkStyle ClayKit_ComputeLinkStyle(ClayKit_Context *ctx, ClayKit_LinkConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_LinkStyle, CLAYKIT_STYLE_LINK, 0, cfg,
+                         claykit_compute_link_style(ctx, cfg));
+}
+
 bool ClayKit_Link(ClayKit_Context *ctx, const char *text, int32_t text_len, ClayKit_LinkConfig cfg) {
     ClayKit_LinkStyle style = ClayKit_ComputeLinkStyle(ctx, cfg);
 
@@ -4205,17 +7516,17 @@ bool ClayKit_Link(ClayKit_Context *ctx, const char *text, int32_t text_len, Clay
  * Breadcrumb
  * ---------------------------------------------------------------------------- */
 
-ClayKit_BreadcrumbStyle ClayKit_ComputeBreadcrumbStyle(ClayKit_Context *ctx, ClayKit_BreadcrumbConfig cfg) {
+static ClayKit_BreadcrumbStyle claykit_compute_breadcrumb_style(ClayKit_Context *ctx, ClayKit_BreadcrumbConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_BreadcrumbStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     style.link_color = scheme_color;
     style.hover_color = claykit_color_darken(scheme_color, 0.15f);
     style.current_color = theme->fg;
     style.separator_color = theme->muted;
-    style.font_size = ClayKit_GetFontSize(theme, cfg.size);
+    style.font_size = claykit_font_size(ctx, cfg.size);
     style.font_id = theme->font_id.body;
 
     switch (cfg.size) {
@@ -4230,6 +7541,11 @@ ClayKit_BreadcrumbStyle ClayKit_ComputeBreadcrumbStyle(ClayKit_Context *ctx, Cla
     return style;
 }
 
+ClayKit_BreadcrumbStyle ClayKit_ComputeBreadcrumbStyle(ClayKit_Context *ctx, ClayKit_BreadcrumbConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_BreadcrumbStyle, CLAYKIT_STYLE_BREADCRUMB, 0, cfg,
+                         claykit_compute_breadcrumb_style(ctx, cfg));
+}
+
 void ClayKit_BreadcrumbBegin(ClayKit_Context *ctx, ClayKit_BreadcrumbConfig cfg) {
     ClayKit_BreadcrumbStyle style = ClayKit_ComputeBreadcrumbStyle(ctx, cfg);
 
@@ -4300,11 +7616,11 @@ void ClayKit_BreadcrumbEnd(void) {
  * Accordion
  * ---------------------------------------------------------------------------- */
 
-ClayKit_AccordionStyle ClayKit_ComputeAccordionStyle(ClayKit_Context *ctx, ClayKit_AccordionConfig cfg) {
+static ClayKit_AccordionStyle claykit_compute_accordion_style(ClayKit_Context *ctx, ClayKit_AccordionConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_AccordionStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     style.header_bg = theme->bg;
     style.header_hover_bg = claykit_color_darken(theme->bg, 0.03f);
@@ -4351,7 +7667,7 @@ ClayKit_AccordionStyle ClayKit_ComputeAccordionStyle(ClayKit_Context *ctx, ClayK
     style.border_width = 1;
 
     if (cfg.variant == CLAYKIT_ACCORDION_SEPARATED) {
-        style.corner_radius = ClayKit_GetRadius(theme, cfg.size);
+        style.corner_radius = claykit_radius(ctx, cfg.size);
         style.gap = 8;
     } else {
         style.corner_radius = 0;
@@ -4361,6 +7677,11 @@ ClayKit_AccordionStyle ClayKit_ComputeAccordionStyle(ClayKit_Context *ctx, ClayK
     return style;
 }
 
+ClayKit_AccordionStyle ClayKit_ComputeAccordionStyle(ClayKit_Context *ctx, ClayKit_AccordionConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_AccordionStyle, CLAYKIT_STYLE_ACCORDION, 0, cfg,
+                         claykit_compute_accordion_style(ctx, cfg));
+}
+
 void ClayKit_AccordionBegin(ClayKit_Context *ctx, ClayKit_AccordionConfig cfg) {
     ClayKit_AccordionStyle style = ClayKit_ComputeAccordionStyle(ctx, cfg);
 
@@ -4520,11 +7841,11 @@ void ClayKit_AccordionEnd(void) {
  * Menu
  * ---------------------------------------------------------------------------- */
 
-ClayKit_MenuStyle ClayKit_ComputeMenuStyle(ClayKit_Context *ctx, ClayKit_MenuConfig cfg) {
+static ClayKit_MenuStyle claykit_compute_menu_style(ClayKit_Context *ctx, ClayKit_MenuConfig cfg) {
     ClayKit_Theme *theme = ctx->theme_ptr;
     ClayKit_MenuStyle style;
 
-    Clay_Color scheme_color = ClayKit_GetSchemeColor(theme, cfg.color_scheme);
+    Clay_Color scheme_color = claykit_scheme_color(ctx, cfg.color_scheme);
 
     style.bg_color = theme->bg;
     style.border_color = theme->border;
@@ -4533,7 +7854,7 @@ ClayKit_MenuStyle ClayKit_ComputeMenuStyle(ClayKit_Context *ctx, ClayKit_MenuCon
     style.hover_bg = claykit_color_lighten(scheme_color, 0.9f);
     style.separator_color = theme->border;
     style.font_id = theme->font_id.body;
-    style.corner_radius = ClayKit_GetRadius(theme, cfg.size);
+    style.corner_radius = claykit_radius(ctx, cfg.size);
 
     switch (cfg.size) {
         case CLAYKIT_SIZE_XS:
@@ -4582,6 +7903,11 @@ ClayKit_MenuStyle ClayKit_ComputeMenuStyle(ClayKit_Context *ctx, ClayKit_MenuCon
     return style;
 }
 
+ClayKit_MenuStyle ClayKit_ComputeMenuStyle(ClayKit_Context *ctx, ClayKit_MenuConfig cfg) {
+    CLAYKIT_CACHED_STYLE(ctx, ClayKit_MenuStyle, CLAYKIT_STYLE_MENU, 0, cfg,
+                         claykit_compute_menu_style(ctx, cfg));
+}
+
 void ClayKit_MenuDropdownBegin(ClayKit_Context *ctx, const char *id, int32_t id_len, ClayKit_MenuConfig cfg) {
     ClayKit_MenuStyle style = ClayKit_ComputeMenuStyle(ctx, cfg);
 
@@ -173,6 +173,65 @@ pub const MeasureTextCallback = ?*const fn (
     user_data: ?*anyopaque,
 ) callconv(.c) TextDimensions;
 
+/// One text to measure in a batch; text[0..length] is not null-terminated
+pub const MeasureRequest = extern struct {
+    text: [*c]const u8 = null,
+    length: u32 = 0,
+    font_id: u16 = 0,
+    font_size: u16 = 0,
+
+    pub fn init(text: []const u8, font_id: u16, font_size: u16) MeasureRequest {
+        return .{ .text = text.ptr, .length = @intCast(text.len), .font_id = font_id, .font_size = font_size };
+    }
+};
+
+/// Measures requests[0..count] into out[0..count]. The requests are
+/// independent, so a backend can look up each font once or split a batch
+/// across threads.
+pub const MeasureTextBatchCallback = ?*const fn (
+    requests: [*c]const MeasureRequest,
+    out: [*c]TextDimensions,
+    count: u32,
+    user_data: ?*anyopaque,
+) callconv(.c) void;
+
+/// Returns a time in seconds
+pub const ClockCallback = ?*const fn () callconv(.c) f64;
+
+/// Kerning adjustment added between codepoints left and right
+pub const KerningPair = extern struct {
+    left: u32 = 0,
+    right: u32 = 0,
+    amount: f32 = 0,
+};
+
+/// Advance widths of one font at one size, measured without the callback.
+/// The struct and its slices must outlive the registration.
+pub const FontMetrics = extern struct {
+    font_id: u16 = 0,
+    font_size: u16 = 0,
+    first: u32 = 0, // codepoint of advances[0], e.g. 32
+    count: u32 = 0, // entries in advances
+    advances: ?[*]const f32 = null, // advances[cp - first]: width of codepoint cp
+    fallback: f32 = 0, // width of codepoints outside the table
+    kerning: ?[*]const KerningPair = null, // sorted by (left, right)
+    kerning_count: u32 = 0,
+    next: ?*FontMetrics = null, // set by registerFontMetrics
+
+    pub fn init(font_id: u16, font_size: u16, first: u32, advances: []const f32, fallback: f32, kerning: []const KerningPair) FontMetrics {
+        return .{
+            .font_id = font_id,
+            .font_size = font_size,
+            .first = first,
+            .count = @intCast(advances.len),
+            .advances = advances.ptr,
+            .fallback = fallback,
+            .kerning = kerning.ptr,
+            .kerning_count = @intCast(kerning.len),
+        };
+    }
+};
+
 // ============================================================================
 // ClayKit Component State
 // ============================================================================
@@ -181,6 +240,79 @@ pub const State = extern struct {
     id: u32 = 0,
     flags: u32 = 0, // component-specific bits
     value: f32 = 0, // for sliders, progress, etc.
+    frame: u32 = 0, // ctx.frame when last looked up
+    blob: u32 = 0, // state pool handle (0 = none)
+};
+
+pub const pool_class_count = 5;
+pub const pool_max_blob = 256;
+
+/// Size-class bucketed pool for per-element state blobs (see setStatePool)
+pub const StatePool = extern struct {
+    pages: ?[*]u8 = null,
+    page_class: ?[*]u8 = null,
+    page_live: ?[*]u8 = null,
+    page_count: u32 = 0,
+    pages_used: u32 = 0,
+    free_head: [pool_class_count]u32 = [_]u32{0} ** pool_class_count,
+    free_pages: u32 = 0,
+    free_page_count: u32 = 0,
+    blob_count: u32 = 0,
+};
+
+// ============================================================================
+// ClayKit Stats
+// ============================================================================
+
+/// Usage of one fixed-capacity pool, per frame and all-time
+pub const PoolStats = extern struct {
+    used: u32 = 0,
+    capacity: u32 = 0, // 0 = bounded only by the frame arena
+    frame_peak: u32 = 0,
+    peak: u32 = 0,
+    frame_overflows: u32 = 0,
+    overflows: u32 = 0,
+};
+
+/// Text measurement counters, for one frame or all time
+pub const MeasureStats = extern struct {
+    calls: u64 = 0, // measure callback calls, a batch counts once
+    texts: u64 = 0, // texts measured, by the callbacks or font metrics
+    bytes: u64 = 0,
+    seconds: f64 = 0, // time in the callbacks, see setMeasureClock
+    clay_lookups: u64 = 0, // Clay measure-cache lookups, see endFrame
+    clay_misses: u64 = 0, // lookups Clay had to measure text for
+};
+
+pub const Stats = extern struct {
+    state_slots: PoolStats = .{},
+    state_pool_pages: PoolStats = .{},
+    frame_arena: PoolStats = .{},
+    icons: PoolStats = .{},
+    list_numbers: PoolStats = .{},
+    clay_elements: PoolStats = .{}, // see endFrame
+    clay_measure_words: PoolStats = .{},
+    style_cache_hits: u64 = 0, // see setStyleCache
+    style_cache_misses: u64 = 0,
+    measure_frame: MeasureStats = .{}, // reset by beginFrame
+    measure: MeasureStats = .{}, // reset by resetStats
+};
+
+/// Mirrors Clay_ErrorData
+pub const ErrorData = extern struct {
+    error_type: c_int,
+    error_text: extern struct {
+        is_statically_allocated: bool,
+        length: i32,
+        chars: [*c]const u8,
+    },
+    user_data: ?*anyopaque,
+};
+
+/// Mirrors Clay_ErrorHandler
+pub const ErrorHandler = extern struct {
+    function: ?*const fn (ErrorData) callconv(.c) void = null,
+    user_data: ?*anyopaque = null,
 };
 
 // ============================================================================
@@ -250,10 +382,37 @@ pub const Theme = extern struct {
     };
 };
 
+pub const size_count = 5;
+pub const color_scheme_count = 5;
+
+/// Theme flattened into tables indexed by Size or ColorScheme, see compileTheme
+pub const CompiledTheme = extern struct {
+    source: ?*const Theme = null,
+    generation: u32 = 0,
+    scheme: [color_scheme_count]Color = [_]Color{.{}} ** color_scheme_count,
+    scheme_hover: [color_scheme_count]Color = [_]Color{.{}} ** color_scheme_count,
+    spacing: [size_count]u16 = [_]u16{0} ** size_count,
+    font_size: [size_count]u16 = [_]u16{0} ** size_count,
+    radius: [size_count]u16 = [_]u16{0} ** size_count,
+    heading_font_size: [size_count]u16 = [_]u16{0} ** size_count,
+    button_pad_x: [size_count]u16 = [_]u16{0} ** size_count,
+    button_pad_y: [size_count]u16 = [_]u16{0} ** size_count,
+    input_pad_x: [size_count]u16 = [_]u16{0} ** size_count,
+    input_pad_y: [size_count]u16 = [_]u16{0} ** size_count,
+    checkbox_size: [size_count]u16 = [_]u16{0} ** size_count,
+    switch_width: [size_count]u16 = [_]u16{0} ** size_count,
+    switch_height: [size_count]u16 = [_]u16{0} ** size_count,
+    switch_knob_size: [size_count]u16 = [_]u16{0} ** size_count,
+};
+
 // ============================================================================
 // ClayKit Context
 // ============================================================================
 
+/// Memoized component style; its layout is private to the C side, size
+/// buffers with computeMemoryRequirements (style_cache_bytes)
+pub const StyleCacheEntry = opaque {};
+
 pub const Context = extern struct {
     theme_ptr: ?*Theme = null,
     state_ptr: ?[*]State = null,
@@ -265,25 +424,133 @@ pub const Context = extern struct {
     icon_user_data: ?*anyopaque = null,
     measure_text: MeasureTextCallback = null,
     measure_text_user_data: ?*anyopaque = null,
+    font_metrics: ?*FontMetrics = null, // see registerFontMetrics
+    measure_text_batch: MeasureTextBatchCallback = null, // see setMeasureTextBatch
+    measure_text_batch_user_data: ?*anyopaque = null,
+    measure_clock: ClockCallback = null, // see setMeasureClock
     cursor_blink_time: f32 = 0,
+    frame: u32 = 0, // frame generation, advanced by beginFrame
+    state_max_age: u32 = 0, // if non-zero, beginFrame evicts states unused for this many frames
+
+    // Frame arena for transient per-frame data, reset by beginFrame
+    frame_arena: ?[*]u8 = null,
+    frame_arena_cap: u32 = 0,
+    frame_arena_used: u32 = 0,
+
+    state_pool: StatePool = .{},
+
+    stats: Stats = .{}, // pool usage and overflow telemetry
+    clay_error_handler: ErrorHandler = .{}, // forwarded to by clayErrorHandler
+
+    style_cache: ?*StyleCacheEntry = null, // see setStyleCache
+    style_cache_cap: u32 = 0,
+    theme_generation: u32 = 0, // bumped by themeChanged
+
+    compiled_theme: CompiledTheme = .{}, // lookup tables for theme_ptr, see compileTheme
 
     pub fn theme(self: *Context) *Theme {
         return self.theme_ptr.?;
     }
 
+    /// Set the measure callback for ClayKit and, once Clay is initialized,
+    /// for Clay too: both then measure through it and the registered font
+    /// metrics. The callback gets text in place, without a NUL terminator.
     pub fn setMeasureText(self: *Context, callback: MeasureTextCallback, user_data: ?*anyopaque) void {
-        self.measure_text = callback;
-        self.measure_text_user_data = user_data;
+        ClayKit_SetMeasureText(self, callback, user_data);
     }
 
-    /// Measure text width using the configured callback
+    /// Measure text from the registered font metrics for font_id and
+    /// font_size, falling back to the configured callback
     pub fn measureTextWidth(self: *Context, text: []const u8, font_id: u16, font_size: u16) f32 {
-        if (self.measure_text) |callback| {
-            const dims = callback(text.ptr, @intCast(text.len), font_id, font_size, self.measure_text_user_data);
-            return dims.width;
-        }
-        return 0;
+        return ClayKit_MeasureTextWidth(self, text.ptr, @intCast(text.len), font_id, font_size);
+    }
+
+    /// Measure text in metrics.font_id at metrics.font_size from its advance
+    /// table instead of the callback. Replaces an earlier table for the same
+    /// font and size.
+    pub fn registerFontMetrics(self: *Context, metrics: *FontMetrics) void {
+        ClayKit_RegisterFontMetrics(self, metrics);
+    }
+
+    /// Set an optional batch callback. Hit-testing and advance cache fills
+    /// then measure several texts per call; it also stands in for the
+    /// single callback when that is not set.
+    pub fn setMeasureTextBatch(self: *Context, callback: MeasureTextBatchCallback, user_data: ?*anyopaque) void {
+        ClayKit_SetMeasureTextBatch(self, callback, user_data);
     }
+
+    /// Measure each request into out, sending the ones without registered
+    /// font metrics to the batch callback
+    pub fn measureTextBatch(self: *Context, requests: []const MeasureRequest, out: []TextDimensions) void {
+        std.debug.assert(out.len >= requests.len);
+        ClayKit_MeasureTextBatch(self, requests.ptr, out.ptr, @intCast(requests.len));
+    }
+};
+
+// ============================================================================
+// ClayKit Memory Planning
+// ============================================================================
+
+/// Expected number of each component per frame
+pub const MemoryCounts = extern struct {
+    containers: u32 = 0, // app-owned Clay elements
+    texts: u32 = 0, // app-owned text elements
+    truncated_texts: u32 = 0, // textTruncated calls
+    badges: u32 = 0,
+    tags: u32 = 0,
+    stats: u32 = 0,
+    lists: u32 = 0,
+    list_items: u32 = 0,
+    ordered_list_items: u32 = 0, // subset of list_items in ordered lists
+    tables: u32 = 0,
+    table_rows: u32 = 0, // including header rows
+    table_cells: u32 = 0, // including header cells
+    buttons: u32 = 0,
+    icons: u32 = 0, // button and alert icons
+    checkboxes: u32 = 0,
+    radios: u32 = 0,
+    switches: u32 = 0,
+    sliders: u32 = 0,
+    progress_bars: u32 = 0,
+    spinners: u32 = 0,
+    alerts: u32 = 0,
+    tooltips: u32 = 0,
+    tabs: u32 = 0,
+    links: u32 = 0,
+    breadcrumbs: u32 = 0,
+    breadcrumb_items: u32 = 0, // each with its separator
+    accordions: u32 = 0,
+    accordion_items: u32 = 0,
+    menus: u32 = 0,
+    menu_items: u32 = 0, // including separators
+    selects: u32 = 0,
+    select_options: u32 = 0,
+    text_inputs: u32 = 0,
+    text_areas: u32 = 0,
+    text_area_rows: u32 = 0, // visible rows across all text areas
+    drawers: u32 = 0,
+    popovers: u32 = 0,
+    words_per_text: u32 = 0, // average words per text element (0 = 3)
+    stateful_elements: u32 = 0, // ids used with getOrCreateState or state blobs
+    state_blobs: u32 = 0, // state blobs alive at once
+    state_blob_size: u32 = 0, // largest state blob in bytes
+    style_cache_entries: u32 = 0, // entries for setStyleCache, 0 = no cache
+};
+
+/// Budgets derived from MemoryCounts
+pub const MemoryRequirements = extern struct {
+    elements: u32 = 0, // Clay layout elements per frame, text included
+    element_configs: u32 = 0, // Clay element configs per frame
+    text_elements: u32 = 0, // Clay text elements per frame
+    clay_max_elements: u32 = 0, // for Clay_SetMaxElementCount
+    clay_measure_words: u32 = 0, // for Clay_SetMaxMeasureTextCacheWordCount
+    clay_bytes: u32 = 0, // Clay_MinMemorySize() with the two settings above, 0 unless built with CLAY_IMPLEMENTATION
+    state_slots: u32 = 0, // State buffer length
+    state_bytes: u32 = 0,
+    state_pool_bytes: u32 = 0, // for setStatePool
+    frame_arena_bytes: u32 = 0, // for setFrameArena
+    style_cache_bytes: u32 = 0, // for setStyleCache
+    total_bytes: u32 = 0,
 };
 
 // ============================================================================
@@ -311,6 +578,8 @@ pub const InputFlags = enum(u8) {
     password = 1 << 1,
     readonly = 1 << 2,
     disabled = 1 << 3,
+    gap_buffer = 1 << 4, // set by setGapBuffer
+    dragging = 1 << 5, // pointer pressed in the input and still down
 };
 
 pub const Key = enum(c_int) {
@@ -323,6 +592,12 @@ pub const Key = enum(c_int) {
     end = 6,
     enter = 7,
     tab = 8,
+    z = 9, // ctrl+z undo, ctrl+shift+z redo
+    y = 10, // ctrl+y redo
+    up = 11, // multi-line inputs only
+    down = 12,
+    page_up = 13,
+    page_down = 14,
 };
 
 pub const Modifier = enum(c_int) {
@@ -336,6 +611,43 @@ pub const Modifier = enum(c_int) {
 // ClayKit Text Input State
 // ============================================================================
 
+/// Undo history ring for a text input, in caller-provided memory
+pub const InputHistory = extern struct {
+    buf: ?[*]u8 = null,
+    cap: u32 = 0,
+    start: u32 = 0, // ring offset of the oldest entry
+    undo_len: u32 = 0, // bytes of entries that can be undone
+    redo_len: u32 = 0, // bytes of undone entries after them
+    open: bool = false, // typing may extend the newest entry
+};
+
+/// Cached prefix widths for hit-testing a text input, in caller-provided memory
+pub const InputAdvanceCache = extern struct {
+    x: ?[*]f32 = null, // x[i]: width of the first i bytes
+    cap: u32 = 0, // entries in x; caches text of up to cap - 1 bytes
+    valid: u32 = 0, // leading entries of x that are up to date
+    font_id: u16 = 0,
+    font_size: u16 = 0,
+};
+
+/// Line starts of a multi-line text, in caller-provided memory
+pub const InputLineIndex = extern struct {
+    starts: ?[*]u32 = null,
+    cap: u32 = 0, // the most lines the text can have
+    count: u32 = 0, // lines in the text, at least 1
+    gap: u32 = 0, // entries before the gap hold offsets, after it distances from the end
+    page: u32 = 0, // lines moved by page up/down, set by textArea
+};
+
+/// Merged range changed by the edits since the delta was last taken:
+/// [start, start + removed) of the old text became [start, start + inserted)
+pub const InputDelta = extern struct {
+    start: u32 = 0,
+    removed: u32 = 0, // bytes replaced, counted in the old text
+    inserted: u32 = 0, // bytes in their place, counted in the new text
+    edits: u32 = 0, // edits merged in, 0 if the text is unchanged
+};
+
 pub const InputState = extern struct {
     buf: [*c]u8 = null,
     cap: u32 = 0,
@@ -343,6 +655,11 @@ pub const InputState = extern struct {
     cursor: u32 = 0,
     select_start: u32 = 0, // == cursor when no selection
     flags: u8 = 0,
+    gap: u32 = 0, // gap-buffer mode: logical offset of the gap
+    history: ?*InputHistory = null, // optional undo history
+    advances: ?*InputAdvanceCache = null, // optional hit-test cache
+    lines: ?*InputLineIndex = null, // optional line index, makes the input multi-line
+    delta: ?*InputDelta = null, // optional edit delta
 
     /// Initialize input state with a buffer
     pub fn init(buf: []u8) InputState {
@@ -353,13 +670,86 @@ pub const InputState = extern struct {
             .cursor = 0,
             .select_start = 0,
             .flags = 0,
+            .gap = 0,
+            .history = null,
+            .advances = null,
+            .lines = null,
+            .delta = null,
         };
     }
 
-    /// Get current text as a slice
-    pub fn text(self: *const InputState) []const u8 {
+    /// Get current text as a slice. In gap-buffer mode this closes the gap,
+    /// so the slice is only valid until the next edit.
+    pub fn text(self: *InputState) []const u8 {
         if (self.buf == null or self.len == 0) return "";
-        return self.buf[0..self.len];
+        return ClayKit_InputText(self)[0..self.len];
+    }
+
+    /// Switch to or from gap-buffer storage, which makes edits at the cursor
+    /// cost O(1) instead of shifting the rest of the text
+    pub fn setGapBuffer(self: *InputState, enabled: bool) void {
+        ClayKit_InputSetGapBuffer(self, enabled);
+    }
+
+    /// Attach an undo history backed by mem, or detach it with null
+    pub fn setHistory(self: *InputState, history: ?*InputHistory, mem: []u8) void {
+        ClayKit_InputSetHistory(self, history, mem.ptr, @intCast(mem.len));
+    }
+
+    /// Undo the last edit. Returns false when there is nothing to undo.
+    pub fn undo(self: *InputState) bool {
+        return ClayKit_InputUndo(self);
+    }
+
+    /// Redo the last undone edit. Returns false when there is nothing to redo.
+    pub fn redo(self: *InputState) bool {
+        return ClayKit_InputRedo(self);
+    }
+
+    /// Forget all history, e.g. after replacing the text directly
+    pub fn clearHistory(self: *InputState) void {
+        ClayKit_InputClearHistory(self);
+    }
+
+    /// Attach a prefix-width cache with one entry per byte of text plus one,
+    /// or detach it with null
+    pub fn setAdvanceCache(self: *InputState, cache: ?*InputAdvanceCache, mem: []f32) void {
+        ClayKit_InputSetAdvanceCache(self, cache, mem.ptr, @intCast(mem.len));
+    }
+
+    /// Attach an edit delta that every edit merges its changed range into,
+    /// or detach it with null
+    pub fn setDelta(self: *InputState, delta: ?*InputDelta) void {
+        ClayKit_InputSetDelta(self, delta);
+    }
+
+    /// Return the edits merged since the last take and start a new delta
+    pub fn takeDelta(self: *InputState) InputDelta {
+        return ClayKit_InputTakeDelta(self);
+    }
+
+    /// Attach a line index with room for mem.len lines, making the input
+    /// multi-line, or detach it with null. False if the text has more lines.
+    pub fn setLineIndex(self: *InputState, index: ?*InputLineIndex, mem: []u32) bool {
+        return ClayKit_InputSetLineIndex(self, index, mem.ptr, @intCast(mem.len));
+    }
+
+    pub fn lineCount(self: *const InputState) u32 {
+        return ClayKit_InputLineCount(self);
+    }
+
+    /// Line containing a byte offset
+    pub fn lineAt(self: *const InputState, offset: u32) u32 {
+        return ClayKit_InputLineAt(self, offset);
+    }
+
+    pub fn lineStart(self: *const InputState, line: u32) u32 {
+        return ClayKit_InputLineStart(self, line);
+    }
+
+    /// Offset of the line's newline, or len for the last line
+    pub fn lineEnd(self: *const InputState, line: u32) u32 {
+        return ClayKit_InputLineEnd(self, line);
     }
 
     /// Check if there is a selection
@@ -1006,6 +1396,7 @@ pub const InputConfig = extern struct {
     cursor_color: Color = .{}, // Cursor color (default: theme fg)
     selection_color: Color = .{}, // Selection bg (default: primary with alpha)
     width: u16 = 0, // Fixed width (0 = grow)
+    rows: u16 = 0, // Visible lines of a text area (0 = 8)
 };
 
 /// Input computed style
@@ -1031,6 +1422,33 @@ pub const InputStyle = extern struct {
 extern fn ClayKit_Init(ctx: *Context, theme: *Theme, state_buf: [*]State, state_cap: u32) void;
 extern fn ClayKit_GetState(ctx: *Context, id: u32) ?*State;
 extern fn ClayKit_GetOrCreateState(ctx: *Context, id: u32) ?*State;
+extern fn ClayKit_EvictStaleStates(ctx: *Context, max_age: u32) u32;
+
+extern fn ClayKit_SetStatePool(ctx: *Context, mem: ?*anyopaque, size: u32) void;
+extern fn ClayKit_GetStateBlob(ctx: *Context, id: u32, size: u32) ?*anyopaque;
+extern fn ClayKit_FindStateBlob(ctx: *Context, id: u32) ?*anyopaque;
+
+extern fn ClayKit_SetFrameArena(ctx: *Context, mem: ?*anyopaque, cap: u32) void;
+extern fn ClayKit_FrameAlloc(ctx: *Context, size: u32, alignment: u32) ?*anyopaque;
+
+extern fn ClayKit_ClayErrorHandler(ctx: *Context, user_handler: ErrorHandler) ErrorHandler;
+extern fn ClayKit_EndFrame(ctx: *Context) void;
+extern fn ClayKit_ResetStats(ctx: *Context) void;
+extern fn ClayKit_SetMeasureClock(ctx: *Context, clock: ClockCallback) void;
+extern fn ClayKit_RecommendClayMeasureWords(ctx: *const Context) u32;
+extern fn ClayKit_ResizeClayMeasureCache(ctx: *Context, words: u32, memory: ?*anyopaque, size: u32) u32;
+
+extern fn ClayKit_SetStyleCache(ctx: *Context, entries: ?*StyleCacheEntry, count: u32) void;
+extern fn ClayKit_RegisterFontMetrics(ctx: *Context, metrics: *FontMetrics) void;
+extern fn ClayKit_SetMeasureTextBatch(ctx: *Context, callback: MeasureTextBatchCallback, user_data: ?*anyopaque) void;
+extern fn ClayKit_MeasureTextBatch(ctx: *Context, requests: [*c]const MeasureRequest, out: [*c]TextDimensions, count: u32) void;
+extern fn ClayKit_SetMeasureText(ctx: *Context, callback: MeasureTextCallback, user_data: ?*anyopaque) void;
+extern fn ClayKit_ThemeChanged(ctx: *Context) void;
+
+extern fn ClayKit_SaveSnapshot(ctx: *Context, inputs: ?[*]const *InputState, input_count: u32, out: ?*anyopaque, out_cap: u32) u32;
+extern fn ClayKit_LoadSnapshot(ctx: *Context, inputs: ?[*]const *InputState, input_count: u32, data: ?*const anyopaque, size: u32) bool;
+
+extern fn ClayKit_ComputeMemoryRequirements(counts: *const MemoryCounts) MemoryRequirements;
 
 extern fn ClayKit_SetFocus(ctx: *Context, id: ElementId) void;
 extern fn ClayKit_ClearFocus(ctx: *Context) void;
@@ -1042,16 +1460,36 @@ extern fn ClayKit_BeginFrame(ctx: *Context) void;
 
 extern fn ClayKit_InputHandleKey(s: *InputState, key: u32, mods: u32) bool;
 extern fn ClayKit_InputHandleChar(s: *InputState, codepoint: u32) bool;
+extern fn ClayKit_InputSetGapBuffer(s: *InputState, enabled: bool) void;
+extern fn ClayKit_InputText(s: *InputState) [*]const u8;
+extern fn ClayKit_InputInsertText(s: *InputState, text: [*]const u8, len: u32) u32;
+extern fn ClayKit_InputSetHistory(s: *InputState, history: ?*InputHistory, mem: ?*anyopaque, size: u32) void;
+extern fn ClayKit_InputSetDelta(s: *InputState, delta: ?*InputDelta) void;
+extern fn ClayKit_InputTakeDelta(s: *InputState) InputDelta;
+extern fn ClayKit_InputClearHistory(s: *InputState) void;
+extern fn ClayKit_InputUndo(s: *InputState) bool;
+extern fn ClayKit_InputRedo(s: *InputState) bool;
+extern fn ClayKit_InputSetAdvanceCache(s: *InputState, cache: ?*InputAdvanceCache, mem: ?[*]f32, count: u32) void;
+extern fn ClayKit_InputSetLineIndex(s: *InputState, index: ?*InputLineIndex, mem: ?[*]u32, count: u32) bool;
+extern fn ClayKit_InputLineCount(s: *const InputState) u32;
+extern fn ClayKit_InputLineAt(s: *const InputState, offset: u32) u32;
+extern fn ClayKit_InputLineStart(s: *const InputState, line: u32) u32;
+extern fn ClayKit_InputLineEnd(s: *const InputState, line: u32) u32;
+extern fn ClayKit_InputReplaceRange(s: *InputState, start: u32, end: u32, text: [*]const u8, len: u32) u32;
+extern fn ClayKit_InputSelectWord(s: *InputState, offset: u32) void;
 
 extern fn ClayKit_GetSchemeColor(theme: *Theme, scheme: ColorScheme) Color;
 extern fn ClayKit_GetSpacing(theme: *Theme, size: Size) u16;
 extern fn ClayKit_GetFontSize(theme: *Theme, size: Size) u16;
 extern fn ClayKit_GetRadius(theme: *Theme, size: Size) u16;
+extern fn ClayKit_CompileTheme(theme: *Theme, out: *CompiledTheme) void;
 
 // Typography - note: these return Clay_TextElementConfig which is a zclay type
 // We expose simpler Zig wrappers below
 extern fn ClayKit_TextStyle(ctx: *Context, cfg: TextConfig) zclay.TextElementConfig;
 extern fn ClayKit_HeadingStyle(ctx: *Context, cfg: HeadingConfig) zclay.TextElementConfig;
+extern fn ClayKit_TruncateText(ctx: *Context, text: [*c]const u8, length: u32, config: zclay.TextElementConfig, max_width: f32) u32;
+extern fn ClayKit_TextTruncated(ctx: *Context, id: [*c]const u8, id_len: i32, text: [*c]const u8, text_len: i32, config: zclay.TextElementConfig) bool;
 // Badge functions
 extern fn ClayKit_ComputeBadgeStyle(ctx: *Context, cfg: BadgeConfig) BadgeStyle;
 extern fn ClayKit_BadgeRaw(ctx: *Context, text: [*c]const u8, text_len: i32, cfg: BadgeConfig) void;
@@ -1100,6 +1538,8 @@ extern fn ClayKit_InputBorderColor(ctx: *Context, cfg: InputConfig, focused: boo
 extern fn ClayKit_ComputeInputStyle(ctx: *Context, cfg: InputConfig, focused: bool) InputStyle;
 extern fn ClayKit_MeasureTextWidth(ctx: *Context, text: [*c]const u8, length: u32, font_id: u16, font_size: u16) f32;
 extern fn ClayKit_InputGetCursorFromX(ctx: *Context, text: [*c]const u8, length: u32, font_id: u16, font_size: u16, x_offset: f32) u32;
+extern fn ClayKit_InputHitTest(ctx: *Context, s: *InputState, font_id: u16, font_size: u16, x_offset: f32) u32;
+extern fn ClayKit_InputOffsetX(ctx: *Context, s: *InputState, font_id: u16, font_size: u16, offset: u32) f32;
 
 // Checkbox helper functions
 extern fn ClayKit_CheckboxSize(ctx: *Context, size: Size) u16;
@@ -1160,6 +1600,11 @@ extern fn ClayKit_Switch(ctx: *Context, on: bool, cfg: SwitchConfig) bool;
 extern fn ClayKit_Slider(ctx: *Context, value: f32, cfg: SliderConfig) bool;
 extern fn ClayKit_Tab(ctx: *Context, label: [*c]const u8, label_len: i32, is_active: bool, cfg: TabsConfig) bool;
 extern fn ClayKit_TextInput(ctx: *Context, id: [*c]const u8, id_len: i32, state: *InputState, cfg: InputConfig, placeholder: [*c]const u8, placeholder_len: i32) bool;
+extern fn ClayKit_TextInputScroll(ctx: *Context, id: [*c]const u8, id_len: i32) f32;
+extern fn ClayKit_TextArea(ctx: *Context, id: [*c]const u8, id_len: i32, state: *InputState, cfg: InputConfig, placeholder: [*c]const u8, placeholder_len: i32) bool;
+extern fn ClayKit_TextAreaHitTest(ctx: *Context, id: [*c]const u8, id_len: i32, state: *InputState, cfg: InputConfig, x: f32, y: f32) u32;
+extern fn ClayKit_TextInputPointer(ctx: *Context, id: [*c]const u8, id_len: i32, state: *InputState, cfg: InputConfig, x: f32, y: f32, pressed: bool, down: bool, mods: u32) bool;
+extern fn ClayKit_TextAreaPointer(ctx: *Context, id: [*c]const u8, id_len: i32, state: *InputState, cfg: InputConfig, x: f32, y: f32, pressed: bool, down: bool, mods: u32) bool;
 
 // Select helper functions
 extern fn ClayKit_ComputeSelectStyle(ctx: *Context, cfg: SelectConfig) SelectStyle;
@@ -1219,6 +1664,113 @@ pub fn getOrCreateState(ctx: *Context, id: u32) ?*State {
     return ClayKit_GetOrCreateState(ctx, id);
 }
 
+/// Free state slots not looked up for more than max_age frames, returns count freed
+pub fn evictStaleStates(ctx: *Context, max_age: u32) u32 {
+    return ClayKit_EvictStaleStates(ctx, max_age);
+}
+
+/// Provide memory for per-element state blobs
+pub fn setStatePool(ctx: *Context, mem: []u8) void {
+    ClayKit_SetStatePool(ctx, mem.ptr, @intCast(mem.len));
+}
+
+/// Get or create a zeroed state blob of type T for an element, null if the pool is full
+pub fn getStateBlob(ctx: *Context, id: u32, comptime T: type) ?*T {
+    comptime std.debug.assert(@sizeOf(T) <= pool_max_blob and @alignOf(T) <= 16);
+    const ptr = ClayKit_GetStateBlob(ctx, id, @sizeOf(T)) orelse return null;
+    return @ptrCast(@alignCast(ptr));
+}
+
+/// Find an existing state blob of type T, null if the element has none
+pub fn findStateBlob(ctx: *Context, id: u32, comptime T: type) ?*T {
+    const ptr = ClayKit_FindStateBlob(ctx, id) orelse return null;
+    return @ptrCast(@alignCast(ptr));
+}
+
+/// Provide memory for transient per-frame data (icon render data, list numbers)
+pub fn setFrameArena(ctx: *Context, mem: []u8) void {
+    ClayKit_SetFrameArena(ctx, mem.ptr, @intCast(mem.len));
+}
+
+/// Allocate from the frame arena, returns null when it is exhausted
+pub fn frameAlloc(ctx: *Context, size: u32, alignment: u32) ?*anyopaque {
+    return ClayKit_FrameAlloc(ctx, size, alignment);
+}
+
+/// Wrap a Clay error handler so capacity errors are counted in ctx.stats.
+/// Pass the result to Clay's initialize.
+pub fn clayErrorHandler(ctx: *Context, user_handler: ErrorHandler) ErrorHandler {
+    return ClayKit_ClayErrorHandler(ctx, user_handler);
+}
+
+/// Record Clay usage in ctx.stats, call after Clay's endLayout
+pub fn endFrame(ctx: *Context) void {
+    ClayKit_EndFrame(ctx);
+}
+
+/// Clear all-time peaks and overflow counters
+pub fn resetStats(ctx: *Context) void {
+    ClayKit_ResetStats(ctx);
+}
+
+/// Time measure callback calls into ctx.stats.measure*.seconds, null to stop
+pub fn setMeasureClock(ctx: *Context, clock: ClockCallback) void {
+    ClayKit_SetMeasureClock(ctx, clock);
+}
+
+/// Clay measure-cache word count for the busiest frame seen, 0 until
+/// endFrame has sampled one
+pub fn recommendClayMeasureWords(ctx: *const Context) u32 {
+    return ClayKit_RecommendClayMeasureWords(ctx);
+}
+
+/// Re-create the current Clay context with room for words measured words
+/// in memory. Without memory, returns the bytes needed. With it, resizes
+/// only when memory is large enough and returns the bytes used, or 0 if
+/// nothing changed (keep the old arena then). Clay's layout state starts
+/// over. Call between frames.
+pub fn resizeClayMeasureCache(ctx: *Context, words: u32, memory: ?[]u8) u32 {
+    if (memory) |m| {
+        return ClayKit_ResizeClayMeasureCache(ctx, words, m.ptr, @intCast(m.len));
+    }
+    return ClayKit_ResizeClayMeasureCache(ctx, words, null, 0);
+}
+
+/// Memoize the compute*Style functions in a caller-owned table of count
+/// entries. Pass null to turn the cache off.
+pub fn setStyleCache(ctx: *Context, entries: ?*StyleCacheEntry, count: u32) void {
+    ClayKit_SetStyleCache(ctx, entries, count);
+}
+
+/// Invalidate cached styles after editing the theme in place
+pub fn themeChanged(ctx: *Context) void {
+    ClayKit_ThemeChanged(ctx);
+}
+
+pub const snapshot_version = 1;
+
+/// Size of a snapshot of the state table, focus ids and inputs
+pub fn snapshotSize(ctx: *Context, inputs: []const *InputState) u32 {
+    return ClayKit_SaveSnapshot(ctx, inputs.ptr, @intCast(inputs.len), null, 0);
+}
+
+/// Write a snapshot into out, returns the bytes written or null if out is too small
+pub fn saveSnapshot(ctx: *Context, inputs: []const *InputState, out: []u8) ?[]u8 {
+    const size = ClayKit_SaveSnapshot(ctx, inputs.ptr, @intCast(inputs.len), out.ptr, @intCast(out.len));
+    if (size > out.len) return null;
+    return out[0..size];
+}
+
+/// Restore a snapshot, returns false (changing nothing) if it is invalid or does not fit
+pub fn loadSnapshot(ctx: *Context, inputs: []const *InputState, data: []const u8) bool {
+    return ClayKit_LoadSnapshot(ctx, inputs.ptr, @intCast(inputs.len), data.ptr, @intCast(data.len));
+}
+
+/// Compute Clay, state and arena budgets for an expected UI size
+pub fn computeMemoryRequirements(counts: MemoryCounts) MemoryRequirements {
+    return ClayKit_ComputeMemoryRequirements(&counts);
+}
+
 /// Set focus to an element
 pub fn setFocus(ctx: *Context, id: ElementId) void {
     ClayKit_SetFocus(ctx, id);
@@ -1264,25 +1816,51 @@ pub fn inputHandleChar(s: *InputState, codepoint: u32) bool {
     return ClayKit_InputHandleChar(s, codepoint);
 }
 
+/// Insert text at the cursor, replacing the selection. Truncates at capacity
+/// on a codepoint boundary and returns the number of bytes inserted.
+pub fn inputInsertText(s: *InputState, text: []const u8) u32 {
+    return ClayKit_InputInsertText(s, text.ptr, @intCast(text.len));
+}
+
+/// Replace the bytes in [start, end) with text. Returns the number of bytes inserted.
+pub fn inputReplaceRange(s: *InputState, start: u32, end: u32, text: []const u8) u32 {
+    return ClayKit_InputReplaceRange(s, start, end, text.ptr, @intCast(text.len));
+}
+
+/// Select the word, punctuation or whitespace run at offset.
+pub fn inputSelectWord(s: *InputState, offset: u32) void {
+    ClayKit_InputSelectWord(s, offset);
+}
+
 /// Get cursor position from x offset within text
 /// x_offset is the click position relative to the start of the text
 pub fn inputGetCursorFromX(ctx: *Context, text: []const u8, font_id: u16, font_size: u16, x_offset: f32) u32 {
     return ClayKit_InputGetCursorFromX(ctx, text.ptr, @intCast(text.len), font_id, font_size, x_offset);
 }
 
+/// Get the cursor position closest to x_offset in an input's text, using its
+/// advance cache when it has one
+pub fn inputHitTest(ctx: *Context, s: *InputState, font_id: u16, font_size: u16, x_offset: f32) u32 {
+    return ClayKit_InputHitTest(ctx, s, font_id, font_size, x_offset);
+}
+
+/// Get the x offset of a byte offset in an input's text
+pub fn inputOffsetX(ctx: *Context, s: *InputState, font_id: u16, font_size: u16, offset: u32) f32 {
+    return ClayKit_InputOffsetX(ctx, s, font_id, font_size, offset);
+}
+
 /// Handle click on text input - sets cursor position based on click x coordinate
 /// bounds: the bounding box of the input element
 /// click_x: the x coordinate of the click (screen space)
 /// state: the input state to update
 /// style: the computed input style (for padding and font info)
-pub fn inputHandleClick(ctx: *Context, state: *InputState, bounds: zclay.BoundingBox, click_x: f32, style: InputStyle) void {
-    // Calculate x offset relative to text start (after padding)
+pub fn inputHandleClick(ctx: *Context, state: *InputState, bounds: zclay.BoundingBox, click_x: f32, style: InputStyle, scroll: f32) void {
+    // Calculate x offset relative to text start (after padding and scroll)
     const text_start_x = bounds.x + @as(f32, @floatFromInt(style.padding_x));
-    const x_offset = click_x - text_start_x;
+    const x_offset = click_x - text_start_x + scroll;
 
     // Get cursor position from x offset
-    const text = state.text();
-    const new_cursor = inputGetCursorFromX(ctx, text, style.font_id, style.font_size, x_offset);
+    const new_cursor = inputHitTest(ctx, state, style.font_id, style.font_size, x_offset);
 
     // Update cursor and clear selection
     state.cursor = new_cursor;
@@ -1309,6 +1887,13 @@ pub fn getRadius(theme: *Theme, size: Size) u16 {
     return ClayKit_GetRadius(theme, size);
 }
 
+/// Flatten a theme into per-size and per-scheme lookup tables
+pub fn compileTheme(theme: *Theme) CompiledTheme {
+    var out: CompiledTheme = undefined;
+    ClayKit_CompileTheme(theme, &out);
+    return out;
+}
+
 /// Get a text style config for use with zclay.text()
 pub fn textStyle(ctx: *Context, cfg: TextConfig) zclay.TextElementConfig {
     return ClayKit_TextStyle(ctx, cfg);
@@ -1319,6 +1904,18 @@ pub fn headingStyle(ctx: *Context, cfg: HeadingConfig) zclay.TextElementConfig {
     return ClayKit_HeadingStyle(ctx, cfg);
 }
 
+/// Bytes of text that fit in max_width followed by an ellipsis, or
+/// text.len if all of it fits
+pub fn truncateText(ctx: *Context, text: []const u8, config: zclay.TextElementConfig, max_width: f32) usize {
+    return ClayKit_TruncateText(ctx, text.ptr, @intCast(text.len), config, max_width);
+}
+
+/// Text cut with an ellipsis to the width its growing element had last
+/// frame. Returns true if it was cut.
+pub fn textTruncated(ctx: *Context, id: []const u8, text: []const u8, config: zclay.TextElementConfig) bool {
+    return ClayKit_TextTruncated(ctx, id.ptr, @intCast(id.len), text.ptr, @intCast(text.len), config);
+}
+
 /// Compute badge style (for custom rendering)
 pub fn computeBadgeStyle(ctx: *Context, cfg: BadgeConfig) BadgeStyle {
     return ClayKit_ComputeBadgeStyle(ctx, cfg);
@@ -1538,6 +2135,33 @@ pub fn textInput(ctx: *Context, id: []const u8, state: *InputState, cfg: InputCo
     return ClayKit_TextInput(ctx, id.ptr, @intCast(id.len), state, cfg, placeholder.ptr, @intCast(placeholder.len));
 }
 
+/// Horizontal scroll of a text input, for mapping clicks to text offsets
+pub fn textInputScroll(ctx: *Context, id: []const u8) f32 {
+    return ClayKit_TextInputScroll(ctx, id.ptr, @intCast(id.len));
+}
+
+/// Render a multi-line text area showing cfg.rows lines of an input with a
+/// line index. Returns true if hovered.
+pub fn textArea(ctx: *Context, id: []const u8, state: *InputState, cfg: InputConfig, placeholder: []const u8) bool {
+    return ClayKit_TextArea(ctx, id.ptr, @intCast(id.len), state, cfg, placeholder.ptr, @intCast(placeholder.len));
+}
+
+/// Text offset under a pointer position in a text area rendered last frame
+pub fn textAreaHitTest(ctx: *Context, id: []const u8, state: *InputState, cfg: InputConfig, x: f32, y: f32) u32 {
+    return ClayKit_TextAreaHitTest(ctx, id.ptr, @intCast(id.len), state, cfg, x, y);
+}
+
+/// Press, focus and drag-selection for a text input; call before the layout.
+/// Returns true if the cursor, selection or focus changed.
+pub fn textInputPointer(ctx: *Context, id: []const u8, state: *InputState, cfg: InputConfig, x: f32, y: f32, pressed: bool, down: bool, mods: u32) bool {
+    return ClayKit_TextInputPointer(ctx, id.ptr, @intCast(id.len), state, cfg, x, y, pressed, down, mods);
+}
+
+/// textInputPointer for a text area; dragging past an edge scrolls
+pub fn textAreaPointer(ctx: *Context, id: []const u8, state: *InputState, cfg: InputConfig, x: f32, y: f32, pressed: bool, down: bool, mods: u32) bool {
+    return ClayKit_TextAreaPointer(ctx, id.ptr, @intCast(id.len), state, cfg, x, y, pressed, down, mods);
+}
+
 /// Compute select style (for custom rendering)
 pub fn computeSelectStyle(ctx: *Context, cfg: SelectConfig) SelectStyle {
     return ClayKit_ComputeSelectStyle(ctx, cfg);
@@ -65,12 +65,25 @@ static void icon_callback(uint16_t icon_id, Clay_BoundingBox box, void *user_dat
 /* Raylib font for text rendering */
 static Font raylib_font;
 
-/* Text buffer for null-termination */
+/* Text buffer for null-terminating strings passed to DrawTextEx */
 static char text_buffer[4096];
 
 /* Text input state */
 static char input_buffer[256];
 static ClayKit_InputState input_state;
+static ClayKit_InputHistory input_history;
+static uint8_t input_history_mem[4096];
+static ClayKit_InputAdvanceCache input_advances;
+static float input_advances_mem[256];
+
+/* Text area state */
+static char notes_buffer[4096];
+static ClayKit_InputState notes_state;
+static ClayKit_InputLineIndex notes_lines;
+static uint32_t notes_line_starts[256];
+static ClayKit_InputHistory notes_history;
+static uint8_t notes_history_mem[4096];
+static const ClayKit_InputConfig notes_config = { .rows = 4 };
 
 /* UI state */
 static int active_tab = 0;
@@ -83,12 +96,7 @@ static bool select_open = false;
 static bool accordion_open[3] = { true, false, false };
 static bool menu_open = false;
 
-/* Pending click state */
-static bool pending_input_click = false;
-static float pending_click_x = 0;
-
 /* Interaction states - set during UI building, used after layout */
-static bool input_hovered = false;
 static int tab_hovered = -1;  /* -1 = none, 0-2 = tab index */
 static bool modal_btn_hovered = false;
 static bool close_modal_btn_hovered = false;
@@ -108,51 +116,62 @@ static int menu_item_hovered = -1;
 
 /* Forward declarations */
 static void render_demo_ui(ClayKit_Context *ctx, ClayKit_Theme *theme);
-static Clay_Dimensions measure_text(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
 
 /* Raylib color conversion */
 static Color to_raylib_color(Clay_Color c) {
     return (Color){ (unsigned char)c.r, (unsigned char)c.g, (unsigned char)c.b, (unsigned char)c.a };
 }
 
-/* Text measurement callback for ClayKit */
-static ClayKit_TextDimensions measure_text_for_claykit(
+/* Width of a glyph at the font's base size, as MeasureTextEx counts it */
+static float glyph_advance(int g) {
+    return raylib_font.glyphs[g].advanceX != 0
+        ? (float)raylib_font.glyphs[g].advanceX
+        : raylib_font.recs[g].width + (float)raylib_font.glyphs[g].offsetX;
+}
+
+/* Text measurement for both Clay and ClayKit (see ClayKit_SetMeasureText).
+ * Walks the glyphs in place using the length, so there's no copy into a
+ * NUL-terminated buffer and no length limit. */
+static ClayKit_TextDimensions measure_text(
     const char *text, uint32_t length, uint16_t font_id, uint16_t font_size, void *user_data
 ) {
     (void)font_id;
     (void)user_data;
 
-    if (length == 0) {
-        return (ClayKit_TextDimensions){ 0, (float)font_size };
+    float width = 0.0f;
+    for (uint32_t i = 0; i < length;) {
+        int codepoint_size = 1;
+        int codepoint = (unsigned char)text[i] < 0x80 ? text[i] : GetCodepointNext(text + i, &codepoint_size);
+        width += glyph_advance(GetGlyphIndex(raylib_font, codepoint));
+        i += (uint32_t)codepoint_size;
     }
-
-    /* Copy to buffer and null-terminate */
-    uint32_t safe_len = length < sizeof(text_buffer) - 1 ? length : sizeof(text_buffer) - 1;
-    memcpy(text_buffer, text, safe_len);
-    text_buffer[safe_len] = '\0';
-
-    Vector2 size = MeasureTextEx(raylib_font, text_buffer, (float)font_size, 0);
-    return (ClayKit_TextDimensions){ size.x, size.y };
+    float scale = (float)font_size / (float)raylib_font.baseSize;
+    return (ClayKit_TextDimensions){ width * scale, (float)font_size };
 }
 
-/* Text measurement callback for Clay */
-static Clay_Dimensions measure_text(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
-    (void)userData;
-
-    if (text.length == 0) {
-        return (Clay_Dimensions){ 1, (float)config->fontSize };
+/* Advance tables for printable ASCII at each theme font size. ClayKit
+ * measures text in these sizes from the tables instead of calling
+ * measure_text. */
+static float font_advances[5][95];
+static ClayKit_FontMetrics font_metrics[5];
+
+static void register_font_metrics(ClayKit_Context *ctx, ClayKit_Theme *theme) {
+    for (int s = 0; s < 5; s++) {
+        uint16_t font_size = ClayKit_GetFontSize(theme, (ClayKit_Size)s);
+        float scale = (float)font_size / (float)raylib_font.baseSize;
+        for (int i = 0; i < 95; i++) {
+            font_advances[s][i] = glyph_advance(GetGlyphIndex(raylib_font, 32 + i)) * scale;
+        }
+        font_metrics[s] = (ClayKit_FontMetrics){
+            .font_id = 0,
+            .font_size = font_size,
+            .first = 32,
+            .count = 95,
+            .advances = font_advances[s],
+            .fallback = font_advances[s]['?' - 32],
+        };
+        ClayKit_RegisterFontMetrics(ctx, &font_metrics[s]);
     }
-
-    /* Copy to buffer and null-terminate */
-    uint32_t len = (uint32_t)text.length;
-    uint32_t safe_len = len < sizeof(text_buffer) - 1 ? len : sizeof(text_buffer) - 1;
-    memcpy(text_buffer, text.chars, safe_len);
-    text_buffer[safe_len] = '\0';
-
-    Vector2 size = MeasureTextEx(raylib_font, text_buffer, (float)config->fontSize, (float)config->letterSpacing);
-    if (size.x == 0) size.x = 1;
-
-    return (Clay_Dimensions){ size.x, size.y };
 }
 
 /* Get keyboard modifiers */
@@ -170,6 +189,37 @@ static uint32_t get_modifiers(void) {
     return mods;
 }
 
+/* Feed this frame's key presses and typed characters to a text field */
+static void handle_text_keys(ClayKit_InputState *s) {
+    static const struct { int raylib; uint32_t claykit; } keys[] = {
+        { KEY_BACKSPACE, CLAYKIT_KEY_BACKSPACE }, { KEY_DELETE, CLAYKIT_KEY_DELETE },
+        { KEY_LEFT, CLAYKIT_KEY_LEFT }, { KEY_RIGHT, CLAYKIT_KEY_RIGHT },
+        { KEY_UP, CLAYKIT_KEY_UP }, { KEY_DOWN, CLAYKIT_KEY_DOWN },
+        { KEY_PAGE_UP, CLAYKIT_KEY_PAGE_UP }, { KEY_PAGE_DOWN, CLAYKIT_KEY_PAGE_DOWN },
+        { KEY_HOME, CLAYKIT_KEY_HOME }, { KEY_END, CLAYKIT_KEY_END },
+        { KEY_ENTER, CLAYKIT_KEY_ENTER }, { KEY_Z, CLAYKIT_KEY_Z }, { KEY_Y, CLAYKIT_KEY_Y },
+    };
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        if (IsKeyPressed(keys[i].raylib) || IsKeyPressedRepeat(keys[i].raylib)) {
+            ClayKit_InputHandleKey(s, keys[i].claykit, get_modifiers());
+        }
+    }
+    if (IsKeyPressed(KEY_V) && (get_modifiers() & CLAYKIT_MOD_CTRL)) {
+        /* Paste as one block move instead of a char at a time */
+        const char *clip = GetClipboardText();
+        if (clip) {
+            ClayKit_InputInsertText(s, clip, (uint32_t)strlen(clip));
+        }
+    }
+
+    /* Handle character input */
+    int ch = GetCharPressed();
+    while (ch != 0) {
+        ClayKit_InputHandleChar(s, (uint32_t)ch);
+        ch = GetCharPressed();
+    }
+}
+
 /* Draw a rounded rectangle */
 static void draw_rounded_rect(Clay_BoundingBox bounds, Clay_Color color, Clay_CornerRadius radius) {
     float avg_radius = (radius.topLeft + radius.topRight + radius.bottomLeft + radius.bottomRight) / 4.0f;
@@ -266,14 +316,18 @@ int main(void) {
 
     Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(min_memory, clay_memory);
     Clay_Initialize(arena, (Clay_Dimensions){ WINDOW_WIDTH, WINDOW_HEIGHT }, (Clay_ErrorHandler){0});
-    Clay_SetMeasureTextFunction(measure_text, NULL);
 
     /* Initialize ClayKit */
     ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
     ClayKit_State state_buf[64] = {0};
     ClayKit_Context ctx = {0};
     ClayKit_Init(&ctx, &theme, state_buf, 64);
-    ctx.measure_text = measure_text_for_claykit;
+    static uint8_t frame_arena[16 * 1024];
+    ClayKit_SetFrameArena(&ctx, frame_arena, sizeof(frame_arena));
+    static ClayKit_StyleCacheEntry style_cache[64];
+    ClayKit_SetStyleCache(&ctx, style_cache, 64);
+    ClayKit_SetMeasureText(&ctx, measure_text, NULL);
+    register_font_metrics(&ctx, &theme);
     ctx.icon_callback = icon_callback;
 
     /* Initialize text input state */
@@ -284,39 +338,27 @@ int main(void) {
     input_state.cursor = 0;
     input_state.select_start = 0;
     input_state.flags = 0;
+    ClayKit_InputSetGapBuffer(&input_state, true);
+    ClayKit_InputSetHistory(&input_state, &input_history, input_history_mem, sizeof(input_history_mem));
+    ClayKit_InputSetAdvanceCache(&input_state, &input_advances, input_advances_mem, 256);
+
+    /* Initialize text area state: a line index makes it multi-line */
+    notes_state.buf = notes_buffer;
+    notes_state.cap = sizeof(notes_buffer);
+    ClayKit_InputSetGapBuffer(&notes_state, true);
+    ClayKit_InputSetHistory(&notes_state, &notes_history, notes_history_mem, sizeof(notes_history_mem));
+    ClayKit_InputSetLineIndex(&notes_state, &notes_lines, notes_line_starts, 256);
 
     /* Main loop */
     while (!WindowShouldClose()) {
         /* Update cursor blink timer */
         ctx.cursor_blink_time += GetFrameTime();
 
-        /* Handle keyboard input for text field */
+        /* Handle keyboard input for the focused text field */
         if (input_state.flags & CLAYKIT_INPUT_FOCUSED) {
-            if (IsKeyPressed(KEY_BACKSPACE)) {
-                ClayKit_InputHandleKey(&input_state, CLAYKIT_KEY_BACKSPACE, get_modifiers());
-            }
-            if (IsKeyPressed(KEY_DELETE)) {
-                ClayKit_InputHandleKey(&input_state, CLAYKIT_KEY_DELETE, get_modifiers());
-            }
-            if (IsKeyPressed(KEY_LEFT)) {
-                ClayKit_InputHandleKey(&input_state, CLAYKIT_KEY_LEFT, get_modifiers());
-            }
-            if (IsKeyPressed(KEY_RIGHT)) {
-                ClayKit_InputHandleKey(&input_state, CLAYKIT_KEY_RIGHT, get_modifiers());
-            }
-            if (IsKeyPressed(KEY_HOME)) {
-                ClayKit_InputHandleKey(&input_state, CLAYKIT_KEY_HOME, get_modifiers());
-            }
-            if (IsKeyPressed(KEY_END)) {
-                ClayKit_InputHandleKey(&input_state, CLAYKIT_KEY_END, get_modifiers());
-            }
-
-            /* Handle character input */
-            int ch = GetCharPressed();
-            while (ch != 0) {
-                ClayKit_InputHandleChar(&input_state, (uint32_t)ch);
-                ch = GetCharPressed();
-            }
+            handle_text_keys(&input_state);
+        } else if (notes_state.flags & CLAYKIT_INPUT_FOCUSED) {
+            handle_text_keys(&notes_state);
         }
 
         /* Update Clay layout dimensions */
@@ -332,28 +374,18 @@ int main(void) {
         /* Begin frame */
         ClayKit_BeginFrame(&ctx);
 
-        /* Process pending click from last frame (for cursor positioning) */
-        if (pending_input_click) {
-            pending_input_click = false;
-            ClayKit_InputStyle style = ClayKit_ComputeInputStyle(&ctx, (ClayKit_InputConfig){0}, true);
-
-            /* Get input element bounding box using same ID as ClayKit_TextInput */
-            Clay_String id_str = { false, 9, "TextInput" };
-            Clay_ElementId input_id = Clay__HashString(id_str, 0, 0);
-            Clay_ElementData elem = Clay_GetElementData(input_id);
-            if (elem.found) {
-                float local_x = pending_click_x - elem.boundingBox.x - style.padding_x;
-                uint32_t new_cursor = ClayKit_InputGetCursorFromX(
-                    &ctx, input_state.buf, input_state.len,
-                    style.font_id, style.font_size, local_x
-                );
-                input_state.cursor = new_cursor;
-                input_state.select_start = new_cursor;
-            }
+        /* Text fields handle presses and drag-selection themselves, against
+         * last frame's layout */
+        if (!show_modal) {
+            bool pressed = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+            bool down = IsMouseButtonDown(MOUSE_LEFT_BUTTON);
+            ClayKit_TextInputPointer(&ctx, "TextInput", 9, &input_state, (ClayKit_InputConfig){0},
+                                     mouse.x, mouse.y, pressed, down, get_modifiers());
+            ClayKit_TextAreaPointer(&ctx, "Notes", 5, &notes_state, notes_config,
+                                    mouse.x, mouse.y, pressed, down, get_modifiers());
         }
 
         /* Reset hover states before building UI */
-        input_hovered = false;
         tab_hovered = -1;
         modal_btn_hovered = false;
         close_modal_btn_hovered = false;
@@ -378,20 +410,10 @@ int main(void) {
 
         /* End layout and get render commands */
         Clay_RenderCommandArray commands = Clay_EndLayout();
+        ClayKit_EndFrame(&ctx);
 
         /* Handle interactions after layout */
         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            /* Text input focus */
-            if (input_hovered) {
-                input_state.flags |= CLAYKIT_INPUT_FOCUSED;
-                ctx.cursor_blink_time = 0;
-                pending_input_click = true;
-                pending_click_x = mouse.x;
-            } else if (!show_modal) {
-                /* Only unfocus if not clicking on modal */
-                input_state.flags &= ~CLAYKIT_INPUT_FOCUSED;
-            }
-
             /* Tab switching */
             if (tab_hovered >= 0) {
                 active_tab = tab_hovered;
@@ -505,6 +527,15 @@ int main(void) {
                     }
                     break;
                 }
+                case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                    BeginScissorMode((int)cmd->boundingBox.x, (int)cmd->boundingBox.y,
+                                     (int)cmd->boundingBox.width, (int)cmd->boundingBox.height);
+                    break;
+                }
+                case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                    EndScissorMode();
+                    break;
+                }
                 case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
                     Clay_CustomRenderData *custom = &cmd->renderData.custom;
                     ClayKit_IconRenderData *icon_data = (ClayKit_IconRenderData *)custom->customData;
@@ -577,7 +608,11 @@ static void render_demo_ui(ClayKit_Context *ctx, ClayKit_Theme *theme) {
 
     /* Text Input */
     add_text("Text Input:", theme->font_size.sm, theme->muted);
-    input_hovered = ClayKit_TextInput(ctx, "TextInput", 9, &input_state, (ClayKit_InputConfig){0}, "Type here...", 12);
+    ClayKit_TextInput(ctx, "TextInput", 9, &input_state, (ClayKit_InputConfig){0}, "Type here...", 12);
+
+    /* Text Area */
+    add_text("Text Area:", theme->font_size.sm, theme->muted);
+    ClayKit_TextArea(ctx, "Notes", 5, &notes_state, notes_config, "Notes...", 8);
 
     /* Slider */
     add_text("Slider:", theme->font_size.sm, theme->muted);
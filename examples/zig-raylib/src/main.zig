@@ -15,10 +15,19 @@ var text_buffer: [4096]u8 = undefined;
 // Text input buffer
 var input_buffer: [256]u8 = undefined;
 var input_state: claykit.InputState = undefined;
-
-// Pending click state (processed before next frame's layout)
-var pending_input_click: bool = false;
-var pending_click_x: f32 = 0;
+var input_history: claykit.InputHistory = .{};
+var input_history_mem: [4096]u8 = undefined;
+var input_advances: claykit.InputAdvanceCache = .{};
+var input_advances_mem: [256]f32 = undefined;
+
+// Text area state
+var notes_buffer: [4096]u8 = undefined;
+var notes_state: claykit.InputState = undefined;
+var notes_lines: claykit.InputLineIndex = .{};
+var notes_line_starts: [256]u32 = undefined;
+var notes_history: claykit.InputHistory = .{};
+var notes_history_mem: [4096]u8 = undefined;
+const notes_config: claykit.InputConfig = .{ .rows = 4 };
 
 // Tabs state
 var active_tab: usize = 0;
@@ -45,28 +54,54 @@ var accordion_open = [3]bool{ true, false, false };
 // Menu state
 var menu_open: bool = false;
 
-// ClayKit text measurement callback (different signature from zclay)
-fn measureTextForClayKit(
+// Width of a glyph at the font's base size, as measureTextEx counts it
+fn glyphAdvance(font: raylib.Font, g: usize) f32 {
+    return if (font.glyphs[g].advanceX != 0)
+        @floatFromInt(font.glyphs[g].advanceX)
+    else
+        font.recs[g].width + @as(f32, @floatFromInt(font.glyphs[g].offsetX));
+}
+
+// Text measurement for both Clay and ClayKit (see Context.setMeasureText).
+// Walks the glyphs in place using the length, so there's no copy into a
+// null-terminated buffer and no length limit.
+fn measureText(
     text: [*c]const u8,
     length: u32,
     font_id: u16,
     font_size: u16,
     _: ?*anyopaque,
 ) callconv(.c) claykit.TextDimensions {
-    if (length == 0) return .{ .width = 0, .height = @floatFromInt(font_size) };
-
     const font = raylib_fonts[font_id];
+    var width: f32 = 0;
+    var it = std.unicode.Utf8Iterator{ .bytes = text[0..length], .i = 0 };
+    while (it.nextCodepoint()) |codepoint| {
+        const g: usize = @intCast(raylib.getGlyphIndex(font, @intCast(codepoint)));
+        width += glyphAdvance(font, g);
+    }
     const font_size_f: f32 = @floatFromInt(font_size);
+    const scale = font_size_f / @as(f32, @floatFromInt(font.baseSize));
+    return .{ .width = width * scale, .height = font_size_f };
+}
 
-    // Copy to buffer and null-terminate
-    const len: usize = @intCast(length);
-    const safe_len = @min(len, text_buffer.len - 1);
-    @memcpy(text_buffer[0..safe_len], text[0..safe_len]);
-    text_buffer[safe_len] = 0;
-    const text_z: [:0]const u8 = text_buffer[0..safe_len :0];
-
-    const size = raylib.measureTextEx(font, text_z, font_size_f, 0);
-    return .{ .width = size.x, .height = size.y };
+// Advance tables for printable ASCII at each theme font size. ClayKit
+// measures text in these sizes from the tables instead of calling
+// measureText.
+var font_advances: [5][95]f32 = undefined;
+var font_metrics: [5]claykit.FontMetrics = undefined;
+
+fn registerFontMetrics(ctx: *claykit.Context, theme: *claykit.Theme) void {
+    const font = raylib_fonts[0];
+    for (0..5) |s| {
+        const font_size = claykit.getFontSize(theme, @enumFromInt(s));
+        const scale = @as(f32, @floatFromInt(font_size)) / @as(f32, @floatFromInt(font.baseSize));
+        for (0..95) |i| {
+            const g: usize = @intCast(raylib.getGlyphIndex(font, @intCast(32 + i)));
+            font_advances[s][i] = glyphAdvance(font, g) * scale;
+        }
+        font_metrics[s] = claykit.FontMetrics.init(0, font_size, 32, &font_advances[s], font_advances[s]['?' - 32], &.{});
+        ctx.registerFontMetrics(&font_metrics[s]);
+    }
 }
 
 // Demo icon IDs
@@ -98,33 +133,6 @@ fn iconCallback(icon_id: u16, box: claykit.BoundingBox, _: ?*anyopaque) callconv
     raylib.drawText(label, cx - 3, cy - 5, 10, raylib.Color.white);
 }
 
-// Clay text measurement callback
-fn measureText(text_slice: []const u8, config: *zclay.TextElementConfig, _: void) zclay.Dimensions {
-    const font = raylib_fonts[config.font_id];
-    const font_size: f32 = @floatFromInt(config.font_size);
-    const letter_spacing: f32 = @floatFromInt(config.letter_spacing);
-
-    // Clay strings aren't null-terminated, so copy to buffer and add terminator
-    const len = @min(text_slice.len, text_buffer.len - 1);
-    @memcpy(text_buffer[0..len], text_slice[0..len]);
-    text_buffer[len] = 0;
-    const text_z: [:0]const u8 = text_buffer[0..len :0];
-
-    var text_size = raylib.measureTextEx(
-        font,
-        text_z,
-        font_size,
-        letter_spacing,
-    );
-
-    // Handle empty strings
-    if (text_size.x == 0) {
-        text_size.x = 1;
-    }
-
-    return .{ .w = text_size.x, .h = text_size.y };
-}
-
 pub fn main() !void {
     // Get the executable's directory for resource paths
     var exe_dir_buf: [std.fs.max_path_bytes]u8 = undefined;
@@ -162,54 +170,42 @@ pub fn main() !void {
         .w = WINDOW_WIDTH,
         .h = WINDOW_HEIGHT,
     }, .{});
-    zclay.setMeasureTextFunction(void, {}, measureText);
 
     // Initialize ClayKit using the Zig bindings
     var theme = claykit.Theme.light;
     var state_buf: [64]claykit.State = undefined;
     var ctx: claykit.Context = .{};
     claykit.init(&ctx, &theme, &state_buf);
+    var frame_arena: [16 * 1024]u8 = undefined;
+    claykit.setFrameArena(&ctx, &frame_arena);
 
-    // Set up text measurement for ClayKit (needed for cursor positioning)
-    ctx.setMeasureText(measureTextForClayKit, null);
+    // One measure function for Clay and ClayKit (needed for layout and
+    // cursor positioning)
+    ctx.setMeasureText(measureText, null);
+    registerFontMetrics(&ctx, &theme);
     ctx.icon_callback = iconCallback;
 
     // Initialize text input state
     input_state = claykit.InputState.init(&input_buffer);
+    input_state.setHistory(&input_history, &input_history_mem);
+    input_state.setAdvanceCache(&input_advances, &input_advances_mem);
+
+    // Initialize text area state: a line index makes it multi-line
+    notes_state = claykit.InputState.init(&notes_buffer);
+    notes_state.setGapBuffer(true);
+    notes_state.setHistory(&notes_history, &notes_history_mem);
+    _ = notes_state.setLineIndex(&notes_lines, &notes_line_starts);
 
     // Main loop
     while (!raylib.windowShouldClose()) {
         // Update cursor blink timer
         ctx.cursor_blink_time += raylib.getFrameTime();
 
-        // Handle keyboard input for text field
+        // Handle keyboard input for the focused text field
         if (input_state.isFocused()) {
-            // Handle special keys
-            if (raylib.isKeyPressed(.backspace)) {
-                _ = claykit.inputHandleKey(&input_state, .backspace, getModifiers());
-            }
-            if (raylib.isKeyPressed(.delete)) {
-                _ = claykit.inputHandleKey(&input_state, .delete, getModifiers());
-            }
-            if (raylib.isKeyPressed(.left)) {
-                _ = claykit.inputHandleKey(&input_state, .left, getModifiers());
-            }
-            if (raylib.isKeyPressed(.right)) {
-                _ = claykit.inputHandleKey(&input_state, .right, getModifiers());
-            }
-            if (raylib.isKeyPressed(.home)) {
-                _ = claykit.inputHandleKey(&input_state, .home, getModifiers());
-            }
-            if (raylib.isKeyPressed(.end)) {
-                _ = claykit.inputHandleKey(&input_state, .end, getModifiers());
-            }
-
-            // Handle character input
-            var char = raylib.getCharPressed();
-            while (char != 0) {
-                _ = claykit.inputHandleChar(&input_state, @intCast(char));
-                char = raylib.getCharPressed();
-            }
+            handleTextKeys(&input_state);
+        } else if (notes_state.isFocused()) {
+            handleTextKeys(&notes_state);
         }
         // Update Clay layout dimensions if window resized
         const screen_width: f32 = @floatFromInt(raylib.getScreenWidth());
@@ -223,18 +219,12 @@ pub fn main() !void {
         // Begin frame
         claykit.beginFrame(&ctx);
 
-        // Process pending click from last frame (before layout so cursor renders correctly)
-        if (pending_input_click) {
-            pending_input_click = false;
-            const input_elem = zclay.getElementData(zclay.ElementId.ID("TextInput1"));
-            if (input_elem.found) {
-                const style = claykit.computeInputStyle(&ctx, .{}, true);
-                claykit.inputHandleClick(&ctx, &input_state, input_elem.bounding_box, pending_click_x, style);
-            }
-        }
-
-        // Track input click state (set during UI building, used after layout)
-        var input_clicked: bool = false;
+        // Text fields handle presses and drag-selection themselves, against
+        // last frame's layout
+        const pressed = raylib.isMouseButtonPressed(.left);
+        const down = raylib.isMouseButtonDown(.left);
+        _ = claykit.textInputPointer(&ctx, "TextInput1", &input_state, .{}, mouse_pos.x, mouse_pos.y, pressed, down, getModifiers());
+        _ = claykit.textAreaPointer(&ctx, "Notes", &notes_state, notes_config, mouse_pos.x, mouse_pos.y, pressed, down, getModifiers());
 
         // Build UI layout using new zclay API
         zclay.beginLayout();
@@ -295,7 +285,11 @@ pub fn main() !void {
 
                     // Text Input
                     zclay.text("Text Input:", claykit.textStyle(&ctx, .{ .size = .sm }));
-                    input_clicked = claykit.textInput(&ctx, "TextInput1", &input_state, .{}, "Type here...");
+                    _ = claykit.textInput(&ctx, "TextInput1", &input_state, .{}, "Type here...");
+
+                    // Text Area
+                    zclay.text("Text Area:", claykit.textStyle(&ctx, .{ .size = .sm }));
+                    _ = claykit.textArea(&ctx, "Notes", &notes_state, notes_config, "Notes...");
 
                     // Slider
                     zclay.text("Slider:", claykit.textStyle(&ctx, .{ .size = .sm }));
@@ -754,20 +748,7 @@ pub fn main() !void {
 
         // End layout and get render commands
         const render_commands = zclay.endLayout();
-
-        // Handle text input click (store for processing before next frame's layout)
-        if (raylib.isMouseButtonPressed(.left)) {
-            if (input_clicked) {
-                // Focus immediately, store click for cursor positioning next frame
-                input_state.setFocused(true);
-                ctx.cursor_blink_time = 0;
-                pending_input_click = true;
-                pending_click_x = mouse_pos.x;
-            } else {
-                // Clicked elsewhere - unfocus
-                input_state.setFocused(false);
-            }
-        }
+        claykit.endFrame(&ctx);
 
         // Render with raylib
         raylib.beginDrawing();
@@ -830,6 +811,15 @@ pub fn main() !void {
                         );
                     }
                 },
+                .scissor_start => {
+                    raylib.beginScissorMode(
+                        @intFromFloat(cmd.bounding_box.x),
+                        @intFromFloat(cmd.bounding_box.y),
+                        @intFromFloat(cmd.bounding_box.width),
+                        @intFromFloat(cmd.bounding_box.height),
+                    );
+                },
+                .scissor_end => raylib.endScissorMode(),
                 .custom => {
                     const custom = cmd.render_data.custom;
                     if (custom.custom_data) |ptr| {
@@ -897,6 +887,31 @@ fn drawRoundedRect(bounds: zclay.BoundingBox, color: zclay.Color, radius: zclay.
     );
 }
 
+// Feed this frame's key presses and typed characters to a text field
+fn handleTextKeys(state: *claykit.InputState) void {
+    const keys = [_]struct { raylib.KeyboardKey, claykit.Key }{
+        .{ .backspace, .backspace }, .{ .delete, .delete },
+        .{ .left, .left },           .{ .right, .right },
+        .{ .up, .up },               .{ .down, .down },
+        .{ .page_up, .page_up },     .{ .page_down, .page_down },
+        .{ .home, .home },           .{ .end, .end },
+        .{ .enter, .enter },         .{ .z, .z },
+        .{ .y, .y },
+    };
+    inline for (keys) |k| {
+        if (raylib.isKeyPressed(k[0])) {
+            _ = claykit.inputHandleKey(state, k[1], getModifiers());
+        }
+    }
+
+    // Handle character input
+    var char = raylib.getCharPressed();
+    while (char != 0) {
+        _ = claykit.inputHandleChar(state, @intCast(char));
+        char = raylib.getCharPressed();
+    }
+}
+
 fn getModifiers() u32 {
     var mods: u32 = 0;
     if (raylib.isKeyDown(.left_shift) or raylib.isKeyDown(.right_shift)) {
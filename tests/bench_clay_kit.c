@@ -0,0 +1,731 @@
+/*
+ * Benchmarks for clay_kit.h
+ *
+ * Compile: gcc -std=c99 -O2 -I. -Ivendor tests/bench_clay_kit.c -o tests/bench_clay_kit -lm
+ * Run: ./tests/bench_clay_kit
+ */
+
+#define CLAY_IMPLEMENTATION
+#include "../vendor/clay.h"
+
+#define CLAYKIT_IMPLEMENTATION
+#include "../clay_kit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static volatile uint32_t g_sink;
+
+static double now_seconds(void) {
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+}
+
+static uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/* Fills ids with distinct non-zero values, like Clay element ids */
+static void make_ids(uint32_t *ids, uint32_t count, uint32_t seed) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id;
+        do {
+            id = xorshift32(&seed);
+        } while (id == 0);
+        ids[i] = id;
+    }
+}
+
+/* ============================================================================
+ * State Lookup
+ * ============================================================================ */
+
+/* The append-and-scan lookup ClayKit used before the hash table */
+static ClayKit_State* scan_get_or_create(ClayKit_Context *ctx, uint32_t id) {
+    for (uint32_t i = 0; i < ctx->state_count; i++) {
+        if (ctx->state_ptr[i].id == id) {
+            return &ctx->state_ptr[i];
+        }
+    }
+    if (ctx->state_count < ctx->state_cap) {
+        ClayKit_State *s = &ctx->state_ptr[ctx->state_count++];
+        s->id = id;
+        s->flags = 0;
+        s->value = 0.0f;
+        return s;
+    }
+    return NULL;
+}
+
+typedef ClayKit_State* (*LookupFn)(ClayKit_Context *ctx, uint32_t id);
+
+/* Inserts `count` ids, then looks every id up per frame for `frames` frames.
+ * Returns nanoseconds per lookup. */
+static double bench_lookup(LookupFn fn, uint32_t slots, uint32_t count, uint32_t frames) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State *buf = (ClayKit_State *)malloc(sizeof(ClayKit_State) * slots);
+    uint32_t *ids = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    ClayKit_Context ctx;
+
+    ClayKit_Init(&ctx, &theme, buf, slots);
+    make_ids(ids, count, 0x12345678u + slots);
+    for (uint32_t i = 0; i < count; i++) {
+        fn(&ctx, ids[i]);
+    }
+
+    uint32_t acc = 0;
+    double start = now_seconds();
+    for (uint32_t f = 0; f < frames; f++) {
+        for (uint32_t i = 0; i < count; i++) {
+            ClayKit_State *s = fn(&ctx, ids[i]);
+            acc += s ? s->id : 0;
+        }
+    }
+    double elapsed = now_seconds() - start;
+    g_sink = acc;
+
+    free(ids);
+    free(buf);
+    return elapsed * 1e9 / ((double)frames * (double)count);
+}
+
+static void bench_state_lookup(void) {
+    static const uint32_t sizes[] = { 64, 1024, 16384 };
+
+    printf("\nState lookup (GetOrCreateState, buffer half full):\n");
+    printf("  %8s %8s %14s %14s %10s\n", "slots", "states", "scan ns/op", "hash ns/op", "speedup");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t slots = sizes[i];
+        uint32_t count = slots / 2;
+        /* Keep total work per row roughly constant */
+        uint32_t frames = 4000000u / (count * (count / 64 + 1)) + 1;
+        double scan = bench_lookup(scan_get_or_create, slots, count, frames);
+        double hash = bench_lookup(ClayKit_GetOrCreateState, slots, count, frames * (count / 64 + 1));
+        printf("  %8u %8u %14.2f %14.2f %9.1fx\n", slots, count, scan, hash, scan / hash);
+    }
+}
+
+/* ============================================================================
+ * Style Cache
+ * ============================================================================ */
+
+/* Computes the styles of a 50x200 table (row, header and cell text), the way
+ * a table build does once per cell. Returns nanoseconds per cell. */
+static double bench_table_styles(ClayKit_StyleCacheEntry *cache, uint32_t cache_count, uint32_t frames) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[16];
+    ClayKit_Context ctx;
+    ClayKit_TableConfig cfg = {0};
+    uint32_t cells = 50 * 200;
+
+    ClayKit_Init(&ctx, &theme, state_buf, 16);
+    ClayKit_SetStyleCache(&ctx, cache, cache_count);
+    cfg.striped = true;
+    cfg.bordered = true;
+
+    uint32_t acc = 0;
+    double start = now_seconds();
+    for (uint32_t f = 0; f < frames; f++) {
+        for (uint32_t i = 0; i < cells; i++) {
+            ClayKit_TableStyle style = ClayKit_ComputeTableStyle(&ctx, cfg);
+            acc += style.font_size;
+        }
+    }
+    double elapsed = now_seconds() - start;
+    g_sink = acc;
+
+    return elapsed * 1e9 / ((double)frames * (double)cells);
+}
+
+static void bench_style_cache(void) {
+    static ClayKit_StyleCacheEntry cache[64];
+
+    printf("\nTable styles (ComputeTableStyle per cell, 50x200 table):\n");
+    printf("  %14s %14s %10s\n", "plain ns/cell", "cached ns/cell", "speedup");
+    double plain = bench_table_styles(NULL, 0, 200);
+    double cached = bench_table_styles(cache, 64, 200);
+    printf("  %14.2f %14.2f %9.1fx\n", plain, cached, plain / cached);
+}
+
+/* ============================================================================
+ * Text Input Editing
+ * ============================================================================ */
+
+/* Types `count` characters then backspaces them again in the middle of a
+ * field holding `len` bytes. Returns nanoseconds per keystroke. */
+static double bench_input_typing(bool gap, uint32_t len, uint32_t count) {
+    uint32_t cap = len + count + 1;
+    char *buf = (char *)malloc(cap);
+    ClayKit_InputState s = {0};
+
+    memset(buf, 'x', len);
+    s.buf = buf;
+    s.cap = cap;
+    s.len = len;
+    s.cursor = len / 2;
+    s.select_start = s.cursor;
+    ClayKit_InputSetGapBuffer(&s, gap);
+
+    double start = now_seconds();
+    for (uint32_t i = 0; i < count; i++) {
+        ClayKit_InputHandleChar(&s, 'a' + i % 26);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    }
+    double elapsed = now_seconds() - start;
+    g_sink = s.len;
+
+    free(buf);
+    return elapsed * 1e9 / (2.0 * (double)count);
+}
+
+static void bench_input_editing(void) {
+    static const uint32_t sizes[] = { 256, 16 * 1024, 256 * 1024 };
+
+    printf("\nText input typing (insert + backspace mid-field):\n");
+    printf("  %8s %14s %14s %10s\n", "bytes", "flat ns/key", "gap ns/key", "speedup");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        double flat = bench_input_typing(false, sizes[i], 20000);
+        double gap = bench_input_typing(true, sizes[i], 20000);
+        printf("  %8u %14.2f %14.2f %9.1fx\n", sizes[i], flat, gap, flat / gap);
+    }
+}
+
+/* Pastes `len` bytes into the middle of a 1 KiB field, one HandleChar per
+ * byte or as one InsertText. Returns microseconds per paste. */
+static double bench_paste(bool bulk, uint32_t len, uint32_t reps) {
+    uint32_t cap = 1024 + len + 1;
+    char *buf = (char *)malloc(cap);
+    char *text = (char *)malloc(len);
+    ClayKit_InputState s = {0};
+
+    memset(text, 'p', len);
+    s.buf = buf;
+    s.cap = cap;
+
+    double start = now_seconds();
+    for (uint32_t r = 0; r < reps; r++) {
+        memset(buf, 'x', 1024);
+        s.len = 1024;
+        s.cursor = 512;
+        s.select_start = 512;
+        if (bulk) {
+            ClayKit_InputInsertText(&s, text, len);
+        } else {
+            for (uint32_t i = 0; i < len; i++) {
+                ClayKit_InputHandleChar(&s, (uint8_t)text[i]);
+            }
+        }
+    }
+    double elapsed = now_seconds() - start;
+    g_sink = s.len;
+
+    free(text);
+    free(buf);
+    return elapsed * 1e6 / (double)reps;
+}
+
+static void bench_input_paste(void) {
+    static const uint32_t sizes[] = { 64, 4 * 1024, 64 * 1024 };
+
+    printf("\nText input paste (into a 1 KiB field):\n");
+    printf("  %8s %14s %14s %10s\n", "bytes", "per-char us", "bulk us", "speedup");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t reps = 2000000u / (sizes[i] * (sizes[i] / 1024 + 1)) + 1;
+        double chars = bench_paste(false, sizes[i], reps);
+        double bulk = bench_paste(true, sizes[i], reps * 16);
+        printf("  %8u %14.2f %14.2f %9.1fx\n", sizes[i], chars, bulk, chars / bulk);
+    }
+}
+
+/* Byte-at-a-time classification: 0 whitespace, 1 punctuation, 2 word */
+static int scalar_char_class(char ch) {
+    unsigned char c = (unsigned char)ch;
+    if (c == ' ' || (c >= 9 && c <= 13)) return 0;
+    if (c >= 0x80 || c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+        return 2;
+    }
+    return 1;
+}
+
+/* Ctrl+Right as a byte-at-a-time loop, the baseline for the vectorized scan */
+static void scalar_word_right(ClayKit_InputState *s) {
+    uint32_t i = s->cursor;
+    if (i < s->len && scalar_char_class(s->buf[i]) != 0) {
+        int cls = scalar_char_class(s->buf[i]);
+        while (i < s->len && scalar_char_class(s->buf[i]) == cls) i++;
+    }
+    while (i < s->len && scalar_char_class(s->buf[i]) == 0) i++;
+    s->cursor = i;
+    s->select_start = i;
+}
+
+static void kit_word_right(ClayKit_InputState *s) {
+    ClayKit_InputHandleKey(s, CLAYKIT_KEY_RIGHT, CLAYKIT_MOD_CTRL);
+}
+
+typedef void (*WordRightFn)(ClayKit_InputState *s);
+
+/* Sweeps Ctrl+Right across a field of `len` bytes made of space-separated
+ * base64-alphabet tokens `word` bytes long. Returns nanoseconds per byte
+ * scanned. */
+static double bench_word_sweep(WordRightFn fn, uint32_t len, uint32_t word, uint32_t sweeps) {
+    char *buf = (char *)malloc(len + 1);
+    ClayKit_InputState s = {0};
+
+    for (uint32_t i = 0; i < len; i++) {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+        buf[i] = (i % (word + 1) == word) ? ' ' : alphabet[i % 62];
+    }
+    s.buf = buf;
+    s.cap = len + 1;
+    s.len = len;
+
+    uint32_t acc = 0;
+    double start = now_seconds();
+    for (uint32_t k = 0; k < sweeps; k++) {
+        s.cursor = 0;
+        s.select_start = 0;
+        while (s.cursor < len) {
+            fn(&s);
+            acc++;
+        }
+    }
+    double elapsed = now_seconds() - start;
+    g_sink = acc;
+
+    free(buf);
+    return elapsed * 1e9 / ((double)sweeps * (double)len);
+}
+
+static void bench_word_motion(void) {
+    static const uint32_t words[] = { 8, 64, 4096 };
+
+    printf("\nText input word motion (Ctrl+Right sweep over 64 KiB):\n");
+    printf("  %8s %14s %14s %10s\n", "word len", "scalar ns/B", "scan ns/B", "speedup");
+    for (uint32_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        double scalar = bench_word_sweep(scalar_word_right, 64 * 1024, words[i], 200);
+        double scan = bench_word_sweep(kit_word_right, 64 * 1024, words[i], 200);
+        printf("  %8u %14.3f %14.3f %9.1fx\n", words[i], scalar, scan, scalar / scan);
+    }
+}
+
+/* ============================================================================
+ * Text Input Hit-Testing
+ * ============================================================================ */
+
+/* Walks every glyph like a real font measurer would */
+static ClayKit_TextDimensions bench_measure(const char *text, uint32_t length, uint16_t font_id,
+                                            uint16_t font_size, void *user_data) {
+    (void)font_id; (void)user_data;
+    float width = 0.0f;
+    for (uint32_t i = 0; i < length; i++) {
+        width += (float)font_size * (0.4f + (float)((uint8_t)text[i] % 5) * 0.05f);
+    }
+    ClayKit_TextDimensions d = { width, (float)font_size };
+    return d;
+}
+
+/* The prefix-by-prefix scan GetCursorFromX used before */
+static uint32_t linear_cursor_from_x(ClayKit_Context *ctx, const char *text, uint32_t length, float x) {
+    float prev_width = 0.0f;
+    uint32_t prev = 0;
+    for (uint32_t i = 1; i <= length; i++) {
+        float width = ClayKit_MeasureTextWidth(ctx, text, i, 0, 16);
+        if (x < (prev_width + width) / 2.0f) return prev;
+        prev_width = width;
+        prev = i;
+    }
+    return length;
+}
+
+static void bench_hit_test(void) {
+    static const uint32_t sizes[] = { 64, 2000, 16000 };
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = bench_measure;
+
+    printf("\nText input hit-test (clicks spread over the field):\n");
+    printf("  %8s %14s %14s %14s\n", "bytes", "linear us", "bsearch us", "cached us");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t len = sizes[i];
+        char *buf = (char *)malloc(len + 1);
+        float *mem = (float *)malloc(sizeof(float) * (len + 1));
+        ClayKit_InputAdvanceCache cache;
+        ClayKit_InputState s = {0};
+        for (uint32_t k = 0; k < len; k++) buf[k] = (char)('a' + k % 26);
+        s.buf = buf;
+        s.cap = len + 1;
+        s.len = len;
+        ClayKit_InputSetAdvanceCache(&s, &cache, mem, len + 1);
+
+        float total = ClayKit_MeasureTextWidth(&ctx, buf, len, 0, 16);
+        uint32_t clicks = 64;
+        uint32_t linear_clicks = len > 4000 ? 4 : 16;
+        uint32_t acc = 0;
+
+        double start = now_seconds();
+        for (uint32_t c = 0; c < linear_clicks; c++) {
+            acc += linear_cursor_from_x(&ctx, buf, len, total * (float)(c + 1) / (float)(linear_clicks + 1));
+        }
+        double linear = (now_seconds() - start) * 1e6 / (double)linear_clicks;
+
+        start = now_seconds();
+        for (uint32_t c = 0; c < clicks; c++) {
+            acc += ClayKit_InputGetCursorFromX(&ctx, buf, len, 0, 16, total * (float)(c + 1) / (float)(clicks + 1));
+        }
+        double bsearch = (now_seconds() - start) * 1e6 / (double)clicks;
+
+        /* Includes filling the cache on the first click */
+        start = now_seconds();
+        for (uint32_t c = 0; c < clicks * 64; c++) {
+            acc += ClayKit_InputHitTest(&ctx, &s, 0, 16, total * (float)(c % clicks + 1) / (float)(clicks + 1));
+        }
+        double cached = (now_seconds() - start) * 1e6 / (double)(clicks * 64);
+        g_sink = acc;
+
+        printf("  %8u %14.2f %14.2f %14.3f\n", len, linear, bsearch, cached);
+        free(mem);
+        free(buf);
+    }
+}
+
+/* ============================================================================
+ * Font Metrics
+ * ============================================================================ */
+
+static float g_bench_advances[95];
+static int g_bench_glyphs[95];
+static char g_bench_text_copy[8192];
+
+/* What the examples' callback does: copy into a NUL-terminated buffer, then
+ * look up each glyph with a scan of the font's glyph list, as raylib's
+ * GetGlyphIndex does */
+static ClayKit_TextDimensions bench_copying_measure(const char *text, uint32_t length, uint16_t font_id,
+                                                    uint16_t font_size, void *user_data) {
+    (void)font_id; (void)user_data;
+    memcpy(g_bench_text_copy, text, length);
+    g_bench_text_copy[length] = '\0';
+    float width = 0.0f;
+    for (const char *p = g_bench_text_copy; *p; p++) {
+        int g = 0;
+        while (g < 94 && g_bench_glyphs[g] != (uint8_t)*p) g++;
+        width += g_bench_advances[g];
+    }
+    ClayKit_TextDimensions d = { width, (float)font_size };
+    return d;
+}
+
+static double bench_measure_calls(ClayKit_Context *ctx, const char *text, uint32_t len, uint32_t reps) {
+    float acc = 0.0f;
+    double start = now_seconds();
+    for (uint32_t r = 0; r < reps; r++) {
+        acc += ClayKit_MeasureTextWidth(ctx, text, len - (r & 1), 0, 16);
+    }
+    double elapsed = now_seconds() - start;
+    g_sink = (uint32_t)acc;
+    return elapsed * 1e9 / (double)reps;
+}
+
+static void bench_font_metrics(void) {
+    static const uint32_t sizes[] = { 16, 256, 4096 };
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_FontMetrics metrics = {0};
+    static char text[4096];
+
+    for (uint32_t i = 0; i < 95; i++) {
+        g_bench_advances[i] = 6.0f + (float)(i % 7) * 0.5f;
+        g_bench_glyphs[i] = (int)(32 + i);
+    }
+    for (uint32_t i = 0; i < sizeof(text); i++) text[i] = (char)(32 + (i * 7) % 95);
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = bench_copying_measure;
+    metrics.font_size = 16;
+    metrics.first = 32;
+    metrics.count = 95;
+    metrics.advances = g_bench_advances;
+
+    printf("\nText measurement (copying callback vs registered font metrics):\n");
+    printf("  %8s %14s %14s %10s\n", "bytes", "callback ns", "metrics ns", "speedup");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t reps = 4000000u / sizes[i] + 1000;
+        ctx.font_metrics = NULL;
+        double callback = bench_measure_calls(&ctx, text, sizes[i], reps);
+        ClayKit_RegisterFontMetrics(&ctx, &metrics);
+        double table = bench_measure_calls(&ctx, text, sizes[i], reps);
+        printf("  %8u %14.1f %14.1f %9.1fx\n", sizes[i], callback, table, callback / table);
+    }
+}
+
+/* ============================================================================
+ * Batched Measurement
+ * ============================================================================ */
+
+static uint32_t g_bench_measure_calls;
+
+/* Stands in for a backend's per-call work: finding the font by id in a
+ * list of loaded fonts, then setting up its glyph lookup */
+static float bench_resolve_font(uint16_t font_id, uint16_t font_size) {
+    static const uint16_t loaded[32] = { 9, 8, 7, 6, 5, 4, 3, 2, 1, 31, 30, 29, 28, 27, 26, 25,
+                                         24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 0 };
+    volatile float scale = (float)font_size / 32.0f;
+    int f = 0;
+    while (f < 31 && loaded[f] != font_id) f++;
+    for (int k = 0; k < 64; k++) scale = scale * 1.0001f + (float)f * 1e-9f;
+    g_bench_measure_calls++;
+    return scale;
+}
+
+static ClayKit_TextDimensions bench_single_measure(const char *text, uint32_t length, uint16_t font_id,
+                                                   uint16_t font_size, void *user_data) {
+    (void)user_data;
+    float scale = bench_resolve_font(font_id, font_size);
+    ClayKit_TextDimensions d = bench_measure(text, length, 32, 16, NULL);
+    d.width *= scale;
+    return d;
+}
+
+/* Resolves the font once per batch; ClayKit's batches share one font */
+static void bench_batch_measure(const ClayKit_MeasureRequest *requests, ClayKit_TextDimensions *out,
+                                uint32_t count, void *user_data) {
+    (void)user_data;
+    float scale = bench_resolve_font(requests[0].font_id, requests[0].font_size);
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = bench_measure(requests[i].text, requests[i].length, 32, 16, NULL);
+        out[i].width *= scale;
+    }
+}
+
+/* Clicks spread over the text, then a fresh advance cache filled to the end */
+static void bench_batch_run(ClayKit_Context *ctx, ClayKit_InputState *s, float *mem,
+                            double *click_us, double *fill_us, uint32_t *click_calls, uint32_t *fill_calls) {
+    ClayKit_InputAdvanceCache cache;
+    uint32_t clicks = 64;
+    uint32_t acc = 0;
+    float total = ClayKit_MeasureTextWidth(ctx, s->buf, s->len, 0, 16);
+
+    g_bench_measure_calls = 0;
+    double start = now_seconds();
+    for (uint32_t c = 0; c < clicks; c++) {
+        acc += ClayKit_InputGetCursorFromX(ctx, s->buf, s->len, 0, 16, total * (float)(c + 1) / (float)(clicks + 1));
+    }
+    *click_us = (now_seconds() - start) * 1e6 / (double)clicks;
+    *click_calls = g_bench_measure_calls / clicks;
+
+    g_bench_measure_calls = 0;
+    start = now_seconds();
+    for (uint32_t r = 0; r < 16; r++) {
+        ClayKit_InputSetAdvanceCache(s, &cache, mem, s->len + 1);
+        acc += (uint32_t)ClayKit_InputOffsetX(ctx, s, 0, 16, s->len);
+    }
+    *fill_us = (now_seconds() - start) * 1e6 / 16.0;
+    *fill_calls = g_bench_measure_calls / 16;
+    ClayKit_InputSetAdvanceCache(s, NULL, NULL, 0);
+    g_sink = acc;
+}
+
+static void bench_measure_batch(void) {
+    static const uint32_t sizes[] = { 64, 2000, 16000 };
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context single;
+    ClayKit_Context batched;
+
+    ClayKit_Init(&single, &theme, state_buf, 4);
+    ClayKit_Init(&batched, &theme, state_buf, 4);
+    single.measure_text = bench_single_measure;
+    ClayKit_SetMeasureTextBatch(&batched, bench_batch_measure, NULL);
+
+    printf("\nMeasure callback calls (one text per call vs batches of %d):\n", CLAYKIT_MEASURE_BATCH);
+    printf("  %8s %11s %11s %11s %11s %11s %11s\n", "bytes", "click calls", "batched",
+           "click us", "batched", "fill us", "batched");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t len = sizes[i];
+        char *buf = (char *)malloc(len + 1);
+        float *mem = (float *)malloc(sizeof(float) * (len + 1));
+        ClayKit_InputState s = {0};
+        for (uint32_t k = 0; k < len; k++) buf[k] = (char)('a' + k % 26);
+        s.buf = buf;
+        s.cap = len + 1;
+        s.len = len;
+
+        double click[2], fill[2];
+        uint32_t click_calls[2], fill_calls[2];
+        bench_batch_run(&single, &s, mem, &click[0], &fill[0], &click_calls[0], &fill_calls[0]);
+        bench_batch_run(&batched, &s, mem, &click[1], &fill[1], &click_calls[1], &fill_calls[1]);
+        printf("  %8u %11u %11u %11.2f %11.2f %11.1f %11.1f\n", len, click_calls[0], click_calls[1],
+               click[0], click[1], fill[0], fill[1]);
+        free(mem);
+        free(buf);
+    }
+}
+
+/* ============================================================================
+ * Text Input Viewport
+ * ============================================================================ */
+
+static Clay_Dimensions bench_clay_measure(Clay_StringSlice text, Clay_TextElementConfig *config, void *user_data) {
+    (void)user_data;
+    ClayKit_TextDimensions d = bench_measure(text.chars, (uint32_t)text.length, config->fontId, config->fontSize, NULL);
+    Clay_Dimensions out = { d.width, d.height };
+    return out;
+}
+
+/* Lays out one 300px text input per frame, with the cursor mid-text */
+static double bench_input_frames(ClayKit_Context *ctx, ClayKit_InputState *s, const char *id, uint32_t frames) {
+    ClayKit_InputConfig cfg = {0};
+    cfg.width = 300;
+    double start = now_seconds();
+    for (uint32_t f = 0; f < frames; f++) {
+        ClayKit_BeginFrame(ctx);
+        Clay_BeginLayout();
+        ClayKit_TextInput(ctx, id, id ? (int32_t)strlen(id) : 0, s, cfg, NULL, 0);
+        Clay_RenderCommandArray cmds = Clay_EndLayout();
+        g_sink += (uint32_t)cmds.length;
+    }
+    return (now_seconds() - start) * 1e6 / (double)frames;
+}
+
+static void bench_input_viewport(void) {
+    static const uint32_t sizes[] = { 64, 2000, 16000 };
+    uint32_t size = Clay_MinMemorySize();
+    void *clay_mem = malloc(size);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(size, clay_mem), (Clay_Dimensions){ 800, 600 }, (Clay_ErrorHandler){0});
+    Clay_SetMeasureTextFunction(bench_clay_measure, NULL);
+
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = bench_measure;
+
+    /* Without an id the input cannot scroll and lays out the whole text */
+    printf("\nText input frame (300px box, cursor mid-text):\n");
+    printf("  %8s %14s %14s\n", "bytes", "full us", "viewport us");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t len = sizes[i];
+        char *buf = (char *)malloc(len + 1);
+        float *mem = (float *)malloc(sizeof(float) * (len + 1));
+        ClayKit_InputAdvanceCache cache;
+        ClayKit_InputState s = {0};
+        for (uint32_t k = 0; k < len; k++) buf[k] = (char)('a' + k % 26);
+        s.buf = buf;
+        s.cap = len + 1;
+        s.len = len;
+        s.cursor = s.select_start = len / 2;
+        ClayKit_InputSetAdvanceCache(&s, &cache, mem, len + 1);
+
+        uint32_t frames = len > 4000 ? 200 : 2000;
+        double full = bench_input_frames(&ctx, &s, NULL, frames);
+        bench_input_frames(&ctx, &s, "Field", 2);
+        double viewport = bench_input_frames(&ctx, &s, "Field", frames);
+
+        printf("  %8u %14.2f %14.2f\n", len, full, viewport);
+        free(mem);
+        free(buf);
+    }
+    Clay_SetCurrentContext(NULL);  /* Clay_MinMemorySize reads the current context */
+    free(clay_mem);
+}
+
+/* ============================================================================
+ * Text Area
+ * ============================================================================ */
+
+/* Frame time of an 8-row text area against document length, with the cursor
+ * on the middle line. Each frame also types one character, so the line index
+ * update is part of the cost. */
+static void bench_text_area(void) {
+    static const uint32_t line_counts[] = { 10, 1000, 100000 };
+    enum { LINE_LEN = 40 };
+    uint32_t size = Clay_MinMemorySize();
+    void *clay_mem = malloc(size);
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(size, clay_mem), (Clay_Dimensions){ 800, 600 }, (Clay_ErrorHandler){0});
+    Clay_SetMeasureTextFunction(bench_clay_measure, NULL);
+
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = bench_measure;
+
+    ClayKit_InputConfig cfg = {0};
+    cfg.width = 300;
+    cfg.rows = 8;
+
+    printf("\nText area frame (8 rows, %d-byte lines, typing mid-text):\n", LINE_LEN);
+    printf("  %8s %14s\n", "lines", "us/frame");
+    for (uint32_t i = 0; i < sizeof(line_counts) / sizeof(line_counts[0]); i++) {
+        uint32_t lines = line_counts[i];
+        uint32_t frames = 2000;
+        uint32_t len = lines * LINE_LEN;
+        char *buf = (char *)malloc(len + frames + 1);
+        uint32_t *starts = (uint32_t *)malloc(sizeof(uint32_t) * lines);
+        ClayKit_InputLineIndex index;
+        ClayKit_InputState s = {0};
+        for (uint32_t k = 0; k < len; k++) {
+            buf[k] = (k % LINE_LEN == LINE_LEN - 1) ? '\n' : (char)('a' + k % 26);
+        }
+        s.buf = buf;
+        s.cap = len + frames + 1;
+        s.len = len - 1;  /* No trailing newline */
+        s.cursor = s.select_start = (lines / 2) * LINE_LEN + LINE_LEN / 2;
+        ClayKit_InputSetGapBuffer(&s, true);
+        ClayKit_InputSetLineIndex(&s, &index, starts, lines);
+
+        double start = now_seconds();
+        for (uint32_t f = 0; f < frames; f++) {
+            ClayKit_InputHandleChar(&s, 'x');
+            ClayKit_BeginFrame(&ctx);
+            Clay_BeginLayout();
+            ClayKit_TextArea(&ctx, "Area", 4, &s, cfg, NULL, 0);
+            Clay_RenderCommandArray cmds = Clay_EndLayout();
+            g_sink += (uint32_t)cmds.length;
+        }
+        double us = (now_seconds() - start) * 1e6 / (double)frames;
+
+        printf("  %8u %14.2f\n", lines, us);
+        free(starts);
+        free(buf);
+    }
+    Clay_SetCurrentContext(NULL);
+    free(clay_mem);
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void) {
+    printf("ClayKit Benchmarks\n");
+    printf("=================\n");
+
+    bench_state_lookup();
+    bench_style_cache();
+    bench_input_editing();
+    bench_input_paste();
+    bench_word_motion();
+    bench_hit_test();
+    bench_font_metrics();
+    bench_measure_batch();
+    bench_input_viewport();
+    bench_text_area();
+
+    return 0;
+}
@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 
 /* ============================================================================
@@ -100,6 +101,7 @@ TEST(init_context) {
     ClayKit_State state_buf[16];
     ClayKit_Context ctx;
 
+    memset(&ctx, 0xFF, sizeof(ctx));
     ClayKit_Init(&ctx, &theme, state_buf, 16);
 
     ASSERT_EQ(ctx.state_cap, 16);
@@ -109,6 +111,12 @@ TEST(init_context) {
     ASSERT(ctx.theme_ptr == &theme);
     ASSERT(ctx.state_ptr == state_buf);
     ASSERT_NULL(ctx.icon_callback);
+    ASSERT_NULL(ctx.measure_text);
+    ASSERT_EQ_FLOAT(ctx.cursor_blink_time, 0.0f, 0.0001f);
+    ASSERT_EQ(ctx.stats.state_slots.capacity, 16);
+    ASSERT_EQ(ctx.stats.state_slots.peak, 0);
+    ASSERT_EQ(ctx.stats.frame_arena.overflows, 0);
+    ASSERT_NULL(ctx.clay_error_handler.errorHandlerFunction);
 
     TEST_PASS();
 }
@@ -131,6 +139,8 @@ TEST(init_zeroes_state_buffer) {
         ASSERT_EQ(state_buf[i].id, 0);
         ASSERT_EQ(state_buf[i].flags, 0);
         ASSERT_EQ_FLOAT(state_buf[i].value, 0.0f, 0.001f);
+        ASSERT_EQ(state_buf[i].frame, 0);
+        ASSERT_EQ(state_buf[i].blob, 0);
     }
 
     TEST_PASS();
@@ -240,6 +250,302 @@ TEST(multiple_states) {
     TEST_PASS();
 }
 
+TEST(state_full_table_lookups) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[16];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 16);
+
+    /* Fill every slot so probes collide and wrap around the buffer */
+    for (uint32_t i = 0; i < 16; i++) {
+        ClayKit_State *s = ClayKit_GetOrCreateState(&ctx, 0x1000u + i * 7919u);
+        ASSERT_NOT_NULL(s);
+        s->value = (float)i;
+    }
+    ASSERT_EQ(ctx.state_count, 16);
+
+    for (uint32_t i = 0; i < 16; i++) {
+        ClayKit_State *s = ClayKit_GetState(&ctx, 0x1000u + i * 7919u);
+        ASSERT_NOT_NULL(s);
+        ASSERT_EQ_FLOAT(s->value, (float)i, 0.001f);
+    }
+    ASSERT_NULL(ClayKit_GetState(&ctx, 42));
+    ASSERT_NULL(ClayKit_GetOrCreateState(&ctx, 42));
+
+    TEST_PASS();
+}
+
+TEST(state_zero_id_rejected) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    /* Id 0 marks empty slots and is never a valid Clay id */
+    ASSERT_NULL(ClayKit_GetOrCreateState(&ctx, 0));
+    ASSERT_NULL(ClayKit_GetState(&ctx, 0));
+    ASSERT_EQ(ctx.state_count, 0);
+
+    TEST_PASS();
+}
+
+TEST(state_lookup_stamps_frame) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_BeginFrame(&ctx);
+    ASSERT_EQ(ctx.frame, 2);
+
+    ClayKit_State *s = ClayKit_GetOrCreateState(&ctx, 100);
+    ASSERT_EQ(s->frame, 2);
+
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_GetState(&ctx, 100);
+    ASSERT_EQ(s->frame, 3);
+
+    TEST_PASS();
+}
+
+TEST(evict_stale_states) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+
+    ClayKit_GetOrCreateState(&ctx, 100)->value = 1.0f;
+    ClayKit_GetOrCreateState(&ctx, 200)->value = 2.0f;
+
+    for (int f = 0; f < 5; f++) {
+        ClayKit_BeginFrame(&ctx);
+        ClayKit_GetState(&ctx, 100);
+    }
+
+    ASSERT_EQ(ClayKit_EvictStaleStates(&ctx, 10), 0);
+    ASSERT_EQ(ClayKit_EvictStaleStates(&ctx, 3), 1);
+    ASSERT_EQ(ctx.state_count, 1);
+    ASSERT_NULL(ClayKit_GetState(&ctx, 200));
+    ASSERT_EQ_FLOAT(ClayKit_GetState(&ctx, 100)->value, 1.0f, 0.001f);
+
+    TEST_PASS();
+}
+
+TEST(evict_keeps_probe_chains_intact) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[16];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 16);
+
+    /* Fill the table, then keep only every other id alive */
+    for (uint32_t i = 0; i < 16; i++) {
+        ClayKit_GetOrCreateState(&ctx, 0x1000u + i * 7919u)->value = (float)i;
+    }
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_BeginFrame(&ctx);
+    for (uint32_t i = 0; i < 16; i += 2) {
+        ClayKit_GetState(&ctx, 0x1000u + i * 7919u);
+    }
+
+    ASSERT_EQ(ClayKit_EvictStaleStates(&ctx, 0), 8);
+    ASSERT_EQ(ctx.state_count, 8);
+    for (uint32_t i = 0; i < 16; i++) {
+        ClayKit_State *s = ClayKit_GetState(&ctx, 0x1000u + i * 7919u);
+        if (i % 2 == 0) {
+            ASSERT_NOT_NULL(s);
+            ASSERT_EQ_FLOAT(s->value, (float)i, 0.001f);
+        } else {
+            ASSERT_NULL(s);
+        }
+    }
+
+    TEST_PASS();
+}
+
+TEST(begin_frame_auto_evicts) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[2];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 2);
+    ctx.state_max_age = 2;
+
+    /* Dynamic ids churn through a tiny buffer without running out */
+    for (uint32_t id = 1; id <= 100; id++) {
+        ClayKit_BeginFrame(&ctx);
+        ASSERT_NOT_NULL(ClayKit_GetOrCreateState(&ctx, id));
+        ClayKit_BeginFrame(&ctx);
+        ClayKit_BeginFrame(&ctx);
+        ClayKit_BeginFrame(&ctx);
+    }
+    ASSERT(ctx.state_count <= 1);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * State Pool Tests
+ * ============================================================================ */
+
+typedef struct TestScrollState {
+    float offset_x;
+    float offset_y;
+    float velocity;
+    uint32_t drag_anchor;
+    float cached_width;
+} TestScrollState;
+
+TEST(state_blob_create_and_find) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    static uint8_t pool[4096];
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+
+    ASSERT_NULL(ClayKit_FindStateBlob(&ctx, 100));
+
+    TestScrollState *a = CLAYKIT_STATE_BLOB(&ctx, 100, TestScrollState);
+    ASSERT_NOT_NULL(a);
+    ASSERT_EQ_FLOAT(a->offset_y, 0.0f, 0.001f);
+    ASSERT_EQ((uintptr_t)a % 16, 0);
+    a->offset_y = 42.0f;
+
+    ASSERT(CLAYKIT_STATE_BLOB(&ctx, 100, TestScrollState) == a);
+    ASSERT(ClayKit_FindStateBlob(&ctx, 100) == (void *)a);
+    ASSERT_NOT_NULL(ClayKit_GetState(&ctx, 100));
+    ASSERT_EQ(ctx.state_pool.blob_count, 1);
+
+    TEST_PASS();
+}
+
+TEST(state_blob_same_class_contiguous) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[16];
+    ClayKit_Context ctx;
+    static uint8_t pool[4096];
+    ClayKit_Init(&ctx, &theme, state_buf, 16);
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+
+    /* 20-byte blobs land in the 32-byte class, packed back to back */
+    uint8_t *a = (uint8_t *)CLAYKIT_STATE_BLOB(&ctx, 1, TestScrollState);
+    uint8_t *small = (uint8_t *)ClayKit_GetStateBlob(&ctx, 2, 4);
+    uint8_t *b = (uint8_t *)CLAYKIT_STATE_BLOB(&ctx, 3, TestScrollState);
+    ASSERT_NOT_NULL(small);
+    ASSERT_EQ(b - a, 32);
+    ASSERT_EQ(ctx.state_pool.pages_used, 2);
+
+    TEST_PASS();
+}
+
+TEST(state_blob_limits) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    static uint8_t pool[2 * (CLAYKIT_POOL_PAGE_SIZE + 2) + 16];
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+
+    /* No pool set */
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 1, 16));
+
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+    ASSERT_EQ(ctx.state_pool.page_count, 2);
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 1, CLAYKIT_POOL_MAX_BLOB + 1));
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 1, 0));
+
+    /* Two pages of 256-byte blobs hold eight; the ninth fails */
+    for (uint32_t i = 1; i <= 8; i++) {
+        ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, i, 256));
+    }
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 100, 16));
+
+    /* Re-seating the pool drops the old blobs, which pointed into it */
+    ClayKit_SetStatePool(&ctx, pool, CLAYKIT_POOL_PAGE_SIZE + 2 + 16);
+    ASSERT_EQ(ctx.state_pool.page_count, 1);
+    ASSERT_NULL(ClayKit_FindStateBlob(&ctx, 8));
+    ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, 8, 256));
+    ASSERT_EQ(ctx.state_pool.blob_count, 1);
+
+    /* And so does detaching it */
+    ClayKit_SetStatePool(&ctx, NULL, 0);
+    ASSERT_NULL(ClayKit_FindStateBlob(&ctx, 8));
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 8, 16));
+
+    TEST_PASS();
+}
+
+TEST(state_blob_page_reuse) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    static uint8_t pool[2 * (CLAYKIT_POOL_PAGE_SIZE + 2) + 16];
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+    ASSERT_EQ(ctx.state_pool.page_count, 2);
+
+    /* A 16-byte blob takes page 0, then grows onto a 256-byte page */
+    ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, 1, 16));
+    ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, 1, 256));
+    for (uint32_t i = 2; i <= 4; i++) {
+        ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, i, 256));
+    }
+    ASSERT_EQ(ctx.state_pool.pages_used, 2);
+
+    /* Page 0 is empty, so the 256-byte class takes it over */
+    ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, 5, 256));
+    ASSERT_EQ(ctx.state_pool.blob_count, 5);
+    ASSERT_EQ(ctx.stats.state_pool_pages.used, 2);
+    ASSERT_EQ(ctx.stats.state_pool_pages.overflows, 0);
+
+    /* The 16-byte class no longer has a page */
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 6, 16));
+
+    TEST_PASS();
+}
+
+TEST(state_blob_grows_size_class) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    static uint8_t pool[4096];
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+
+    uint32_t *small = (uint32_t *)ClayKit_GetStateBlob(&ctx, 7, 16);
+    small[0] = 0xABCD;
+    uint32_t *big = (uint32_t *)ClayKit_GetStateBlob(&ctx, 7, 64);
+    ASSERT_NOT_NULL(big);
+    ASSERT_EQ(big[0], 0xABCD);
+    ASSERT_EQ(ctx.state_pool.blob_count, 1);
+
+    /* Asking for a smaller size keeps the existing blob */
+    ASSERT(ClayKit_GetStateBlob(&ctx, 7, 16) == (void *)big);
+
+    TEST_PASS();
+}
+
+TEST(state_blob_freed_on_eviction) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    static uint8_t pool[4096];
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+
+    void *a = ClayKit_GetStateBlob(&ctx, 1, 32);
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_BeginFrame(&ctx);
+    ASSERT_EQ(ClayKit_EvictStaleStates(&ctx, 1), 1);
+    ASSERT_EQ(ctx.state_pool.blob_count, 0);
+
+    /* The freed blob is reused, zeroed */
+    uint32_t *b = (uint32_t *)ClayKit_GetStateBlob(&ctx, 2, 32);
+    ASSERT(b == a);
+    ASSERT_EQ(b[0], 0);
+
+    TEST_PASS();
+}
+
 /* ============================================================================
  * Focus Management Tests
  * ============================================================================ */
@@ -704,6 +1010,99 @@ TEST(input_ctrl_right_word) {
     TEST_PASS();
 }
 
+TEST(input_ctrl_word_stops_at_punctuation) {
+    char buf[32] = "foo.bar(x, y)";
+    ClayKit_InputState input = {
+        .buf = buf, .cap = 32, .len = 13,
+        .cursor = 0, .select_start = 0, .flags = 0
+    };
+    static const uint32_t stops[] = { 3, 4, 7, 8, 9, 11, 12, 13 };
+
+    for (int i = 0; i < 8; i++) {
+        ASSERT(ClayKit_InputHandleKey(&input, CLAYKIT_KEY_RIGHT, CLAYKIT_MOD_CTRL));
+        ASSERT_EQ(input.cursor, stops[i]);
+    }
+    /* Left stops at the start of each run */
+    static const uint32_t back[] = { 12, 11, 9, 8, 7, 4, 3, 0 };
+    for (int i = 0; i < 8; i++) {
+        ASSERT(ClayKit_InputHandleKey(&input, CLAYKIT_KEY_LEFT, CLAYKIT_MOD_CTRL));
+        ASSERT_EQ(input.cursor, back[i]);
+    }
+
+    TEST_PASS();
+}
+
+TEST(input_ctrl_backspace_delete_word) {
+    char buf[32] = "path/to  file";
+    ClayKit_InputState input = {
+        .buf = buf, .cap = 32, .len = 13,
+        .cursor = 13, .select_start = 13, .flags = 0
+    };
+
+    /* Ctrl+Backspace removes the word and the whitespace before the cursor */
+    ASSERT(ClayKit_InputHandleKey(&input, CLAYKIT_KEY_BACKSPACE, CLAYKIT_MOD_CTRL));
+    buf[input.len] = '\0';
+    ASSERT_STR_EQ(buf, "path/to  ");
+    ASSERT(ClayKit_InputHandleKey(&input, CLAYKIT_KEY_BACKSPACE, CLAYKIT_MOD_CTRL));
+    buf[input.len] = '\0';
+    ASSERT_STR_EQ(buf, "path/");
+    ASSERT_EQ(input.cursor, 5);
+
+    /* Ctrl+Delete removes the word and the whitespace after the cursor */
+    input.cursor = input.select_start = 0;
+    ASSERT(ClayKit_InputHandleKey(&input, CLAYKIT_KEY_DELETE, CLAYKIT_MOD_CTRL));
+    buf[input.len] = '\0';
+    ASSERT_STR_EQ(buf, "/");
+
+    /* With a selection, only the selection goes */
+    memcpy(buf, "one two", 7);
+    input.len = 7;
+    input.select_start = 1;
+    input.cursor = 2;
+    ASSERT(ClayKit_InputHandleKey(&input, CLAYKIT_KEY_BACKSPACE, CLAYKIT_MOD_CTRL));
+    buf[input.len] = '\0';
+    ASSERT_STR_EQ(buf, "oe two");
+
+    TEST_PASS();
+}
+
+TEST(input_select_word) {
+    char buf[32] = "ab  \xC3\xA9t\xC3\xA9!!";
+    ClayKit_InputState input = {
+        .buf = buf, .cap = 32, .len = 11,
+        .cursor = 0, .select_start = 0, .flags = 0
+    };
+
+    ClayKit_InputSelectWord(&input, 0);
+    ASSERT_EQ(input.select_start, 0);
+    ASSERT_EQ(input.cursor, 2);
+
+    /* Just past a word selects that word, inside whitespace the whitespace */
+    ClayKit_InputSelectWord(&input, 2);
+    ASSERT_EQ(input.select_start, 0);
+    ASSERT_EQ(input.cursor, 2);
+    ClayKit_InputSelectWord(&input, 3);
+    ASSERT_EQ(input.select_start, 2);
+    ASSERT_EQ(input.cursor, 4);
+
+    /* Non-ASCII letters are part of the word */
+    ClayKit_InputSelectWord(&input, 6);
+    ASSERT_EQ(input.select_start, 4);
+    ASSERT_EQ(input.cursor, 9);
+
+    /* The end of the text selects the last run */
+    ClayKit_InputSelectWord(&input, 11);
+    ASSERT_EQ(input.select_start, 9);
+    ASSERT_EQ(input.cursor, 11);
+
+    input.len = 0;
+    ClayKit_InputSelectWord(&input, 5);
+    ASSERT_EQ(input.select_start, 0);
+    ASSERT_EQ(input.cursor, 0);
+
+    TEST_PASS();
+}
+
 /* ============================================================================
  * Layout Primitive Tests
  * ============================================================================ */
@@ -2670,104 +3069,3080 @@ TEST(input_double_backspace) {
 }
 
 /* ============================================================================
- * Icon Data Tests
+ * UTF-8 Input Tests
  * ============================================================================ */
 
-TEST(icon_render_data_stores_values) {
-    /* Access the ring buffer directly since we include CLAYKIT_IMPLEMENTATION */
-    claykit_icon_slot_idx = 0;
-    ClayKit_IconRenderData *slot = &claykit_icon_slots[0];
+TEST(input_utf8_insert_encodes) {
+    char buf[32];
+    ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
 
-    slot->type = CLAYKIT_CUSTOM_ICON;
-    slot->icon_id = 42;
-    slot->color = (Clay_Color){ 255, 0, 0, 255 };
+    ASSERT(ClayKit_InputHandleChar(&s, 0xE9));     /* e acute */
+    ASSERT(ClayKit_InputHandleChar(&s, 0x20AC));   /* euro sign */
+    ASSERT(ClayKit_InputHandleChar(&s, 0x1F600));  /* emoji */
+    ASSERT_EQ(s.len, 9);
+    ASSERT_EQ(s.cursor, 9);
+    ASSERT(memcmp(buf, "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", 9) == 0);
 
-    ASSERT_EQ(slot->type, CLAYKIT_CUSTOM_ICON);
-    ASSERT_EQ(slot->icon_id, 42);
-    ASSERT_EQ(slot->color.r, 255);
-    ASSERT_EQ(slot->color.g, 0);
+    /* C1 controls, surrogates and values past U+10FFFF are rejected */
+    ASSERT(!ClayKit_InputHandleChar(&s, 0x85));
+    ASSERT(!ClayKit_InputHandleChar(&s, 0xD800));
+    ASSERT(!ClayKit_InputHandleChar(&s, 0x110000));
+    ASSERT_EQ(s.len, 9);
+
+    TEST_PASS();
+}
+
+TEST(input_utf8_capacity_is_all_or_nothing) {
+    char buf[4] = "ab";
+    ClayKit_InputState s = { .buf = buf, .cap = 4, .len = 2, .cursor = 2, .select_start = 2, .flags = 0 };
+
+    /* One byte of room left: a two-byte codepoint doesn't fit */
+    ASSERT(!ClayKit_InputHandleChar(&s, 0xE9));
+    ASSERT_EQ(s.len, 2);
+    ASSERT(ClayKit_InputHandleChar(&s, 'c'));
+    ASSERT_EQ(s.len, 3);
 
     TEST_PASS();
 }
 
-TEST(icon_render_data_ring_wraps) {
-    /* Verify wrapping at boundary */
-    claykit_icon_slot_idx = 31;
-    ClayKit_IconRenderData *slot31 = &claykit_icon_slots[31 % 32];
-    slot31->icon_id = 100;
+TEST(input_utf8_moves_and_deletes_codepoints) {
+    /* "a", e acute, euro sign, emoji, "b" */
+    char buf[32] = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80" "b";
+    ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 11, .cursor = 11, .select_start = 11, .flags = 0 };
 
-    claykit_icon_slot_idx = 32;
-    ClayKit_IconRenderData *slot0 = &claykit_icon_slots[32 % 32];
-    slot0->icon_id = 200;
+    static const uint32_t stops[] = { 10, 6, 3, 1, 0 };
+    for (int i = 0; i < 5; i++) {
+        ClayKit_InputHandleKey(&s, CLAYKIT_KEY_LEFT, 0);
+        ASSERT_EQ(s.cursor, stops[i]);
+    }
+    for (int i = 3; i >= 0; i--) {
+        ClayKit_InputHandleKey(&s, CLAYKIT_KEY_RIGHT, 0);
+        ASSERT_EQ(s.cursor, stops[i]);
+    }
 
-    /* Slot 0 should be overwritten */
-    ASSERT_EQ(claykit_icon_slots[0].icon_id, 200);
-    ASSERT_EQ(claykit_icon_slots[31].icon_id, 100);
+    /* Cursor after the euro sign: backspace removes all three bytes */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_LEFT, 0);
+    ASSERT_EQ(s.cursor, 6);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    ASSERT_EQ(s.cursor, 3);
+    ASSERT_EQ(s.len, 8);
 
-    /* Reset for other tests */
-    claykit_icon_slot_idx = 0;
+    /* Delete removes the four-byte emoji */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DELETE, 0);
+    ASSERT_EQ(s.len, 4);
+    ASSERT(memcmp(buf, "a\xC3\xA9" "b", 4) == 0);
 
     TEST_PASS();
 }
 
-/* ============================================================================
- * Tooltip Size Tests
- * ============================================================================ */
+/* Byte-at-a-time word motion, the behaviour the vector scans must match:
+ * 0 whitespace, 1 punctuation, 2 word (including all non-ASCII bytes) */
+static int test_char_class(char ch) {
+    unsigned char c = (unsigned char)ch;
+    if (c == ' ' || (c >= 9 && c <= 13)) return 0;
+    if (c >= 0x80 || c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+        return 2;
+    }
+    return 1;
+}
 
-TEST(tooltip_style_sizes) {
-    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
-    ClayKit_State state_buf[4];
-    ClayKit_Context ctx;
-    ClayKit_Init(&ctx, &theme, state_buf, 4);
+static uint32_t test_word_left(const char *t, uint32_t i) {
+    while (i > 0 && test_char_class(t[i - 1]) == 0) i--;
+    if (i > 0) {
+        int cls = test_char_class(t[i - 1]);
+        while (i > 0 && test_char_class(t[i - 1]) == cls) i--;
+    }
+    return i;
+}
 
-    /* All positions should return same style */
-    ClayKit_TooltipStyle top = ClayKit_ComputeTooltipStyle(&ctx, (ClayKit_TooltipConfig){ .position = CLAYKIT_TOOLTIP_TOP });
-    ClayKit_TooltipStyle bottom = ClayKit_ComputeTooltipStyle(&ctx, (ClayKit_TooltipConfig){ .position = CLAYKIT_TOOLTIP_BOTTOM });
+static uint32_t test_word_right(const char *t, uint32_t len, uint32_t i) {
+    if (i < len && test_char_class(t[i]) != 0) {
+        int cls = test_char_class(t[i]);
+        while (i < len && test_char_class(t[i]) == cls) i++;
+    }
+    while (i < len && test_char_class(t[i]) == 0) i++;
+    return i;
+}
 
-    ASSERT_EQ(top.font_size, bottom.font_size);
-    ASSERT_EQ(top.padding_x, bottom.padding_x);
-    ASSERT_EQ(top.corner_radius, bottom.corner_radius);
+TEST(input_utf8_word_motion_long_text) {
+    static const char *pieces[] = {
+        " ", "   ", "word", "\xE6\x97\xA5\xE6\x9C\xAC", "\xC3\xA9t\xC3\xA9", "\t\n", "a_b9", "::", ".,!?",
+        "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVphYmNkZWZnaGlqa2xtbm9wcXJzdHV2", "+/==", "\x7F\x01"
+    };
+    char text[256], buf[256];
+    uint32_t seed = 0x9E3779B9u;
+
+    for (int round = 0; round < 200; round++) {
+        uint32_t len = 0;
+        while (len < 180) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            const char *p = pieces[seed % 12];
+            uint32_t n = (uint32_t)strlen(p);
+            memcpy(text + len, p, n);
+            len += n;
+        }
+
+        for (int gap = 0; gap < 2; gap++) {
+            memcpy(buf, text, len);
+            ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = len, .cursor = 0, .select_start = 0, .flags = 0 };
+            if (gap) {
+                ClayKit_InputSetGapBuffer(&s, true);
+                /* Park the gap in the middle so scans cross it */
+                s.cursor = s.select_start = (seed >> 4) % len;
+                while (s.cursor < len && (text[s.cursor] & 0xC0) == 0x80) s.cursor++;
+                s.select_start = s.cursor;
+                ClayKit_InputHandleChar(&s, 'x');
+                ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+            }
+
+            uint32_t expect = 0;
+            s.cursor = s.select_start = 0;
+            while (expect < len) {
+                expect = test_word_right(text, len, expect);
+                ClayKit_InputHandleKey(&s, CLAYKIT_KEY_RIGHT, CLAYKIT_MOD_CTRL);
+                ASSERT_EQ(s.cursor, expect);
+            }
+            while (expect > 0) {
+                expect = test_word_left(text, expect);
+                ClayKit_InputHandleKey(&s, CLAYKIT_KEY_LEFT, CLAYKIT_MOD_CTRL);
+                ASSERT_EQ(s.cursor, expect);
+            }
+        }
+    }
 
     TEST_PASS();
 }
 
-/* ============================================================================
- * Alert Icon Size Tests
- * ============================================================================ */
+static ClayKit_TextDimensions test_byte_width(const char *text, uint32_t length, uint16_t font_id,
+                                              uint16_t font_size, void *user_data) {
+    (void)text; (void)font_id; (void)font_size; (void)user_data;
+    ClayKit_TextDimensions d = { (float)length * 10.0f, 10.0f };
+    return d;
+}
 
-TEST(alert_style_icon_size) {
+TEST(input_utf8_cursor_from_x_on_boundaries) {
     ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
     ClayKit_State state_buf[4];
     ClayKit_Context ctx;
     ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = test_byte_width;
 
-    /* Default icon size when not specified */
-    ClayKit_AlertConfig cfg1 = { .icon = { .id = 1, .size = 0 } };
-    ClayKit_AlertStyle style1 = ClayKit_ComputeAlertStyle(&ctx, cfg1);
-    ASSERT_EQ(style1.icon_size, 20);
-
-    /* Custom icon size */
-    ClayKit_AlertConfig cfg2 = { .icon = { .id = 1, .size = 32 } };
-    ClayKit_AlertStyle style2 = ClayKit_ComputeAlertStyle(&ctx, cfg2);
-    ASSERT_EQ(style2.icon_size, 32);
+    /* "a", euro sign, "b": boundaries at 0, 1, 4, 5 (x = 0, 10, 40, 50) */
+    const char *text = "a\xE2\x82\xAC" "b";
+    ASSERT_EQ(ClayKit_InputGetCursorFromX(&ctx, text, 5, 0, 16, 4.0f), 0);
+    ASSERT_EQ(ClayKit_InputGetCursorFromX(&ctx, text, 5, 0, 16, 20.0f), 1);
+    ASSERT_EQ(ClayKit_InputGetCursorFromX(&ctx, text, 5, 0, 16, 30.0f), 4);
+    ASSERT_EQ(ClayKit_InputGetCursorFromX(&ctx, text, 5, 0, 16, 60.0f), 5);
 
     TEST_PASS();
 }
 
 /* ============================================================================
- * Checkbox/Switch Disabled Tests
+ * Bulk Insert Tests
  * ============================================================================ */
 
-TEST(checkbox_disabled_state) {
-    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
-    ClayKit_State state_buf[4];
-    ClayKit_Context ctx;
-    ClayKit_Init(&ctx, &theme, state_buf, 4);
+TEST(input_insert_text_replaces_selection) {
+    for (int gap = 0; gap < 2; gap++) {
+        char buf[32] = "hello world";
+        ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 11, .cursor = 6, .select_start = 11, .flags = 0 };
+        ClayKit_InputSetGapBuffer(&s, gap != 0);
+
+        ASSERT_EQ(ClayKit_InputInsertText(&s, "there, friend", 13), 13);
+        ASSERT_EQ(s.len, 19);
+        ASSERT_EQ(s.cursor, 19);
+        ASSERT_EQ(s.select_start, 19);
+        ASSERT(memcmp(ClayKit_InputText(&s), "hello there, friend", 19) == 0);
+
+        /* Insert in the middle with no selection */
+        s.cursor = s.select_start = 5;
+        ASSERT_EQ(ClayKit_InputInsertText(&s, "!!", 2), 2);
+        ASSERT_EQ(s.cursor, 7);
+        ASSERT(memcmp(ClayKit_InputText(&s), "hello!! there, friend", 21) == 0);
+    }
 
-    ClayKit_CheckboxConfig cfg = { .color_scheme = CLAYKIT_COLOR_PRIMARY, .disabled = true };
+    TEST_PASS();
+}
 
-    /* Disabled checked: muted color */
-    Clay_Color disabled_checked = ClayKit_CheckboxBgColor(&ctx, cfg, true, false);
+TEST(input_insert_text_truncates_on_codepoint) {
+    char buf[8] = "ab";
+    ClayKit_InputState s = { .buf = buf, .cap = 8, .len = 2, .cursor = 2, .select_start = 2, .flags = 0 };
+
+    /* Five bytes of room: "x" + two e acutes (5 bytes) fit, the euro sign is cut */
+    const char *text = "x\xC3\xA9\xC3\xA9\xE2\x82\xAC";
+    ASSERT_EQ(ClayKit_InputInsertText(&s, text, 8), 5);
+    ASSERT_EQ(s.len, 7);
+    ASSERT_EQ(s.cursor, 7);
+    ASSERT(memcmp(buf, "abx\xC3\xA9\xC3\xA9", 7) == 0);
+
+    /* Full: nothing more goes in */
+    ASSERT_EQ(ClayKit_InputInsertText(&s, "y", 1), 0);
+    ASSERT_EQ(s.len, 7);
+
+    /* One byte of room that would split a codepoint inserts nothing */
+    s.cursor = s.select_start = 0;
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DELETE, 0);
+    ASSERT_EQ(ClayKit_InputInsertText(&s, "\xC3\xA9", 2), 0);
+    ASSERT_EQ(s.len, 6);
+
+    TEST_PASS();
+}
+
+TEST(input_replace_range_matches_typing) {
+    static char typed_buf[4096], bulk_buf[4096], paste[3000];
+    uint32_t seed = 7;
+
+    for (uint32_t i = 0; i < sizeof(paste); i++) {
+        seed = seed * 1103515245u + 12345u;
+        paste[i] = (char)('a' + (seed >> 16) % 26);
+    }
+
+    for (int gap = 0; gap < 2; gap++) {
+        ClayKit_InputState typed = { .buf = typed_buf, .cap = 4096, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+        ClayKit_InputState bulk = { .buf = bulk_buf, .cap = 4096, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+        ClayKit_InputSetGapBuffer(&bulk, gap != 0);
+
+        ClayKit_InputInsertText(&typed, "head  tail", 10);
+        ClayKit_InputInsertText(&bulk, "head  tail", 10);
+        typed.cursor = typed.select_start = 5;
+        for (uint32_t i = 0; i < sizeof(paste); i++) {
+            ClayKit_InputHandleChar(&typed, (uint32_t)paste[i]);
+        }
+
+        /* Out-of-range and reversed bounds are clamped */
+        ASSERT_EQ(ClayKit_InputReplaceRange(&bulk, 5, 5, paste, sizeof(paste)), sizeof(paste));
+        ASSERT_EQ(bulk.len, typed.len);
+        ASSERT_EQ(bulk.cursor, typed.cursor);
+        ASSERT(memcmp(ClayKit_InputText(&bulk), typed_buf, typed.len) == 0);
+
+        ASSERT_EQ(ClayKit_InputReplaceRange(&bulk, 9999, 4, "!", 1), 1);
+        ASSERT_EQ(bulk.len, typed.len + 1);
+        ASSERT(memcmp(ClayKit_InputText(&bulk) + 4, "!", 1) == 0);
+        ASSERT(memcmp(ClayKit_InputText(&bulk) + bulk.len - 4, "tail", 4) == 0);
+
+        /* A range starting mid-codepoint is widened to the whole codepoint */
+        ClayKit_InputReplaceRange(&bulk, 0, bulk.len, "a\xE2\x82\xAC" "b", 5);
+        ASSERT_EQ(ClayKit_InputReplaceRange(&bulk, 2, 3, "c", 1), 1);
+        ASSERT_EQ(bulk.len, 3);
+        ASSERT_EQ(bulk.cursor, 2);
+        ASSERT(memcmp(ClayKit_InputText(&bulk), "acb", 3) == 0);
+    }
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Undo History Tests
+ * ============================================================================ */
+
+static bool test_input_equals(ClayKit_InputState *s, const char *text) {
+    uint32_t len = (uint32_t)strlen(text);
+    return s->len == len && memcmp(ClayKit_InputText(s), text, len) == 0;
+}
+
+TEST(input_undo_coalesces_typing) {
+    char buf[32];
+    uint8_t mem[256];
+    ClayKit_InputHistory history;
+    ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputSetHistory(&s, &history, mem, sizeof(mem));
+
+    const char *typed = "hello world";
+    for (const char *c = typed; *c; c++) {
+        ClayKit_InputHandleChar(&s, (uint32_t)*c);
+    }
+
+    /* One entry per word */
+    ASSERT(ClayKit_InputHandleKey(&s, CLAYKIT_KEY_Z, CLAYKIT_MOD_CTRL));
+    ASSERT(test_input_equals(&s, "hello"));
+    ASSERT_EQ(s.cursor, 5);
+    ASSERT(ClayKit_InputUndo(&s));
+    ASSERT(test_input_equals(&s, ""));
+    ASSERT(!ClayKit_InputUndo(&s));
+
+    ASSERT(ClayKit_InputHandleKey(&s, CLAYKIT_KEY_Y, CLAYKIT_MOD_CTRL));
+    ASSERT(test_input_equals(&s, "hello"));
+    ASSERT(ClayKit_InputHandleKey(&s, CLAYKIT_KEY_Z, CLAYKIT_MOD_CTRL | CLAYKIT_MOD_SHIFT));
+    ASSERT(test_input_equals(&s, "hello world"));
+    ASSERT_EQ(s.cursor, 11);
+    ASSERT(!ClayKit_InputRedo(&s));
+
+    /* Moving the cursor ends the run */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_HOME, 0);
+    ClayKit_InputHandleChar(&s, '>');
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_END, 0);
+    ClayKit_InputHandleChar(&s, '!');
+    ASSERT(ClayKit_InputUndo(&s));
+    ASSERT(test_input_equals(&s, ">hello world"));
+    ASSERT(ClayKit_InputUndo(&s));
+    ASSERT(test_input_equals(&s, "hello world"));
+
+    TEST_PASS();
+}
+
+TEST(input_undo_restores_selection) {
+    char buf[32] = "one two three";
+    uint8_t mem[256];
+    ClayKit_InputHistory history;
+    ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 13, .cursor = 7, .select_start = 4, .flags = 0 };
+    ClayKit_InputSetHistory(&s, &history, mem, sizeof(mem));
+
+    ClayKit_InputHandleChar(&s, '2');
+    ASSERT(test_input_equals(&s, "one 2 three"));
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    ClayKit_InputInsertText(&s, "TWO", 3);
+    ASSERT(test_input_equals(&s, "one TWO three"));
+
+    ASSERT(ClayKit_InputUndo(&s));
+    ASSERT(test_input_equals(&s, "one  three"));
+    ASSERT(ClayKit_InputUndo(&s));
+    ASSERT(test_input_equals(&s, "one 2 three"));
+    ASSERT(ClayKit_InputUndo(&s));
+    ASSERT(test_input_equals(&s, "one two three"));
+    ASSERT_EQ(s.cursor, 7);
+    ASSERT_EQ(s.select_start, 4);
+
+    /* A new edit after undoing drops the redo entries */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DELETE, 0);
+    ASSERT(test_input_equals(&s, "one  three"));
+    ASSERT(!ClayKit_InputRedo(&s));
+
+    /* Clearing forgets both directions */
+    ClayKit_InputClearHistory(&s);
+    ASSERT(!ClayKit_InputUndo(&s));
+
+    TEST_PASS();
+}
+
+TEST(input_undo_ring_drops_oldest) {
+    static char snaps[64][32];
+    char buf[32];
+    uint8_t mem[96];
+    uint32_t seed = 99;
+
+    for (int gap = 0; gap < 2; gap++) {
+        ClayKit_InputHistory history;
+        ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+        ClayKit_InputSetGapBuffer(&s, gap != 0);
+        ClayKit_InputSetHistory(&s, &history, mem, sizeof(mem));
+
+        /* Random edits, remembering the text after each one */
+        int count = 0;
+        while (count < 63) {
+            memcpy(snaps[count], ClayKit_InputText(&s), s.len);
+            snaps[count][s.len] = '\0';
+            seed = seed * 1103515245u + 12345u;
+            uint32_t r = seed >> 16;
+            s.cursor = s.len ? r % (s.len + 1) : 0;
+            s.select_start = (r & 1) && s.len ? (r >> 8) % (s.len + 1) : s.cursor;
+            bool changed;
+            if (r % 3 == 0) {
+                changed = ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+            } else {
+                changed = ClayKit_InputInsertText(&s, "abcde" + r % 4, 1 + (r >> 4) % 2) > 0;
+            }
+            if (changed) count++;
+        }
+        memcpy(snaps[count], ClayKit_InputText(&s), s.len);
+        snaps[count][s.len] = '\0';
+
+        /* Undo walks back through a suffix of the snapshots */
+        int undone = 0;
+        while (ClayKit_InputUndo(&s)) {
+            undone++;
+            ASSERT(test_input_equals(&s, snaps[count - undone]));
+        }
+        ASSERT(undone > 0);
+        ASSERT(undone < count);
+        ASSERT(history.undo_len == 0);
+
+        for (int i = undone - 1; i >= 0; i--) {
+            ASSERT(ClayKit_InputRedo(&s));
+            ASSERT(test_input_equals(&s, snaps[count - i]));
+        }
+        ASSERT(!ClayKit_InputRedo(&s));
+    }
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Hit-Test Cache Tests
+ * ============================================================================ */
+
+/* Proportional widths with 2px letter spacing and an "AV" kerning pair.
+ * user_data counts calls. */
+static ClayKit_TextDimensions test_kerned_width(const char *text, uint32_t length, uint16_t font_id,
+                                                uint16_t font_size, void *user_data) {
+    (void)font_id;
+    float width = 0.0f;
+    int glyphs = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)text[i];
+        if ((c & 0xC0) == 0x80) continue;
+        width += 6.0f + (float)(c % 7) + (float)(font_size - 16);
+        if (i > 0 && c == 'V' && text[i - 1] == 'A') width -= 3.0f;
+        glyphs++;
+    }
+    if (glyphs > 1) width += 2.0f * (float)(glyphs - 1);
+    (*(uint32_t *)user_data)++;
+    ClayKit_TextDimensions d = { width, 16.0f };
+    return d;
+}
+
+/* The linear scan GetCursorFromX used before, as a reference */
+static uint32_t test_cursor_from_x_linear(ClayKit_Context *ctx, const char *text, uint32_t length, float x) {
+    if (length == 0 || x <= 0) return 0;
+    float prev_width = 0.0f;
+    uint32_t prev = 0;
+    for (uint32_t i = 1; i <= length; i++) {
+        if (i < length && ((uint8_t)text[i] & 0xC0) == 0x80) continue;
+        float width = ClayKit_MeasureTextWidth(ctx, text, i, 0, 16);
+        if (x < (prev_width + width) / 2.0f) return prev;
+        prev_width = width;
+        prev = i;
+    }
+    return length;
+}
+
+TEST(input_delta_reports_edits) {
+    char buf[32] = "hello world";
+    uint8_t mem[256];
+    ClayKit_InputHistory history;
+    ClayKit_InputDelta delta;
+    ClayKit_InputState s = { .buf = buf, .cap = 32, .len = 11, .cursor = 5, .select_start = 5, .flags = 0 };
+
+    /* Nothing is reported without a delta attached */
+    ClayKit_InputHandleChar(&s, ',');
+    ClayKit_InputDelta d = ClayKit_InputTakeDelta(&s);
+    ASSERT_EQ(d.edits, 0);
+
+    ClayKit_InputSetHistory(&s, &history, mem, sizeof(mem));
+    ClayKit_InputSetDelta(&s, &delta);
+    ASSERT_EQ(delta.edits, 0);
+
+    ClayKit_InputHandleChar(&s, '!');
+    d = ClayKit_InputTakeDelta(&s);
+    ASSERT_EQ(d.start, 6);
+    ASSERT_EQ(d.removed, 0);
+    ASSERT_EQ(d.inserted, 1);
+    ASSERT_EQ(d.edits, 1);
+
+    /* Motion changes nothing */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_LEFT, CLAYKIT_MOD_CTRL);
+    ASSERT_EQ(ClayKit_InputTakeDelta(&s).edits, 0);
+
+    /* Typing over a selection is one replacement */
+    s.select_start = 0;
+    s.cursor = 5;
+    ClayKit_InputHandleChar(&s, 'J');
+    d = ClayKit_InputTakeDelta(&s);
+    ASSERT(test_input_equals(&s, "J,! world"));
+    ASSERT_EQ(d.start, 0);
+    ASSERT_EQ(d.removed, 5);
+    ASSERT_EQ(d.inserted, 1);
+
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_END, 0);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, CLAYKIT_MOD_CTRL);
+    d = ClayKit_InputTakeDelta(&s);
+    ASSERT_EQ(d.start, 4);
+    ASSERT_EQ(d.removed, 5);
+    ASSERT_EQ(d.inserted, 0);
+
+    /* Undo reports the edit it reverts */
+    ClayKit_InputUndo(&s);
+    d = ClayKit_InputTakeDelta(&s);
+    ASSERT_EQ(d.start, 4);
+    ASSERT_EQ(d.removed, 0);
+    ASSERT_EQ(d.inserted, 5);
+
+    /* Edits between takes merge into one covering range */
+    ClayKit_InputReplaceRange(&s, 0, 1, "H", 1);
+    ClayKit_InputReplaceRange(&s, 5, 8, "R", 1);
+    d = ClayKit_InputTakeDelta(&s);
+    ASSERT(test_input_equals(&s, "H,! wRd"));
+    ASSERT_EQ(d.start, 0);
+    ASSERT_EQ(d.removed, 8);
+    ASSERT_EQ(d.inserted, 6);
+    ASSERT_EQ(d.edits, 2);
+
+    TEST_PASS();
+}
+
+TEST(input_delta_replays_to_same_text) {
+    static const uint32_t keys[] = {
+        CLAYKIT_KEY_BACKSPACE, CLAYKIT_KEY_DELETE, CLAYKIT_KEY_LEFT, CLAYKIT_KEY_RIGHT,
+        CLAYKIT_KEY_HOME, CLAYKIT_KEY_END, CLAYKIT_KEY_Z, CLAYKIT_KEY_Y
+    };
+    char buf[128], shadow[128], next[128];
+    uint8_t mem[512];
+    ClayKit_InputHistory history;
+    ClayKit_InputDelta delta;
+    uint32_t seed = 0x2545F491u;
+
+    for (int gap = 0; gap < 2; gap++) {
+        ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+        ClayKit_InputSetGapBuffer(&s, gap != 0);
+        ClayKit_InputSetHistory(&s, &history, mem, sizeof(mem));
+        ClayKit_InputSetDelta(&s, &delta);
+        uint32_t shadow_len = 0;
+
+        for (int step = 0; step < 4000; step++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            if (seed % 3 == 0) {
+                ClayKit_InputHandleChar(&s, (seed >> 8) % 4 == 0 ? ' ' : (seed >> 8) % 4 == 1 ? 0xE9 : 'a' + (seed >> 10) % 26);
+            } else if (seed % 3 == 1) {
+                ClayKit_InputHandleKey(&s, keys[(seed >> 8) % 8], (seed >> 12) % 4 == 0 ? CLAYKIT_MOD_CTRL : (seed >> 12) % 4 == 1 ? CLAYKIT_MOD_SHIFT : 0);
+            } else {
+                ClayKit_InputReplaceRange(&s, (seed >> 8) % (s.len + 1), (seed >> 16) % (s.len + 1), "xy\xC3\xA9", (seed >> 4) % 5);
+            }
+
+            /* Take every few steps; patching the old text must give the new */
+            if ((seed >> 20) % 4 != 0) continue;
+            ClayKit_InputDelta d = ClayKit_InputTakeDelta(&s);
+            const char *text = ClayKit_InputText(&s);
+            if (d.edits == 0) {
+                ASSERT_EQ(shadow_len, s.len);
+                ASSERT(memcmp(shadow, text, s.len) == 0);
+                continue;
+            }
+            ASSERT(d.start + d.removed <= shadow_len);
+            ASSERT_EQ(shadow_len - d.removed + d.inserted, s.len);
+            memcpy(next, shadow, d.start);
+            memcpy(next + d.start, text + d.start, d.inserted);
+            memcpy(next + d.start + d.inserted, shadow + d.start + d.removed, shadow_len - d.start - d.removed);
+            ASSERT(memcmp(next, text, s.len) == 0);
+            memcpy(shadow, text, s.len);
+            shadow_len = s.len;
+        }
+    }
+
+    TEST_PASS();
+}
+
+TEST(input_hit_test_matches_linear_scan) {
+    static const char *pieces[] = { "A", "V", "w", " ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+    char buf[256];
+    char text[256];
+    float mem[256];
+    uint32_t calls = 0;
+    uint32_t seed = 5;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = test_kerned_width;
+    ctx.measure_text_user_data = &calls;
+
+    for (int gap = 0; gap < 2; gap++) {
+        ClayKit_InputAdvanceCache cache;
+        ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+        ClayKit_InputSetGapBuffer(&s, gap != 0);
+        ClayKit_InputSetAdvanceCache(&s, &cache, mem, 256);
+
+        for (int i = 0; i < 60; i++) {
+            seed = seed * 1103515245u + 12345u;
+            const char *piece = pieces[(seed >> 16) % 7];
+            ClayKit_InputInsertText(&s, piece, (uint32_t)strlen(piece));
+        }
+        memcpy(text, ClayKit_InputText(&s), s.len);
+
+        /* Type a kerned pair mid-text; in gap mode the gap stays there */
+        uint32_t mid = s.len / 2;
+        while (((uint8_t)text[mid] & 0xC0) == 0x80) mid--;
+        s.cursor = s.select_start = mid;
+        ClayKit_InputHandleChar(&s, 'A');
+        ClayKit_InputHandleChar(&s, 'V');
+        memcpy(text, s.buf, s.cursor);
+        memcpy(text + s.cursor, s.buf + s.cursor + (gap ? s.cap - s.len : 0), s.len - s.cursor);
+
+        float total = ClayKit_MeasureTextWidth(&ctx, text, s.len, 0, 16);
+        for (float x = -5.0f; x < total + 20.0f; x += 1.25f) {
+            uint32_t expected = test_cursor_from_x_linear(&ctx, text, s.len, x);
+            ASSERT_EQ(ClayKit_InputGetCursorFromX(&ctx, text, s.len, 0, 16, x), expected);
+            ASSERT_EQ(ClayKit_InputHitTest(&ctx, &s, 0, 16, x), expected);
+        }
+        for (uint32_t i = 0; i <= s.len; i++) {
+            if (i < s.len && ((uint8_t)text[i] & 0xC0) == 0x80) continue;
+            ASSERT_EQ_FLOAT(ClayKit_InputOffsetX(&ctx, &s, 0, 16, i),
+                            ClayKit_MeasureTextWidth(&ctx, text, i, 0, 16), 0.01f);
+        }
+    }
+
+    TEST_PASS();
+}
+
+TEST(input_advance_cache_invalidation) {
+    char buf[128];
+    float mem[128];
+    uint32_t calls = 0;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_InputAdvanceCache cache;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = test_kerned_width;
+    ctx.measure_text_user_data = &calls;
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 128);
+    for (int i = 0; i < 100; i++) {
+        ClayKit_InputHandleChar(&s, (uint32_t)('a' + i % 26));
+    }
+
+    /* A click near the start only measures the first few codepoints */
+    ClayKit_InputHitTest(&ctx, &s, 0, 16, 30.0f);
+    ASSERT(cache.valid < 10);
+
+    /* Once filled, hit-tests don't call the measure function at all */
+    ClayKit_InputHitTest(&ctx, &s, 0, 16, 1e6f);
+    ASSERT_EQ(cache.valid, 101);
+    calls = 0;
+    for (float x = 0.0f; x < 1200.0f; x += 7.0f) {
+        ClayKit_InputHitTest(&ctx, &s, 0, 16, x);
+    }
+    ASSERT_EQ(calls, 0);
+
+    /* An edit keeps the entries up to the edit point */
+    s.cursor = s.select_start = 90;
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    ASSERT_EQ(cache.valid, 90);
+    ClayKit_InputHitTest(&ctx, &s, 0, 16, 1e6f);
+    ASSERT(calls <= 2 * 11 + 1);
+
+    /* A different font starts over */
+    calls = 0;
+    ClayKit_InputOffsetX(&ctx, &s, 0, 20, 5);
+    ASSERT_EQ(cache.valid, 6);
+    ASSERT_EQ(cache.font_size, 20);
+
+    /* Text longer than the cache falls back to measuring */
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 50);
+    ASSERT_EQ(ClayKit_InputHitTest(&ctx, &s, 0, 16, 1e6f), s.len);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Font Metrics Tests
+ * ============================================================================ */
+
+/* Advances for codepoints 32..126: 4 to 8 px, varying by codepoint */
+static void test_font_advances(float *adv) {
+    for (uint32_t i = 0; i < 95; i++) adv[i] = (float)(4 + i % 5);
+}
+
+static float test_font_width(const float *adv, const char *text) {
+    float width = 0.0f;
+    for (; *text; text++) width += adv[(uint8_t)*text - 32];
+    return width;
+}
+
+TEST(font_metrics_measure_without_callback) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    float adv[95];
+    test_font_advances(adv);
+    ClayKit_FontMetrics m = {0};
+    m.font_id = 1;
+    m.font_size = 16;
+    m.first = 32;
+    m.count = 95;
+    m.advances = adv;
+    m.fallback = 12.0f;
+    ClayKit_RegisterFontMetrics(&ctx, &m);
+
+    /* Long enough for the four-byte steps and a tail */
+    const char *text = "The quick brown fox jumps over the lazy dog!";
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, text, (uint32_t)strlen(text), 1, 16),
+                    test_font_width(adv, text), 0.001f);
+
+    /* Codepoints outside the table, and malformed bytes, use the fallback */
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "a\xC3\xA9" "b", 4, 1, 16), adv['a' - 32] + 12.0f + adv['b' - 32], 0.001f);
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "a\xC3", 2, 1, 16), adv['a' - 32] + 12.0f, 0.001f);
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "\t", 1, 1, 16), 12.0f, 0.001f);
+
+    /* Other fonts and sizes still go to the callback, if any */
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "ab", 2, 1, 20), 0.0f, 0.001f);
+    uint32_t calls = 0;
+    ctx.measure_text = test_kerned_width;
+    ctx.measure_text_user_data = &calls;
+    ClayKit_MeasureTextWidth(&ctx, "ab", 2, 1, 16);
+    ASSERT_EQ(calls, 0);
+    ClayKit_MeasureTextWidth(&ctx, "ab", 2, 2, 16);
+    ASSERT_EQ(calls, 1);
+
+    TEST_PASS();
+}
+
+TEST(font_metrics_kerning_and_replace) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    float adv[95], wide[95];
+    test_font_advances(adv);
+    for (int i = 0; i < 95; i++) wide[i] = 10.0f;
+    static const ClayKit_KerningPair pairs[] = {
+        { 'A', 'V', -3.0f }, { 'T', 'o', -2.0f }, { 'V', 'A', -1.5f }
+    };
+    ClayKit_FontMetrics m = {0};
+    m.font_size = 16;
+    m.first = 32;
+    m.count = 95;
+    m.advances = adv;
+    m.kerning = pairs;
+    m.kerning_count = 3;
+    ClayKit_RegisterFontMetrics(&ctx, &m);
+
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "AVA", 3, 0, 16), test_font_width(adv, "AVA") - 4.5f, 0.001f);
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "To To", 5, 0, 16), test_font_width(adv, "To To") - 4.0f, 0.001f);
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "oT", 2, 0, 16), test_font_width(adv, "oT"), 0.001f);
+
+    /* Registering the same font and size again replaces the table */
+    ClayKit_FontMetrics m2 = m;
+    m2.advances = wide;
+    m2.kerning_count = 0;
+    ClayKit_RegisterFontMetrics(&ctx, &m2);
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "AVA", 3, 0, 16), 30.0f, 0.001f);
+    ASSERT(ctx.font_metrics == &m2);
+    ASSERT_NULL(m2.next);
+    ClayKit_RegisterFontMetrics(&ctx, &m);
+    ASSERT(ctx.font_metrics == &m);
+    ASSERT_NULL(m.next);
+
+    TEST_PASS();
+}
+
+TEST(font_metrics_drive_hit_test) {
+    char buf[32] = "hello world";
+    float mem[32];
+    ClayKit_InputAdvanceCache cache;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    float adv[95];
+    for (int i = 0; i < 95; i++) adv[i] = 10.0f;
+    ClayKit_FontMetrics m = {0};
+    m.font_size = 16;
+    m.first = 32;
+    m.count = 95;
+    m.advances = adv;
+    ClayKit_RegisterFontMetrics(&ctx, &m);
+
+    /* No callback at all: hit-testing works from the table, with and
+     * without an advance cache */
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 11, .cursor = 0, .select_start = 0, .flags = 0 };
+    ASSERT_EQ(ClayKit_InputGetCursorFromX(&ctx, buf, 11, 0, 16, 34.0f), 3);
+    ASSERT_EQ(ClayKit_InputHitTest(&ctx, &s, 0, 16, 36.0f), 4);
+    ASSERT_EQ_FLOAT(ClayKit_InputOffsetX(&ctx, &s, 0, 16, 5), 50.0f, 0.001f);
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 32);
+    ASSERT_EQ(ClayKit_InputHitTest(&ctx, &s, 0, 16, 36.0f), 4);
+    ASSERT_EQ_FLOAT(ClayKit_InputOffsetX(&ctx, &s, 0, 16, 11), 110.0f, 0.001f);
+
+    /* Unregistered sizes have nothing to measure with */
+    ASSERT_EQ(ClayKit_InputHitTest(&ctx, &s, 0, 20, 36.0f), 0);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Icon Data Tests
+ * ============================================================================ */
+
+TEST(icon_render_data_stores_values) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    uint32_t arena[16];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+
+    ClayKit_IconRenderData *slot = (ClayKit_IconRenderData *)ClayKit_FrameAlloc(
+        &ctx, sizeof(ClayKit_IconRenderData), sizeof(uint32_t));
+    ASSERT_NOT_NULL(slot);
+
+    slot->type = CLAYKIT_CUSTOM_ICON;
+    slot->icon_id = 42;
+    slot->color = (Clay_Color){ 255, 0, 0, 255 };
+
+    ASSERT_EQ(slot->type, CLAYKIT_CUSTOM_ICON);
+    ASSERT_EQ(slot->icon_id, 42);
+    ASSERT_EQ(slot->color.r, 255);
+    ASSERT_EQ(slot->color.g, 0);
+
+    TEST_PASS();
+}
+
+TEST(icon_render_data_does_not_wrap) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_IconRenderData arena[64];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+
+    /* More icons than the old 32-slot ring: each gets its own slot */
+    ClayKit_IconRenderData *first = NULL;
+    for (uint16_t i = 0; i < 64; i++) {
+        ClayKit_IconRenderData *d = (ClayKit_IconRenderData *)ClayKit_FrameAlloc(
+            &ctx, sizeof(ClayKit_IconRenderData), sizeof(uint32_t));
+        ASSERT_NOT_NULL(d);
+        d->icon_id = i;
+        if (i == 0) first = d;
+    }
+    ASSERT_EQ(first->icon_id, 0);
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 0);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Frame Arena Tests
+ * ============================================================================ */
+
+TEST(frame_arena_alloc_aligns) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    uint32_t arena[16];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+
+    ASSERT_EQ(ctx.frame_arena_cap, 64);
+    char *a = (char *)ClayKit_FrameAlloc(&ctx, 3, 1);
+    uint32_t *b = (uint32_t *)ClayKit_FrameAlloc(&ctx, 4, 4);
+    ASSERT_NOT_NULL(a);
+    ASSERT_NOT_NULL(b);
+    ASSERT_EQ((uintptr_t)b % 4, 0);
+    ASSERT_EQ(ctx.frame_arena_used, 8);
+
+    TEST_PASS();
+}
+
+TEST(frame_arena_overflow) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    uint32_t arena[4];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+
+    ASSERT_NOT_NULL(ClayKit_FrameAlloc(&ctx, 12, 1));
+    ASSERT_NULL(ClayKit_FrameAlloc(&ctx, 12, 1));
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 1);
+    ASSERT_EQ(ctx.frame_arena_used, 12);
+
+    TEST_PASS();
+}
+
+TEST(frame_arena_reset_by_begin_frame) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    uint32_t arena[4];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+
+    ClayKit_FrameAlloc(&ctx, 12, 1);
+    ClayKit_FrameAlloc(&ctx, 12, 1);
+    ClayKit_BeginFrame(&ctx);
+
+    ASSERT_EQ(ctx.frame_arena_used, 0);
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 0);
+    ASSERT_EQ(ctx.stats.frame_arena.peak, 12);
+    ASSERT_NOT_NULL(ClayKit_FrameAlloc(&ctx, 16, 1));
+    ASSERT_EQ(ctx.stats.frame_arena.peak, 16);
+
+    TEST_PASS();
+}
+
+TEST(frame_arena_unset) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    ASSERT_NULL(ClayKit_FrameAlloc(&ctx, 1, 1));
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 1);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Memory Planning Tests
+ * ============================================================================ */
+
+static int g_clay_errors = 0;
+
+static void test_clay_error_handler(Clay_ErrorData error) {
+    (void)error;
+    g_clay_errors++;
+}
+
+static Clay_Dimensions test_clay_measure_text(Clay_StringSlice text, Clay_TextElementConfig *config, void *user_data) {
+    (void)user_data;
+    Clay_Dimensions d;
+    d.width = (float)text.length * (float)config->fontSize * 0.5f;
+    d.height = (float)config->fontSize;
+    return d;
+}
+
+/* Makes a fresh Clay context with the given limits current */
+static void *test_clay_begin(int32_t max_elements, int32_t max_words, Clay_ErrorHandler handler) {
+    Clay_SetCurrentContext(NULL);
+    Clay_SetMaxElementCount(max_elements);
+    Clay_SetMaxMeasureTextCacheWordCount(max_words);
+    uint32_t size = Clay_MinMemorySize();
+    void *mem = malloc(size);
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(size, mem);
+    Clay_Initialize(arena, (Clay_Dimensions){ 800, 600 }, handler);
+    Clay_SetMeasureTextFunction(test_clay_measure_text, NULL);
+    return mem;
+}
+
+/* Frees a context from test_clay_begin and restores Clay's defaults */
+static void test_clay_end(void *mem) {
+    free(mem);
+    Clay_SetCurrentContext(NULL);
+    Clay_SetMaxElementCount(8192);
+    Clay_SetMaxMeasureTextCacheWordCount(16384);
+}
+
+/* Lays out one text element and returns the width of its text command */
+static float test_clay_text_width(Clay_String text, Clay_TextElementConfig config) {
+    Clay_BeginLayout();
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement((Clay_ElementDeclaration){0});
+    Clay__OpenTextElement(text, Clay__StoreTextElementConfig(config));
+    Clay__CloseElement();
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    float width = 0.0f;
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) width += cmd->boundingBox.width;
+    }
+    return width;
+}
+
+TEST(clay_measure_shares_callback) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    void *mem = test_clay_begin(16, 64, (Clay_ErrorHandler){0});
+    ClayKit_SetMeasureText(&ctx, test_byte_width, NULL);
+    ASSERT(ctx.measure_text == test_byte_width);
+
+    /* Clay now measures through the ClayKit callback */
+    ASSERT_EQ_FLOAT(test_clay_text_width(CLAY_STRING("abcdef"), (Clay_TextElementConfig){ .fontSize = 16 }),
+                    60.0f, 0.001f);
+    /* Letter spacing is added between codepoints (Clay drops the trailing one) */
+    ASSERT_EQ_FLOAT(test_clay_text_width(CLAY_STRING("ab\xC3\xA9"), (Clay_TextElementConfig){ .fontSize = 16, .letterSpacing = 2 }),
+                    44.0f, 0.001f);
+
+    /* And through registered metrics, without calling the callback */
+    float adv[95];
+    for (int i = 0; i < 95; i++) adv[i] = 7.0f;
+    ClayKit_FontMetrics m = {0};
+    m.font_id = 3;
+    m.font_size = 16;
+    m.first = 32;
+    m.count = 95;
+    m.advances = adv;
+    ClayKit_RegisterFontMetrics(&ctx, &m);
+    uint32_t calls = 0;
+    ClayKit_SetMeasureText(&ctx, test_kerned_width, &calls);
+    ASSERT_EQ_FLOAT(test_clay_text_width(CLAY_STRING("abcdef"), (Clay_TextElementConfig){ .fontId = 3, .fontSize = 16 }),
+                    42.0f, 0.001f);
+    ASSERT_EQ(calls, 0);
+
+    test_clay_end(mem);
+
+    TEST_PASS();
+}
+
+TEST(clay_measure_has_no_length_limit) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = test_byte_width;
+
+    /* The adapter hands the slice over as is: no copy, no truncation */
+    static char text[20000];
+    memset(text, 'x', sizeof(text));
+    Clay_StringSlice slice = { (int32_t)sizeof(text), text, text };
+    Clay_TextElementConfig config = { .fontSize = 16 };
+    Clay_Dimensions d = ClayKit_ClayMeasureText(slice, &config, &ctx);
+    ASSERT_EQ_FLOAT(d.width, 200000.0f, 0.5f);
+    ASSERT_EQ_FLOAT(d.height, 10.0f, 0.001f);
+
+    /* Nothing to measure with gives zero width at the font size */
+    ctx.measure_text = NULL;
+    d = ClayKit_ClayMeasureText(slice, &config, &ctx);
+    ASSERT_EQ_FLOAT(d.width, 0.0f, 0.001f);
+    ASSERT_EQ_FLOAT(d.height, 16.0f, 0.001f);
+
+    TEST_PASS();
+}
+
+typedef struct TestBatchCounts {
+    uint32_t calls;
+    uint32_t requests;
+    uint32_t largest;
+} TestBatchCounts;
+
+/* test_kerned_width for each request; user_data is a TestBatchCounts */
+static void test_kerned_batch(const ClayKit_MeasureRequest *requests, ClayKit_TextDimensions *out,
+                              uint32_t count, void *user_data) {
+    TestBatchCounts *counts = (TestBatchCounts *)user_data;
+    uint32_t unused = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = test_kerned_width(requests[i].text, requests[i].length, requests[i].font_id,
+                                   requests[i].font_size, &unused);
+    }
+    counts->calls++;
+    counts->requests += count;
+    if (count > counts->largest) counts->largest = count;
+}
+
+TEST(measure_batch_skips_registered_fonts) {
+    static const float advances[1] = { 5.0f };
+    ClayKit_FontMetrics metrics = { .font_id = 3, .font_size = 16, .first = 'a', .count = 1,
+                                    .advances = advances, .fallback = 5.0f };
+    TestBatchCounts counts = {0};
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetMeasureTextBatch(&ctx, test_kerned_batch, &counts);
+    ClayKit_RegisterFontMetrics(&ctx, &metrics);
+
+    ClayKit_MeasureRequest req[6] = {
+        { "AV", 2, 0, 16 }, { "ab", 2, 0, 16 },
+        { "xyz", 3, 3, 16 },   /* From the metrics */
+        { "ab", 0, 0, 16 },    /* Empty */
+        { "A", 1, 0, 16 }, { "b", 1, 0, 18 },
+    };
+    ClayKit_TextDimensions out[6];
+    ClayKit_MeasureTextBatch(&ctx, req, out, 6);
+
+    /* The two runs around the metrics and empty requests, one call each */
+    ASSERT_EQ(counts.calls, 2);
+    ASSERT_EQ(counts.requests, 4);
+    ASSERT_EQ_FLOAT(out[0].width, 15.0f, 0.001f);   /* 8 + 8 - 3 kerning + 2 spacing */
+    ASSERT_EQ_FLOAT(out[1].width, 20.0f, 0.001f);
+    ASSERT_EQ_FLOAT(out[2].width, 15.0f, 0.001f);
+    ASSERT_EQ_FLOAT(out[3].width, 0.0f, 0.001f);
+    ASSERT_EQ_FLOAT(out[3].height, 16.0f, 0.001f);
+    ASSERT_EQ_FLOAT(out[4].width, 8.0f, 0.001f);
+    ASSERT_EQ_FLOAT(out[5].width, 8.0f, 0.001f);
+
+    /* Without measure_text the batch callback measures single texts too */
+    ASSERT_EQ_FLOAT(ClayKit_MeasureTextWidth(&ctx, "AV", 2, 0, 16), out[0].width, 0.001f);
+    ASSERT_EQ(counts.calls, 3);
+
+    TEST_PASS();
+}
+
+TEST(measure_batch_hit_test_matches_single) {
+    static const char *pieces[] = { "A", "V", "w", " ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+    char buf[512];
+    char text[512];
+    float mem[512];
+    uint32_t calls = 0;
+    uint32_t seed = 11;
+    TestBatchCounts counts = {0};
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context single;
+    ClayKit_Context batched;
+    ClayKit_Init(&single, &theme, state_buf, 4);
+    ClayKit_Init(&batched, &theme, state_buf, 4);
+    single.measure_text = test_kerned_width;
+    single.measure_text_user_data = &calls;
+    ClayKit_SetMeasureTextBatch(&batched, test_kerned_batch, &counts);
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    for (int i = 0; i < 150; i++) {
+        seed = seed * 1103515245u + 12345u;
+        const char *piece = pieces[(seed >> 16) % 7];
+        ClayKit_InputInsertText(&s, piece, (uint32_t)strlen(piece));
+    }
+    memcpy(text, s.buf, s.len);
+
+    float total = ClayKit_MeasureTextWidth(&single, text, s.len, 0, 16);
+    calls = 0;
+    for (float x = -5.0f; x < total + 20.0f; x += 3.5f) {
+        ASSERT_EQ(ClayKit_InputGetCursorFromX(&batched, text, s.len, 0, 16, x),
+                  ClayKit_InputGetCursorFromX(&single, text, s.len, 0, 16, x));
+    }
+    /* Fewer round trips than a binary search over the same text */
+    ASSERT(counts.calls < calls);
+    ASSERT(counts.largest <= CLAYKIT_MEASURE_BATCH);
+
+    /* The advance cache fills in chunks and matches one built call by call */
+    ClayKit_InputAdvanceCache cache;
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 512);
+    uint32_t codepoints = 0;
+    counts.calls = 0;
+    for (uint32_t i = 0; i <= s.len; i++) {
+        if (i < s.len && ((uint8_t)text[i] & 0xC0) == 0x80) continue;
+        ASSERT_EQ_FLOAT(ClayKit_InputOffsetX(&batched, &s, 0, 16, i),
+                        ClayKit_MeasureTextWidth(&single, text, i, 0, 16), 0.01f);
+        codepoints++;
+    }
+    ASSERT(counts.calls <= codepoints / (CLAYKIT_MEASURE_BATCH / 2 - 1) + 1);
+    for (float x = 1.0f; x < total; x += 7.0f) {
+        ASSERT_EQ(ClayKit_InputHitTest(&batched, &s, 0, 16, x),
+                  ClayKit_InputGetCursorFromX(&single, text, s.len, 0, 16, x));
+    }
+
+    /* A fill that starts mid-text measures the codepoint before it too */
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 512);
+    ClayKit_InputOffsetX(&batched, &s, 0, 16, 1);
+    uint32_t mid = s.len / 2;
+    while (((uint8_t)text[mid] & 0xC0) == 0x80) mid--;
+    ASSERT_EQ_FLOAT(ClayKit_InputOffsetX(&batched, &s, 0, 16, mid),
+                    ClayKit_MeasureTextWidth(&single, text, mid, 0, 16), 0.01f);
+
+    TEST_PASS();
+}
+
+TEST(text_truncate_fits_and_cuts) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ctx.measure_text = test_byte_width;
+    Clay_TextElementConfig config = { .fontSize = 16 };
+
+    /* 10 px per byte, "..." is 30 px */
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "Hello", 5, config, 50.0f), 5);
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "Hello", 5, config, 49.0f), 1);
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "Hello", 5, config, 20.0f), 0);
+    /* Spaces before the ellipsis are dropped */
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "ab  cdefgh", 10, config, 70.0f), 2);
+
+    /* Letter spacing between codepoints and before the ellipsis */
+    config.letterSpacing = 2;
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "Hello", 5, config, 58.0f), 5);
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "Hello", 5, config, 57.0f), 1);
+    config.letterSpacing = 0;
+
+    /* Never cuts inside a codepoint: "a", euro sign, "bcdef" */
+    const char *utf8 = "a\xE2\x82\xAC" "bcdef";
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, utf8, 9, config, 70.0f), 4);
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, utf8, 9, config, 65.0f), 1);
+
+    /* A long text is only measured about as far as it is visible */
+    static char text[1 << 20];
+    memset(text, 'x', sizeof(text));
+    ClayKit_ResetStats(&ctx);
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, text, sizeof(text), config, 200.0f), 17);
+    ASSERT(ctx.stats.measure.bytes < 4096);
+
+    /* Nothing to measure with leaves the text whole */
+    ctx.measure_text = NULL;
+    ASSERT_EQ(ClayKit_TruncateText(&ctx, "Hello", 5, config, 20.0f), 5);
+
+    TEST_PASS();
+}
+
+TEST(text_truncated_uses_previous_width) {
+    static char text[100000];
+    static uint8_t frame_arena[256];
+    memset(text, 'x', sizeof(text));
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, frame_arena, sizeof(frame_arena));
+    void *mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    ClayKit_SetMeasureText(&ctx, test_byte_width, NULL);
+
+    /* The row narrows on the third frame; the text follows a frame later */
+    static const float row_widths[4] = { 200, 200, 100, 100 };
+    static const int32_t cut_lengths[4] = { 99 + 3, 17 + 3, 17 + 3, 7 + 3 };
+    for (int frame = 0; frame < 4; frame++) {
+        ClayKit_BeginFrame(&ctx);
+        Clay_BeginLayout();
+        Clay__OpenElement();
+        Clay_ElementDeclaration row = {0};
+        row.layout.sizing.width.type = CLAY__SIZING_TYPE_FIXED;
+        row.layout.sizing.width.size.minMax.min = row_widths[frame];
+        row.layout.sizing.width.size.minMax.max = row_widths[frame];
+        row.layout.layoutDirection = CLAY_TOP_TO_BOTTOM;
+        Clay__ConfigureOpenElement(row);
+        bool cut = ClayKit_TextTruncated(&ctx, "Long", 4, text, (int32_t)sizeof(text),
+                                         (Clay_TextElementConfig){ .fontSize = 16 });
+        bool short_cut = ClayKit_TextTruncated(&ctx, "Short", 5, "Hi", 2,
+                                               (Clay_TextElementConfig){ .fontSize = 16 });
+        Clay__CloseElement();
+        Clay_RenderCommandArray cmds = Clay_EndLayout();
+        ClayKit_EndFrame(&ctx);
+        ASSERT(cut);
+        ASSERT(!short_cut);
+
+        Clay_RenderCommand *texts[2];
+        int n = 0;
+        for (int32_t i = 0; i < cmds.length; i++) {
+            Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+            if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT && n < 2) texts[n++] = cmd;
+        }
+        ASSERT_EQ(n, 2);
+
+        /* The first frame assumes CLAYKIT_TRUNCATE_INITIAL_WIDTH, later ones
+         * cut to the width the wrapper got in the frame before */
+        Clay_StringSlice s = texts[0]->renderData.text.stringContents;
+        ASSERT_EQ(s.length, cut_lengths[frame]);
+        ASSERT(memcmp(s.chars + s.length - 3, "...", 3) == 0);
+        ASSERT(ctx.stats.measure_frame.bytes < 4096);
+        if (frame % 2 == 1) {
+            ASSERT_EQ_FLOAT(texts[0]->boundingBox.width, row_widths[frame], 0.001f);
+        }
+        /* Text that fits is emitted as is, without a copy */
+        ASSERT(texts[1]->renderData.text.stringContents.chars[0] == 'H');
+        ASSERT_EQ(texts[1]->renderData.text.stringContents.length, 2);
+    }
+    ASSERT_EQ(ctx.stats.frame_arena.overflows, 0);
+
+    test_clay_end(mem);
+
+    TEST_PASS();
+}
+
+TEST(memory_requirements_counts) {
+    ClayKit_MemoryCounts counts = {0};
+    counts.buttons = 10;
+    counts.icons = 4;
+    counts.stateful_elements = 30;
+
+    ClayKit_MemoryRequirements req = ClayKit_ComputeMemoryRequirements(&counts);
+    ASSERT_EQ(req.elements, 24);
+    ASSERT_EQ(req.text_elements, 10);
+    ASSERT_EQ(req.clay_max_elements, 26);
+    ASSERT_EQ(req.clay_measure_words, 32);
+    ASSERT_EQ(req.state_slots, 40);
+    ASSERT_EQ(req.state_bytes, 40 * sizeof(ClayKit_State));
+    ASSERT_EQ(req.frame_arena_bytes, 4 * sizeof(ClayKit_IconRenderData) + 3);
+    ASSERT_EQ(req.state_pool_bytes, 0);
+    ASSERT(req.clay_bytes > 0);
+    ASSERT_EQ(req.total_bytes, req.clay_bytes + req.state_bytes + req.frame_arena_bytes);
+
+    TEST_PASS();
+}
+
+TEST(memory_requirements_keeps_clay_context) {
+    void *mem = test_clay_begin(16, 64, (Clay_ErrorHandler){0});
+    Clay_Context *current = Clay_GetCurrentContext();
+    uint32_t current_bytes = Clay_MinMemorySize();
+
+    ClayKit_MemoryCounts counts = {0};
+    counts.containers = 100;
+    counts.texts = 100;
+    ClayKit_MemoryRequirements req = ClayKit_ComputeMemoryRequirements(&counts);
+
+    /* Sized for the counts, not the current context, which is untouched */
+    ASSERT(req.clay_bytes > current_bytes);
+    ASSERT(Clay_GetCurrentContext() == current);
+    ASSERT_EQ(current->maxElementCount, 16);
+    ASSERT_EQ(Clay_MinMemorySize(), current_bytes);
+
+    test_clay_end(mem);
+    TEST_PASS();
+}
+
+TEST(memory_requirements_state_pool) {
+    ClayKit_MemoryCounts counts = {0};
+    counts.state_blobs = 40;
+    counts.state_blob_size = 24;
+
+    ClayKit_MemoryRequirements req = ClayKit_ComputeMemoryRequirements(&counts);
+    /* 32-byte class: 32 blobs per page, so 2 pages */
+    ASSERT_EQ(req.state_pool_bytes, 2 * (CLAYKIT_POOL_PAGE_SIZE + 2) + 15);
+    ASSERT(req.state_slots >= 40);
+
+    TEST_PASS();
+}
+
+TEST(memory_requirements_match_clay_layout) {
+    ClayKit_MemoryCounts counts = {0};
+    counts.containers = 1;
+    counts.texts = 1;
+    counts.truncated_texts = 1;
+    counts.badges = 1;
+    counts.tags = 1;
+    counts.stats = 1;
+    counts.lists = 1;
+    counts.list_items = 12;
+    counts.ordered_list_items = 12;
+    counts.tables = 1;
+    counts.table_rows = 2;
+    counts.table_cells = 4;
+    counts.buttons = 2;
+    counts.icons = 3;
+    counts.checkboxes = 1;
+    counts.radios = 1;
+    counts.switches = 1;
+    counts.sliders = 1;
+    counts.progress_bars = 1;
+    counts.spinners = 1;
+    counts.alerts = 1;
+    counts.tooltips = 1;
+    counts.tabs = 1;
+    counts.links = 1;
+    counts.breadcrumbs = 1;
+    counts.breadcrumb_items = 2;
+    counts.accordions = 1;
+    counts.accordion_items = 1;
+    counts.menus = 1;
+    counts.menu_items = 2;
+    counts.selects = 1;
+    counts.select_options = 2;
+    counts.text_inputs = 1;
+    counts.text_areas = 1;
+    counts.text_area_rows = 3;
+    counts.drawers = 1;
+    counts.popovers = 1;
+
+    ClayKit_MemoryRequirements req = ClayKit_ComputeMemoryRequirements(&counts);
+
+    /* Planning must not disturb Clay's defaults */
+    ASSERT_NULL(Clay_GetCurrentContext());
+    ASSERT_EQ(Clay__defaultMaxElementCount, 8192);
+
+    Clay_SetMaxElementCount((int32_t)req.clay_max_elements);
+    Clay_SetMaxMeasureTextCacheWordCount((int32_t)req.clay_measure_words);
+    ASSERT_EQ(Clay_MinMemorySize(), req.clay_bytes);
+
+    static uint8_t clay_memory[1 << 20];
+    ASSERT(req.clay_bytes <= sizeof(clay_memory));
+    g_clay_errors = 0;
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(req.clay_bytes, clay_memory);
+    Clay_Context *clay = Clay_Initialize(arena, (Clay_Dimensions){ 1024, 768 },
+                                         (Clay_ErrorHandler){ test_clay_error_handler, NULL });
+    Clay_SetMeasureTextFunction(test_clay_measure_text, NULL);
+
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    static uint8_t frame_arena[512];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, frame_arena, req.frame_arena_bytes);
+
+    char input_buf[16] = "hello";
+    ClayKit_InputState input = { .buf = input_buf, .cap = 16, .len = 5, .cursor = 3, .select_start = 1, .flags = CLAYKIT_INPUT_FOCUSED };
+    char area_buf[16] = "ab\ncd\nef";
+    uint32_t area_starts[4];
+    ClayKit_InputLineIndex area_lines;
+    /* A selection from inside the first row to inside the last */
+    ClayKit_InputState area = { .buf = area_buf, .cap = 16, .len = 8, .cursor = 7, .select_start = 1, .flags = CLAYKIT_INPUT_FOCUSED };
+    ClayKit_InputSetLineIndex(&area, &area_lines, area_starts, 4);
+
+    /* Build every component in its largest variant */
+    ClayKit_BeginFrame(&ctx);
+    Clay_BeginLayout();
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement((Clay_ElementDeclaration){ .backgroundColor = { 1, 2, 3, 255 },
+                                                        .border = { .color = { 1, 2, 3, 255 }, .width = { 1, 1, 1, 1, 0 } } });
+    Clay__OpenTextElement(CLAY_STRING("Title"), Clay__StoreTextElementConfig((Clay_TextElementConfig){ .fontSize = 16 }));
+    ClayKit_TextTruncated(&ctx, "Trunc", 5, "Subtitle", 8, (Clay_TextElementConfig){ .fontSize = 16 });
+    ClayKit_BadgeRaw(&ctx, "New", 3, (ClayKit_BadgeConfig){0});
+    ClayKit_TagRaw(&ctx, "Tag", 3, (ClayKit_TagConfig){0});
+    ClayKit_Stat(&ctx, "Users", 5, "42", 2, "Up", 2, (ClayKit_StatConfig){0});
+    ClayKit_ListBegin(&ctx, (ClayKit_ListConfig){ .ordered = true });
+    for (uint32_t i = 0; i < 12; i++) {
+        ClayKit_ListItemRaw(&ctx, "Item", 4, i, (ClayKit_ListConfig){ .ordered = true });
+    }
+    ClayKit_ListEnd();
+    ClayKit_TableBegin(&ctx, (ClayKit_TableConfig){0});
+    ClayKit_TableHeaderRow(&ctx, (ClayKit_TableConfig){0});
+    ClayKit_TableHeaderCell(&ctx, 0.5f, (ClayKit_TableConfig){0}); ClayKit_TableCellEnd();
+    ClayKit_TableHeaderCell(&ctx, 0.5f, (ClayKit_TableConfig){0}); ClayKit_TableCellEnd();
+    ClayKit_TableRowEnd();
+    ClayKit_TableRow(&ctx, 0, (ClayKit_TableConfig){ .bordered = true });
+    ClayKit_TableCell(&ctx, 0.5f, 0, (ClayKit_TableConfig){0}); ClayKit_TableCellEnd();
+    ClayKit_TableCell(&ctx, 0.5f, 0, (ClayKit_TableConfig){0}); ClayKit_TableCellEnd();
+    ClayKit_TableRowEnd();
+    ClayKit_TableEnd();
+    ClayKit_Button(&ctx, "Save", 4, (ClayKit_ButtonConfig){ .icon_left = { 1, 0 }, .icon_right = { 2, 0 } });
+    ClayKit_Button(&ctx, "Open", 4, (ClayKit_ButtonConfig){0});
+    ClayKit_Checkbox(&ctx, true, (ClayKit_CheckboxConfig){0});
+    ClayKit_Radio(&ctx, true, (ClayKit_RadioConfig){0});
+    ClayKit_Switch(&ctx, true, (ClayKit_SwitchConfig){0});
+    ClayKit_Slider(&ctx, 0.5f, (ClayKit_SliderConfig){0});
+    ClayKit_Progress(&ctx, 0.5f, (ClayKit_ProgressConfig){0});
+    ClayKit_Spinner(&ctx, (ClayKit_SpinnerConfig){0});
+    ClayKit_AlertText(&ctx, "Saved", 5, (ClayKit_AlertConfig){ .icon = { 3, 0 } });
+    ClayKit_Tooltip(&ctx, "Tip", 3, (ClayKit_TooltipConfig){0});
+    ClayKit_Tab(&ctx, "Tab", 3, true, (ClayKit_TabsConfig){0});
+    ClayKit_Link(&ctx, "Link", 4, (ClayKit_LinkConfig){0});
+    ClayKit_BreadcrumbBegin(&ctx, (ClayKit_BreadcrumbConfig){0});
+    ClayKit_BreadcrumbItem(&ctx, "Home", 4, false, (ClayKit_BreadcrumbConfig){0});
+    ClayKit_BreadcrumbSeparator(&ctx, (ClayKit_BreadcrumbConfig){0});
+    ClayKit_BreadcrumbItem(&ctx, "Docs", 4, true, (ClayKit_BreadcrumbConfig){0});
+    ClayKit_BreadcrumbSeparator(&ctx, (ClayKit_BreadcrumbConfig){0});
+    ClayKit_BreadcrumbEnd();
+    ClayKit_AccordionBegin(&ctx, (ClayKit_AccordionConfig){0});
+    ClayKit_AccordionItemBegin(&ctx, true, (ClayKit_AccordionConfig){0});
+    ClayKit_AccordionHeader(&ctx, "More", 4, true, (ClayKit_AccordionConfig){0});
+    ClayKit_AccordionContentBegin(&ctx, (ClayKit_AccordionConfig){0});
+    ClayKit_AccordionContentEnd();
+    ClayKit_AccordionItemEnd();
+    ClayKit_AccordionEnd();
+    ClayKit_SelectTrigger(&ctx, "Sel", 3, "One", 3, (ClayKit_SelectConfig){0});
+    ClayKit_SelectDropdownBegin(&ctx, "SelDrop", 7, (ClayKit_SelectConfig){0});
+    ClayKit_SelectOption(&ctx, "One", 3, true, (ClayKit_SelectConfig){0});
+    ClayKit_SelectOption(&ctx, "Two", 3, false, (ClayKit_SelectConfig){0});
+    ClayKit_SelectDropdownEnd();
+    ClayKit_MenuDropdownBegin(&ctx, "Menu", 4, (ClayKit_MenuConfig){0});
+    ClayKit_MenuItem(&ctx, "Cut", 3, false, (ClayKit_MenuConfig){0});
+    ClayKit_MenuItem(&ctx, "Copy", 4, false, (ClayKit_MenuConfig){0});
+    ClayKit_MenuDropdownEnd();
+    ClayKit_TextInput(&ctx, "Name", 4, &input, (ClayKit_InputConfig){0}, NULL, 0);
+    ClayKit_TextArea(&ctx, "Notes", 5, &area, (ClayKit_InputConfig){ .rows = 3 }, NULL, 0);
+    ClayKit_DrawerBegin(&ctx, "Drawer", 6, (ClayKit_DrawerConfig){0});
+    ClayKit_DrawerEnd();
+    ClayKit_PopoverBegin(&ctx, "Pop", 3, (ClayKit_PopoverConfig){0});
+    ClayKit_PopoverEnd();
+    Clay__CloseElement();
+
+    /* Exact per-component counts (the root element is Clay's own) */
+    ASSERT_EQ((uint32_t)clay->layoutElements.length - 1, req.elements);
+    ASSERT_EQ((uint32_t)clay->elementConfigs.length, req.element_configs);
+    ASSERT_EQ((uint32_t)clay->textElementData.length, req.text_elements);
+
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    ASSERT((uint32_t)cmds.length <= req.element_configs);
+    ASSERT((uint32_t)clay->measuredWords.length < req.clay_measure_words);
+    ASSERT_EQ(g_clay_errors, 0);
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 0);
+
+    /* Restore Clay's defaults for other tests */
+    Clay_SetCurrentContext(NULL);
+    Clay_SetMaxElementCount(8192);
+    Clay_SetMaxMeasureTextCacheWordCount(16384);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Stats Tests
+ * ============================================================================ */
+
+TEST(stats_state_slots) {
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    ASSERT_EQ(ctx.stats.state_slots.capacity, 4);
+    for (uint32_t id = 1; id <= 4; id++) {
+        ASSERT_NOT_NULL(ClayKit_GetOrCreateState(&ctx, id));
+    }
+    ASSERT_NULL(ClayKit_GetOrCreateState(&ctx, 5));
+    ASSERT_NULL(ClayKit_GetOrCreateState(&ctx, 6));
+    ASSERT_EQ(ctx.stats.state_slots.used, 4);
+    ASSERT_EQ(ctx.stats.state_slots.frame_peak, 4);
+    ASSERT_EQ(ctx.stats.state_slots.peak, 4);
+    ASSERT_EQ(ctx.stats.state_slots.frame_overflows, 2);
+    ASSERT_EQ(ctx.stats.state_slots.overflows, 2);
+
+    /* New frame: per-frame counters reset, all-time counters kept */
+    ClayKit_BeginFrame(&ctx);
+    ASSERT_EQ(ctx.stats.state_slots.frame_overflows, 0);
+    ASSERT_EQ(ctx.stats.state_slots.overflows, 2);
+    ASSERT_EQ(ctx.stats.state_slots.frame_peak, 4);
+
+    /* Eviction lowers usage but not the peak */
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_EvictStaleStates(&ctx, 0);
+    ASSERT_EQ(ctx.stats.state_slots.used, 0);
+    ASSERT_EQ(ctx.stats.state_slots.peak, 4);
+
+    TEST_PASS();
+}
+
+TEST(stats_state_pool_pages) {
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    static uint8_t pool_mem[CLAYKIT_POOL_PAGE_SIZE + 2 + 15];
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ClayKit_SetStatePool(&ctx, pool_mem, sizeof(pool_mem));
+
+    ASSERT_EQ(ctx.stats.state_pool_pages.capacity, 1);
+    ASSERT_NOT_NULL(ClayKit_GetStateBlob(&ctx, 1, 16));
+    ASSERT_EQ(ctx.stats.state_pool_pages.used, 1);
+
+    /* The only page belongs to the 16-byte class */
+    ASSERT_NULL(ClayKit_GetStateBlob(&ctx, 2, 64));
+    ASSERT_EQ(ctx.stats.state_pool_pages.overflows, 1);
+    ASSERT_EQ(ctx.stats.state_pool_pages.peak, 1);
+
+    TEST_PASS();
+}
+
+TEST(stats_frame_arena_icons_and_numbers) {
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    static uint8_t arena[2 * sizeof(ClayKit_IconRenderData) + 12];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+    void *clay_mem = test_clay_begin(256, 1024, (Clay_ErrorHandler){0});
+
+    ClayKit_BeginFrame(&ctx);
+    Clay_BeginLayout();
+    ClayKit_ListConfig list_cfg = {0};
+    list_cfg.ordered = true;
+    ClayKit_ListItemRaw(&ctx, "A", 1, 0, list_cfg);
+    ClayKit_Button(&ctx, "Go", 2, (ClayKit_ButtonConfig){ .icon_left = { 1, 0 }, .icon_right = { 2, 0 } });
+    ClayKit_Button(&ctx, "Go", 2, (ClayKit_ButtonConfig){ .icon_left = { 3, 0 } });
+    ClayKit_ListItemRaw(&ctx, "B", 1, 1, list_cfg);
+    Clay_EndLayout();
+    test_clay_end(clay_mem);
+
+    ASSERT_EQ(ctx.stats.frame_arena.capacity, sizeof(arena));
+    ASSERT_EQ(ctx.stats.icons.used, 2);
+    ASSERT_EQ(ctx.stats.icons.frame_overflows, 1);
+    ASSERT_EQ(ctx.stats.list_numbers.used, 1);
+    ASSERT_EQ(ctx.stats.list_numbers.frame_overflows, 1);
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 2);
+
+    ClayKit_BeginFrame(&ctx);
+    ASSERT_EQ(ctx.stats.icons.used, 0);
+    ASSERT_EQ(ctx.stats.icons.frame_peak, 0);
+    ASSERT_EQ(ctx.stats.icons.peak, 2);
+    ASSERT_EQ(ctx.stats.list_numbers.peak, 1);
+    ASSERT_EQ(ctx.stats.frame_arena.used, 0);
+    ASSERT_EQ(ctx.stats.frame_arena.overflows, 2);
+
+    TEST_PASS();
+}
+
+/* Lays out a button with a left icon. Returns its custom command, or NULL
+ * if there is none, and the button's width. */
+static Clay_RenderCommand *test_icon_button(ClayKit_Context *ctx, float *width) {
+    ClayKit_BeginFrame(ctx);
+    Clay_BeginLayout();
+    ClayKit_Button(ctx, "Go", 2, (ClayKit_ButtonConfig){ .icon_left = { 7, 18 } });
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    Clay_RenderCommand *icon = NULL;
+    *width = 0.0f;
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE && *width == 0.0f) {
+            *width = cmd->boundingBox.width;
+        }
+        if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_CUSTOM) icon = cmd;
+    }
+    return icon;
+}
+
+TEST(icon_emit_with_and_without_arena) {
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    uint32_t arena[16];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    ClayKit_SetMeasureText(&ctx, test_byte_width, NULL);
+
+    /* With an arena the icon carries its render data */
+    ClayKit_SetFrameArena(&ctx, arena, sizeof(arena));
+    float width = 0.0f;
+    Clay_RenderCommand *cmd = test_icon_button(&ctx, &width);
+    ASSERT_NOT_NULL(cmd);
+    ClayKit_IconRenderData *data = (ClayKit_IconRenderData *)cmd->renderData.custom.customData;
+    ASSERT_EQ(data->type, CLAYKIT_CUSTOM_ICON);
+    ASSERT_EQ(data->icon_id, 7);
+    ASSERT_EQ_FLOAT(cmd->boundingBox.width, 18.0f, 0.001f);
+    ASSERT_EQ(ctx.stats.icons.used, 1);
+    ASSERT(width > 0.0f);
+
+    /* Without one it keeps its space but draws nothing */
+    ClayKit_SetFrameArena(&ctx, NULL, 0);
+    float bare_width = 0.0f;
+    ASSERT_NULL(test_icon_button(&ctx, &bare_width));
+    ASSERT_EQ_FLOAT(bare_width, width, 0.001f);
+    ASSERT_EQ(ctx.stats.icons.frame_overflows, 1);
+    ASSERT_EQ(ctx.stats.frame_arena.frame_overflows, 1);
+
+    test_clay_end(clay_mem);
+    TEST_PASS();
+}
+
+static void test_count_clay_errors(Clay_ErrorData error) {
+    (*(int *)error.userData)++;
+}
+
+TEST(stats_clay_elements_and_words) {
+    int user_errors = 0;
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    void *mem = test_clay_begin(16, 64,
+        ClayKit_ClayErrorHandler(&ctx, (Clay_ErrorHandler){ test_count_clay_errors, &user_errors }));
+
+    /* Fits: root, a container and two words of text */
+    ClayKit_BeginFrame(&ctx);
+    Clay_BeginLayout();
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement((Clay_ElementDeclaration){0});
+    Clay__OpenTextElement(CLAY_STRING("two words"), Clay__StoreTextElementConfig((Clay_TextElementConfig){ .fontSize = 16 }));
+    Clay__CloseElement();
+    Clay_EndLayout();
+    ClayKit_EndFrame(&ctx);
+
+    ASSERT_EQ(ctx.stats.clay_elements.capacity, 16);
+    ASSERT_EQ(ctx.stats.clay_measure_words.capacity, 64);
+    ASSERT_EQ(ctx.stats.clay_elements.used, 3);
+    ASSERT(ctx.stats.clay_measure_words.used >= 2);
+    ASSERT_EQ(ctx.stats.clay_elements.overflows, 0);
+    ASSERT_EQ(user_errors, 0);
+
+    /* Too many elements: Clay only flags it, EndFrame counts it */
+    ClayKit_BeginFrame(&ctx);
+    Clay_BeginLayout();
+    for (int i = 0; i < 20; i++) {
+        Clay__OpenElement();
+        Clay__ConfigureOpenElement((Clay_ElementDeclaration){0});
+        Clay__CloseElement();
+    }
+    Clay_EndLayout();
+    ClayKit_EndFrame(&ctx);
+
+    ASSERT_EQ(ctx.stats.clay_elements.frame_overflows, 1);
+    ASSERT_EQ(ctx.stats.clay_elements.peak, 15);
+
+    /* Too many words: counted, and still forwarded to the user handler */
+    ClayKit_BeginFrame(&ctx);
+    Clay_BeginLayout();
+    Clay__OpenTextElement(CLAY_STRING("a b c d e f g h i j k l m n o p q r s t u v w x y z "
+                                      "A B C D E F G H I J K L M N O P Q R S T U V W X Y Z "
+                                      "0 1 2 3 4 5 6 7 8 9"),
+                          Clay__StoreTextElementConfig((Clay_TextElementConfig){ .fontSize = 16 }));
+    Clay_EndLayout();
+    ClayKit_EndFrame(&ctx);
+
+    ASSERT_EQ(ctx.stats.clay_elements.frame_overflows, 0);
+    ASSERT_EQ(ctx.stats.clay_elements.overflows, 1);
+    ASSERT_EQ(ctx.stats.clay_measure_words.frame_overflows, 1);
+    ASSERT_EQ(user_errors, 1);
+
+    test_clay_end(mem);
+
+    TEST_PASS();
+}
+
+static double g_test_clock;
+
+/* Advances half a second per read, so each timed call takes 0.5s */
+static double test_step_clock(void) {
+    g_test_clock += 0.5;
+    return g_test_clock;
+}
+
+/* One frame with two text elements: three words between them */
+/* Lays out two texts, wrapped to width if it is not 0 */
+static void test_measure_frame(ClayKit_Context *ctx, float width) {
+    Clay_ElementDeclaration root = {0};
+    if (width > 0) {
+        root.layout.sizing.width.type = CLAY__SIZING_TYPE_FIXED;
+        root.layout.sizing.width.size.minMax.min = width;
+        root.layout.sizing.width.size.minMax.max = width;
+        root.layout.layoutDirection = CLAY_TOP_TO_BOTTOM;
+    }
+    ClayKit_BeginFrame(ctx);
+    Clay_BeginLayout();
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(root);
+    Clay__OpenTextElement(CLAY_STRING("two words"), Clay__StoreTextElementConfig((Clay_TextElementConfig){ .fontSize = 16 }));
+    Clay__OpenTextElement(CLAY_STRING("three"), Clay__StoreTextElementConfig((Clay_TextElementConfig){ .fontSize = 16 }));
+    Clay__CloseElement();
+    Clay_EndLayout();
+    ClayKit_EndFrame(ctx);
+}
+
+TEST(stats_measure_calls_and_clay_hits) {
+    static const float advances[1] = { 4.0f };
+    ClayKit_FontMetrics metrics = { .font_id = 2, .font_size = 16, .first = 'a', .count = 1,
+                                    .advances = advances, .fallback = 4.0f };
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    void *mem = test_clay_begin(16, 64, (Clay_ErrorHandler){0});
+    ClayKit_SetMeasureText(&ctx, test_byte_width, NULL);
+    ClayKit_SetMeasureClock(&ctx, test_step_clock);
+
+    /* Two misses: a space-width probe and the words of each text */
+    test_measure_frame(&ctx, 0);
+    ASSERT_EQ(ctx.stats.measure_frame.clay_lookups, 2);
+    ASSERT_EQ(ctx.stats.measure_frame.clay_misses, 2);
+    ASSERT_EQ(ctx.stats.measure_frame.calls, 5);
+    ASSERT_EQ(ctx.stats.measure_frame.texts, 5);
+    ASSERT_EQ(ctx.stats.measure_frame.bytes, 1 + 3 + 5 + 1 + 5);
+    ASSERT_EQ_FLOAT(ctx.stats.measure_frame.seconds, 2.5, 0.001);
+
+    /* The same texts next frame are cache hits and measure nothing */
+    test_measure_frame(&ctx, 0);
+    ASSERT_EQ(ctx.stats.measure_frame.clay_lookups, 2);
+    ASSERT_EQ(ctx.stats.measure_frame.clay_misses, 0);
+    ASSERT_EQ(ctx.stats.measure_frame.calls, 0);
+    ASSERT_EQ(ctx.stats.measure.clay_lookups, 4);
+    ASSERT_EQ(ctx.stats.measure.clay_misses, 2);
+    ASSERT_EQ(ctx.stats.measure.calls, 5);
+
+    /* Wrapping makes Clay measure a space again in its final layout, every
+     * frame; that is not a miss */
+    for (int i = 0; i < 2; i++) {
+        test_measure_frame(&ctx, 40.0f);
+        ASSERT_EQ(ctx.stats.measure_frame.clay_lookups, 2);
+        ASSERT_EQ(ctx.stats.measure_frame.clay_misses, 0);
+    }
+
+    /* Font metrics measure texts without calls; batches are one call */
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_RegisterFontMetrics(&ctx, &metrics);
+    ClayKit_MeasureTextWidth(&ctx, "aaaa", 4, 2, 16);
+    ClayKit_MeasureRequest req[3] = { { "ab", 2, 0, 16 }, { "cde", 3, 0, 16 }, { "f", 1, 0, 16 } };
+    ClayKit_TextDimensions out[3];
+    TestBatchCounts counts = {0};
+    ClayKit_SetMeasureTextBatch(&ctx, test_kerned_batch, &counts);
+    ClayKit_MeasureTextBatch(&ctx, req, out, 3);
+    ASSERT_EQ(ctx.stats.measure_frame.calls, 1);
+    ASSERT_EQ(ctx.stats.measure_frame.texts, 4);
+    ASSERT_EQ(ctx.stats.measure_frame.bytes, 10);
+
+    ClayKit_ResetStats(&ctx);
+    ASSERT_EQ(ctx.stats.measure.calls, 0);
+    ASSERT_EQ_FLOAT(ctx.stats.measure.seconds, 0.0, 0.001);
+
+    test_clay_end(mem);
+    TEST_PASS();
+}
+
+TEST(stats_recommend_and_resize_measure_cache) {
+    int user_errors = 0;
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    void *mem = test_clay_begin(16, 64,
+        ClayKit_ClayErrorHandler(&ctx, (Clay_ErrorHandler){ test_count_clay_errors, &user_errors }));
+    /* Clay measures through ClayKit, which needs its user data to survive */
+    ClayKit_SetMeasureText(&ctx, test_byte_width, NULL);
+    ASSERT_EQ(ClayKit_RecommendClayMeasureWords(&ctx), 0);
+
+    Clay_String many = CLAY_STRING("a b c d e f g h i j k l m n o p q r s t u v w x y z "
+                                   "A B C D E F G H I J K L M N O P Q R S T U V W X Y Z "
+                                   "0 1 2 3 4 5 6 7 8 9");
+    Clay_String some = CLAY_STRING("a b c d e f g h i j k l m n o p q r s t");
+    Clay_TextElementConfig config = { .fontSize = 16 };
+
+    /* 20 words fit in 64: the peak plus half again, rounded up */
+    ClayKit_BeginFrame(&ctx);
+    test_clay_text_width(some, config);
+    ClayKit_EndFrame(&ctx);
+    uint32_t peak = ctx.stats.clay_measure_words.peak;
+    ASSERT(peak >= 20 && peak < 64);
+    ASSERT_EQ(ClayKit_RecommendClayMeasureWords(&ctx), (peak + peak / 2 + 31) / 32 * 32);
+
+    /* 62 words overflow it: the peak stops at capacity, so double it */
+    ClayKit_BeginFrame(&ctx);
+    test_clay_text_width(many, config);
+    ClayKit_EndFrame(&ctx);
+    ASSERT_EQ(ctx.stats.clay_measure_words.frame_overflows, 1);
+    uint32_t words = ClayKit_RecommendClayMeasureWords(&ctx);
+    ASSERT_EQ(words, 128);
+
+    /* Query the size, then move Clay into a larger arena */
+    uint32_t bytes = ClayKit_ResizeClayMeasureCache(&ctx, words, NULL, 0);
+    ASSERT(bytes > 0);
+    ASSERT_EQ(Clay_GetMaxMeasureTextCacheWordCount(), 64);
+    void *bigger = malloc(bytes);
+
+    /* Too little memory changes nothing and returns 0 */
+    Clay_Context *before = Clay_GetCurrentContext();
+    ASSERT_EQ(ClayKit_ResizeClayMeasureCache(&ctx, words, bigger, bytes - 1), 0);
+    ASSERT(Clay_GetCurrentContext() == before);
+    ASSERT_EQ(Clay_GetMaxMeasureTextCacheWordCount(), 64);
+
+    ASSERT_EQ(ClayKit_ResizeClayMeasureCache(&ctx, words, bigger, bytes), bytes);
+    free(mem);
+    ASSERT_EQ(Clay_GetMaxMeasureTextCacheWordCount(), 128);
+    ASSERT_EQ(Clay_GetMaxElementCount(), 16);
+    ASSERT_EQ_FLOAT(Clay_GetCurrentContext()->layoutDimensions.width, 800.0f, 0.001f);
+    ASSERT(Clay_GetCurrentContext()->errorHandler.userData == &ctx);
+    ASSERT(Clay_GetCurrentContext()->measureTextUserData == &ctx);
+
+    /* The same text now fits, and the error handler is still ClayKit's */
+    ClayKit_BeginFrame(&ctx);
+    test_clay_text_width(many, config);
+    ClayKit_EndFrame(&ctx);
+    ASSERT_EQ(ctx.stats.clay_measure_words.frame_overflows, 0);
+    ASSERT_EQ(ctx.stats.clay_measure_words.capacity, 128);
+    ASSERT(ctx.stats.clay_measure_words.used >= 62);
+    ASSERT_EQ(user_errors, 1);
+
+    test_clay_end(bigger);
+    TEST_PASS();
+}
+
+TEST(stats_reset) {
+    ClayKit_Context ctx;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[2];
+    ClayKit_Init(&ctx, &theme, state_buf, 2);
+
+    ClayKit_GetOrCreateState(&ctx, 1);
+    ClayKit_GetOrCreateState(&ctx, 2);
+    ClayKit_GetOrCreateState(&ctx, 3);
+    ClayKit_BeginFrame(&ctx);
+    ClayKit_EvictStaleStates(&ctx, 0);
+    ClayKit_GetOrCreateState(&ctx, 4);
+
+    ClayKit_ResetStats(&ctx);
+    ASSERT_EQ(ctx.stats.state_slots.used, 1);
+    ASSERT_EQ(ctx.stats.state_slots.peak, 1);
+    ASSERT_EQ(ctx.stats.state_slots.overflows, 0);
+    ASSERT_EQ(ctx.stats.state_slots.capacity, 2);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Snapshot Tests
+ * ============================================================================ */
+
+TEST(snapshot_round_trip) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State src_buf[16];
+    ClayKit_State dst_buf[32];
+    static uint8_t src_pool[2 * (CLAYKIT_POOL_PAGE_SIZE + 2) + 15];
+    static uint8_t dst_pool[2 * (CLAYKIT_POOL_PAGE_SIZE + 2) + 15];
+    ClayKit_Context src, dst;
+    ClayKit_Init(&src, &theme, src_buf, 16);
+    ClayKit_Init(&dst, &theme, dst_buf, 32);
+    ClayKit_SetStatePool(&src, src_pool, sizeof(src_pool));
+    ClayKit_SetStatePool(&dst, dst_pool, sizeof(dst_pool));
+
+    src.frame = 41;
+    ClayKit_GetOrCreateState(&src, 100)->value = 0.25f;
+    ClayKit_GetOrCreateState(&src, 200)->flags = 7;
+    TestScrollState *scroll = CLAYKIT_STATE_BLOB(&src, 300, TestScrollState);
+    scroll->offset_x = 12.5f;
+    scroll->velocity = -3.0f;
+    src.frame = 42;
+    src.focused_id = 200;
+    src.prev_focused_id = 100;
+
+    char a_buf[32] = "hello";
+    char b_buf[8] = "";
+    ClayKit_InputState a = { .buf = a_buf, .cap = 32, .len = 5, .cursor = 3, .select_start = 1, .flags = CLAYKIT_INPUT_FOCUSED };
+    ClayKit_InputState b = { .buf = b_buf, .cap = 8, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputState *src_inputs[] = { &a, &b };
+
+    uint32_t size = ClayKit_SaveSnapshot(&src, src_inputs, 2, NULL, 0);
+    ASSERT(size > 0);
+    static uint8_t snap[1024];
+    ASSERT(size <= sizeof(snap));
+    ASSERT_EQ(ClayKit_SaveSnapshot(&src, src_inputs, 2, snap, sizeof(snap)), size);
+
+    char a2_buf[16];
+    char b2_buf[8] = "junk";
+    ClayKit_InputState a2 = { .buf = a2_buf, .cap = 16, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputState b2 = { .buf = b2_buf, .cap = 8, .len = 4, .cursor = 4, .select_start = 4, .flags = CLAYKIT_INPUT_PASSWORD };
+    ClayKit_InputState *dst_inputs[] = { &a2, &b2 };
+    ClayKit_GetOrCreateState(&dst, 999);
+    ASSERT(ClayKit_LoadSnapshot(&dst, dst_inputs, 2, snap, size));
+
+    ASSERT_EQ(dst.frame, 42);
+    ASSERT_EQ(dst.focused_id, 200);
+    ASSERT_EQ(dst.prev_focused_id, 100);
+    ASSERT_EQ(dst.state_count, 3);
+    ASSERT_NULL(ClayKit_GetState(&dst, 999));
+    ASSERT_EQ_FLOAT(ClayKit_GetState(&dst, 100)->value, 0.25f, 0.0001f);
+    ASSERT_EQ(ClayKit_GetState(&dst, 200)->flags, 7);
+    ASSERT_EQ(ClayKit_GetState(&dst, 100)->frame, 42);
+
+    TestScrollState *restored = (TestScrollState *)ClayKit_FindStateBlob(&dst, 300);
+    ASSERT_NOT_NULL(restored);
+    ASSERT_EQ_FLOAT(restored->offset_x, 12.5f, 0.0001f);
+    ASSERT_EQ_FLOAT(restored->velocity, -3.0f, 0.0001f);
+
+    ASSERT_EQ(a2.len, 5);
+    ASSERT_EQ(a2.cursor, 3);
+    ASSERT_EQ(a2.select_start, 1);
+    ASSERT_EQ(a2.flags, CLAYKIT_INPUT_FOCUSED);
+    ASSERT(memcmp(a2_buf, "hello", 5) == 0);
+    ASSERT_EQ(b2.len, 0);
+    ASSERT_EQ(b2.flags, 0);
+
+    /* The restored context saves to a snapshot of the same size (slot
+     * order differs because the tables have different capacities) */
+    ASSERT_EQ(ClayKit_SaveSnapshot(&dst, dst_inputs, 2, NULL, 0), size);
+
+    TEST_PASS();
+}
+
+TEST(snapshot_keeps_input_mode_flags) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    /* The source is a focused gap-buffer input mid-drag */
+    char src_buf[16] = "hi";
+    ClayKit_InputState src = { .buf = src_buf, .cap = 16, .len = 2, .cursor = 2, .select_start = 2,
+                               .flags = CLAYKIT_INPUT_FOCUSED | CLAYKIT_INPUT_DRAGGING };
+    ClayKit_InputSetGapBuffer(&src, true);
+    ClayKit_InputState *src_inputs[] = { &src };
+    static uint8_t snap[256];
+    uint32_t size = ClayKit_SaveSnapshot(&ctx, src_inputs, 1, snap, sizeof(snap));
+    ASSERT(size > 0 && size <= sizeof(snap));
+
+    /* A plain target takes the focus but not the mode or drag */
+    char plain_buf[16];
+    ClayKit_InputState plain = { .buf = plain_buf, .cap = 16, .flags = CLAYKIT_INPUT_READONLY };
+    ClayKit_InputState *plain_inputs[] = { &plain };
+    ASSERT(ClayKit_LoadSnapshot(&ctx, plain_inputs, 1, snap, size));
+    ASSERT_EQ(plain.flags, CLAYKIT_INPUT_FOCUSED);
+    ASSERT(memcmp(plain_buf, "hi", 2) == 0);
+
+    /* A gap-buffer target mid-drag keeps both */
+    char gap_buf[16];
+    ClayKit_InputState gap = { .buf = gap_buf, .cap = 16, .flags = CLAYKIT_INPUT_DRAGGING };
+    ClayKit_InputSetGapBuffer(&gap, true);
+    ClayKit_InputState *gap_inputs[] = { &gap };
+    ASSERT(ClayKit_LoadSnapshot(&ctx, gap_inputs, 1, snap, size));
+    ASSERT_EQ(gap.flags, CLAYKIT_INPUT_FOCUSED | CLAYKIT_INPUT_GAP_BUFFER | CLAYKIT_INPUT_DRAGGING);
+    ASSERT(ClayKit_InputHandleChar(&gap, '!'));
+    ASSERT(memcmp(ClayKit_InputText(&gap), "hi!", 3) == 0);
+
+    TEST_PASS();
+}
+
+TEST(snapshot_little_endian_header) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_GetOrCreateState(&ctx, 0x01020304u);
+
+    uint8_t snap[64];
+    uint32_t size = ClayKit_SaveSnapshot(&ctx, NULL, 0, snap, sizeof(snap));
+    ASSERT_EQ(size, 32 + 20);
+    ASSERT(memcmp(snap, "CKSN", 4) == 0);
+    ASSERT_EQ(snap[4], CLAYKIT_SNAPSHOT_VERSION);
+    ASSERT_EQ(snap[8], size);
+    ASSERT_EQ(snap[32], 0x04);
+    ASSERT_EQ(snap[35], 0x01);
+
+    /* Too small a buffer: size reported, nothing written */
+    uint8_t small[16];
+    memset(small, 0xAB, sizeof(small));
+    ASSERT_EQ(ClayKit_SaveSnapshot(&ctx, NULL, 0, small, sizeof(small)), size);
+    ASSERT_EQ(small[0], 0xAB);
+
+    TEST_PASS();
+}
+
+TEST(snapshot_rejects_invalid) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State src_buf[8];
+    ClayKit_State dst_buf[2];
+    ClayKit_Context src, dst;
+    ClayKit_Init(&src, &theme, src_buf, 8);
+    ClayKit_Init(&dst, &theme, dst_buf, 2);
+
+    char text_buf[16] = "abcdef";
+    ClayKit_InputState input = { .buf = text_buf, .cap = 16, .len = 6, .cursor = 6, .select_start = 6, .flags = 0 };
+    ClayKit_InputState *inputs[] = { &input };
+    ClayKit_GetOrCreateState(&src, 1);
+    ClayKit_GetOrCreateState(&src, 2);
+
+    uint8_t snap[256];
+    uint32_t size = ClayKit_SaveSnapshot(&src, inputs, 1, snap, sizeof(snap));
+
+    char small_buf[4] = "xy";
+    ClayKit_InputState small = { .buf = small_buf, .cap = 4, .len = 2, .cursor = 1, .select_start = 1, .flags = 0 };
+    ClayKit_InputState *small_inputs[] = { &small };
+    ClayKit_GetOrCreateState(&dst, 77);
+
+    /* Truncated, wrong input count, input too small */
+    ASSERT(!ClayKit_LoadSnapshot(&dst, inputs, 1, snap, size - 1));
+    ASSERT(!ClayKit_LoadSnapshot(&dst, inputs, 0, snap, size));
+    ASSERT(!ClayKit_LoadSnapshot(&dst, small_inputs, 1, snap, size));
+
+    /* Bad magic and version */
+    snap[0] ^= 0xFF;
+    ASSERT(!ClayKit_LoadSnapshot(&dst, inputs, 1, snap, size));
+    snap[0] ^= 0xFF;
+    snap[4]++;
+    ASSERT(!ClayKit_LoadSnapshot(&dst, inputs, 1, snap, size));
+    snap[4]--;
+
+    /* A repeated state id (the second record copies the first's id) */
+    uint8_t second_id[4];
+    memcpy(second_id, snap + 52, 4);
+    memcpy(snap + 52, snap + 32, 4);
+    ASSERT(!ClayKit_LoadSnapshot(&dst, inputs, 1, snap, size));
+    memcpy(snap + 52, second_id, 4);
+
+    /* A missing input can't be saved, just as it can't be loaded */
+    ClayKit_InputState *missing[] = { NULL };
+    ASSERT_EQ(ClayKit_SaveSnapshot(&src, missing, 1, snap, sizeof(snap)), 0);
+    ASSERT(!ClayKit_LoadSnapshot(&dst, missing, 1, snap, size));
+
+    /* Nothing was changed by the failed loads */
+    ASSERT_EQ(small.len, 2);
+    ASSERT_EQ(small.cursor, 1);
+    ASSERT_NOT_NULL(ClayKit_GetState(&dst, 77));
+
+    /* Two states fit a two-slot table; a blob without a pool does not */
+    ASSERT(ClayKit_LoadSnapshot(&dst, inputs, 1, snap, size));
+    ASSERT_NULL(ClayKit_GetState(&dst, 77));
+    ASSERT_NOT_NULL(ClayKit_GetState(&dst, 2));
+
+    static uint8_t pool[CLAYKIT_POOL_PAGE_SIZE + 2 + 15];
+    ClayKit_SetStatePool(&src, pool, sizeof(pool));
+    ASSERT_NOT_NULL(ClayKit_GetStateBlob(&src, 1, 16));
+    size = ClayKit_SaveSnapshot(&src, inputs, 1, snap, sizeof(snap));
+    ASSERT(!ClayKit_LoadSnapshot(&dst, inputs, 1, snap, size));
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Style Cache Tests
+ * ============================================================================ */
+
+TEST(style_cache_hits_match_uncached) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_StyleCacheEntry cache[16];
+    ClayKit_Context cached, plain;
+    ClayKit_Init(&cached, &theme, state_buf, 4);
+    ClayKit_Init(&plain, &theme, state_buf, 4);
+    ClayKit_SetStyleCache(&cached, cache, 16);
+
+    ClayKit_MemoryCounts counts = {0};
+    counts.style_cache_entries = 16;
+    ASSERT_EQ(ClayKit_ComputeMemoryRequirements(&counts).style_cache_bytes, sizeof(cache));
+
+    ClayKit_TableConfig cfg = {0};
+    cfg.striped = true;
+    cfg.color_scheme = CLAYKIT_COLOR_SUCCESS;
+    ClayKit_TableStyle expected = ClayKit_ComputeTableStyle(&plain, cfg);
+
+    /* One table of 50x200 cells computes the same style every cell */
+    for (int i = 0; i < 50 * 200; i++) {
+        ClayKit_TableStyle style = ClayKit_ComputeTableStyle(&cached, cfg);
+        ASSERT(memcmp(&style, &expected, sizeof(style)) == 0);
+    }
+    ASSERT_EQ(cached.stats.style_cache_misses, 1);
+    ASSERT_EQ(cached.stats.style_cache_hits, 50 * 200 - 1);
+
+    /* A different config is a different key */
+    cfg.size = CLAYKIT_SIZE_LG;
+    ClayKit_ComputeTableStyle(&cached, cfg);
+    ASSERT_EQ(cached.stats.style_cache_misses, 2);
+
+    /* Without a cache nothing is counted */
+    ASSERT_EQ(plain.stats.style_cache_hits, 0);
+    ASSERT_EQ(plain.stats.style_cache_misses, 0);
+
+    TEST_PASS();
+}
+
+TEST(style_cache_variant_is_part_of_key) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_StyleCacheEntry cache[16];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+    ClayKit_SetStyleCache(&ctx, cache, 16);
+
+    ClayKit_InputConfig cfg = {0};
+    ClayKit_InputStyle blurred = ClayKit_ComputeInputStyle(&ctx, cfg, false);
+    ClayKit_InputStyle focused = ClayKit_ComputeInputStyle(&ctx, cfg, true);
+    ASSERT_EQ(blurred.border_color.r, theme.border.r);
+    ASSERT_EQ(focused.border_color.r, theme.primary.r);
+
+    focused = ClayKit_ComputeInputStyle(&ctx, cfg, true);
+    ASSERT_EQ(focused.border_color.r, theme.primary.r);
+    ASSERT_EQ(ctx.stats.style_cache_hits, 1);
+
+    TEST_PASS();
+}
+
+TEST(style_cache_theme_changes) {
+    ClayKit_Theme light = CLAYKIT_THEME_LIGHT;
+    ClayKit_Theme dark = CLAYKIT_THEME_DARK;
+    ClayKit_State state_buf[4];
+    ClayKit_StyleCacheEntry cache[16];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &light, state_buf, 4);
+    ClayKit_SetStyleCache(&ctx, cache, 16);
+
+    ClayKit_BadgeConfig cfg = {0};
+    ASSERT_EQ(ClayKit_ComputeBadgeStyle(&ctx, cfg).bg_color.r, light.primary.r);
+
+    /* Swapping the theme pointer is detected */
+    ctx.theme_ptr = &dark;
+    ASSERT_EQ(ClayKit_ComputeBadgeStyle(&ctx, cfg).bg_color.r, dark.primary.r);
+
+    /* Editing the theme in place needs ClayKit_ThemeChanged */
+    dark.primary.r = 1;
+    ClayKit_ThemeChanged(&ctx);
+    ASSERT_EQ(ClayKit_ComputeBadgeStyle(&ctx, cfg).bg_color.r, 1);
+    ASSERT_EQ(ctx.stats.style_cache_hits, 0);
+    ASSERT_EQ(ctx.stats.style_cache_misses, 3);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Compiled Theme Tests
+ * ============================================================================ */
+
+TEST(compile_theme_matches_helpers) {
+    ClayKit_Theme theme = CLAYKIT_THEME_DARK;
+    ClayKit_CompiledTheme ct;
+    ClayKit_CompileTheme(&theme, &ct);
+
+    ASSERT(ct.source == &theme);
+    for (int i = 0; i < CLAYKIT_COLOR_SCHEME_COUNT; i++) {
+        Clay_Color c = ClayKit_GetSchemeColor(&theme, (ClayKit_ColorScheme)i);
+        ASSERT(memcmp(&ct.scheme[i], &c, sizeof(c)) == 0);
+        ASSERT(ct.scheme_hover[i].r <= c.r);
+    }
+    for (int i = 0; i < CLAYKIT_SIZE_COUNT; i++) {
+        ASSERT_EQ(ct.spacing[i], ClayKit_GetSpacing(&theme, (ClayKit_Size)i));
+        ASSERT_EQ(ct.font_size[i], ClayKit_GetFontSize(&theme, (ClayKit_Size)i));
+        ASSERT_EQ(ct.radius[i], ClayKit_GetRadius(&theme, (ClayKit_Size)i));
+    }
+    ASSERT_EQ(ct.heading_font_size[CLAYKIT_SIZE_XS], theme.font_size.md);
+    ASSERT_EQ(ct.heading_font_size[CLAYKIT_SIZE_XL], theme.font_size.xl + 8);
+    ASSERT_EQ(ct.button_pad_x[CLAYKIT_SIZE_XS], 8);
+    ASSERT_EQ(ct.input_pad_y[CLAYKIT_SIZE_XL], 12);
+    ASSERT_EQ(ct.checkbox_size[CLAYKIT_SIZE_MD], 18);
+    ASSERT_EQ(ct.switch_knob_size[CLAYKIT_SIZE_LG], 24);
+
+    TEST_PASS();
+}
+
+TEST(compiled_theme_follows_theme_changes) {
+    ClayKit_Theme light = CLAYKIT_THEME_LIGHT;
+    ClayKit_Theme dark = CLAYKIT_THEME_DARK;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &light, state_buf, 4);
+
+    ASSERT(ctx.compiled_theme.source == &light);
+    ASSERT_EQ(ClayKit_ButtonFontSize(&ctx, CLAYKIT_SIZE_LG), light.font_size.lg);
+
+    /* Out-of-range sizes fall back to MD */
+    ASSERT_EQ(ClayKit_SwitchWidth(&ctx, (ClayKit_Size)99), 42);
+
+    ctx.theme_ptr = &dark;
+    ClayKit_ButtonConfig cfg = {0};
+    ASSERT_EQ(ClayKit_ButtonBgColor(&ctx, cfg, false).r, dark.primary.r);
+
+    dark.font_size.lg = 30;
+    dark.primary.r = 7;
+    ClayKit_ThemeChanged(&ctx);
+    ASSERT_EQ(ClayKit_InputFontSize(&ctx, CLAYKIT_SIZE_LG), 30);
+    ASSERT_EQ(ClayKit_ButtonBgColor(&ctx, cfg, false).r, 7);
+    ASSERT(ctx.compiled_theme.source == &dark);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Gap Buffer Tests
+ * ============================================================================ */
+
+/* Copies the logical text of s into out as a C string */
+static void test_input_text(ClayKit_InputState *s, char *out) {
+    memcpy(out, ClayKit_InputText(s), s->len);
+    out[s->len] = '\0';
+}
+
+TEST(input_gap_buffer_matches_contiguous) {
+    static const uint32_t keys[] = {
+        CLAYKIT_KEY_BACKSPACE, CLAYKIT_KEY_DELETE, CLAYKIT_KEY_LEFT,
+        CLAYKIT_KEY_RIGHT, CLAYKIT_KEY_HOME, CLAYKIT_KEY_END
+    };
+    char flat_buf[64], gap_buf[64];
+    char flat_text[64], gap_text[64];
+    ClayKit_InputState flat = { .buf = flat_buf, .cap = 64, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputState gap = { .buf = gap_buf, .cap = 64, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputSetGapBuffer(&gap, true);
+
+    uint32_t seed = 0x2545F491u;
+    for (int step = 0; step < 4000; step++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        if (seed % 3 == 0) {
+            uint32_t c = (seed >> 8) % 4 == 0 ? ' ' : 'a' + (seed >> 8) % 26;
+            ASSERT_EQ(ClayKit_InputHandleChar(&gap, c), ClayKit_InputHandleChar(&flat, c));
+        } else {
+            uint32_t key = keys[(seed >> 8) % 6];
+            uint32_t mods = (seed >> 16) & (CLAYKIT_MOD_SHIFT | CLAYKIT_MOD_CTRL);
+            ASSERT_EQ(ClayKit_InputHandleKey(&gap, key, mods), ClayKit_InputHandleKey(&flat, key, mods));
+        }
+        ASSERT_EQ(gap.len, flat.len);
+        ASSERT_EQ(gap.cursor, flat.cursor);
+        ASSERT_EQ(gap.select_start, flat.select_start);
+        if (step % 7 == 0) {
+            test_input_text(&gap, gap_text);
+            test_input_text(&flat, flat_text);
+            ASSERT_STR_EQ(gap_text, flat_text);
+        }
+    }
+
+    TEST_PASS();
+}
+
+TEST(input_gap_buffer_edits_at_gap) {
+    char buf[16] = "Hello";
+    char text[16];
+    ClayKit_InputState s = { .buf = buf, .cap = 16, .len = 5, .cursor = 2, .select_start = 2, .flags = 0 };
+
+    ClayKit_InputSetGapBuffer(&s, true);
+    ASSERT(s.flags & CLAYKIT_INPUT_GAP_BUFFER);
+    ASSERT_EQ(s.gap, 5);
+
+    /* The first edit moves the tail to the end of buf, later ones don't */
+    ClayKit_InputHandleChar(&s, 'X');
+    ASSERT_EQ(s.gap, 3);
+    ASSERT(memcmp(buf + 13, "llo", 3) == 0);
+    ClayKit_InputHandleChar(&s, 'Y');
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DELETE, 0);
+    ASSERT_EQ(s.gap, 3);
+    ASSERT(memcmp(buf + 14, "lo", 2) == 0);
+
+    test_input_text(&s, text);
+    ASSERT_STR_EQ(text, "HeXlo");
+
+    /* Turning the mode off leaves contiguous text */
+    ClayKit_InputSetGapBuffer(&s, false);
+    ASSERT(!(s.flags & CLAYKIT_INPUT_GAP_BUFFER));
+    ASSERT(memcmp(buf, "HeXlo", 5) == 0);
+
+    TEST_PASS();
+}
+
+TEST(input_gap_buffer_snapshot_and_render) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+
+    char buf[16] = "world";
+    ClayKit_InputState s = { .buf = buf, .cap = 16, .len = 5, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputSetGapBuffer(&s, true);
+    ClayKit_InputHandleChar(&s, 'a');
+    ClayKit_InputHandleChar(&s, ' ');
+
+    /* Snapshots hold the logical text and restore it contiguously */
+    uint8_t snap[128];
+    char restored_buf[16];
+    ClayKit_InputState restored = { .buf = restored_buf, .cap = 16, .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputState *src[] = { &s };
+    ClayKit_InputState *dst[] = { &restored };
+    uint32_t size = ClayKit_SaveSnapshot(&ctx, src, 1, snap, sizeof(snap));
+    ASSERT(ClayKit_LoadSnapshot(&ctx, dst, 1, snap, size));
+    ASSERT_EQ(restored.gap, 7);
+    ASSERT(memcmp(ClayKit_InputText(&restored), "a world", 7) == 0);
+
+    /* Rendering splits at the cursor without closing the gap */
+    void *mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    ClayKit_BeginFrame(&ctx);
+    Clay_BeginLayout();
+    ClayKit_TextInput(&ctx, "In", 2, &s, (ClayKit_InputConfig){0}, NULL, 0);
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    int texts = 0;
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        if (cmd->commandType != CLAY_RENDER_COMMAND_TYPE_TEXT) continue;
+        Clay_StringSlice str = cmd->renderData.text.stringContents;
+        if (texts == 0) ASSERT(str.length == 2 && memcmp(str.chars, "a ", 2) == 0);
+        if (texts == 1) ASSERT(str.length == 5 && memcmp(str.chars, "world", 5) == 0);
+        texts++;
+    }
+    ASSERT_EQ(texts, 2);
+    ASSERT_EQ(s.gap, 2);
+    test_clay_end(mem);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Text Input Viewport Tests
+ * ============================================================================ */
+
+/* Lays out one frame with a single text input and returns its text runs */
+static int test_text_input_frame(ClayKit_Context *ctx, ClayKit_InputState *s, Clay_StringSlice *runs, int max_runs) {
+    ClayKit_InputConfig cfg = {0};
+    cfg.width = 200;
+    ClayKit_BeginFrame(ctx);
+    Clay_BeginLayout();
+    ClayKit_TextInput(ctx, "Field", 5, s, cfg, NULL, 0);
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    int n = 0;
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT && n < max_runs) {
+            runs[n++] = cmd->renderData.text.stringContents;
+        }
+    }
+    return n;
+}
+
+TEST(text_input_scrolls_to_cursor) {
+    static char buf[1024];
+    float mem[1024];
+    uint32_t calls = 0;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_kerned_width;
+    ctx.measure_text_user_data = &calls;
+
+    for (int i = 0; i < 1000; i++) buf[i] = (char)('a' + i % 26);
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 1000, .cursor = 1000, .select_start = 1000, .flags = 0 };
+    ClayKit_InputAdvanceCache cache;
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 1024);
+
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    Clay_StringSlice runs[4];
+
+    /* The first frame has no width yet; the second lays out only the tail */
+    test_text_input_frame(&ctx, &s, runs, 4);
+    ASSERT_EQ(test_text_input_frame(&ctx, &s, runs, 4), 1);
+    ASSERT(runs[0].length > 0 && runs[0].length < 40);
+    ASSERT(runs[0].chars + runs[0].length == buf + 1000);
+    float scroll = ClayKit_TextInputScroll(&ctx, "Field", 5);
+    ASSERT(scroll > 0.0f);
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(&ctx, (ClayKit_InputConfig){0}, false);
+    ASSERT_EQ_FLOAT(scroll, ClayKit_InputOffsetX(&ctx, &s, style.font_id, style.font_size, (uint32_t)(runs[0].chars - buf)), 0.001f);
+
+    /* A steady frame is served from the advance cache */
+    calls = 0;
+    test_text_input_frame(&ctx, &s, runs, 4);
+    ASSERT_EQ(calls, 0);
+
+    /* Home scrolls back to the start */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_HOME, 0);
+    ASSERT_EQ(test_text_input_frame(&ctx, &s, runs, 4), 1);
+    ASSERT(runs[0].chars == buf);
+    ASSERT(runs[0].length < 40);
+    ASSERT_EQ_FLOAT(ClayKit_TextInputScroll(&ctx, "Field", 5), 0.0f, 0.001f);
+
+    /* Moving within the view leaves the scroll alone */
+    for (int i = 0; i < 3; i++) ClayKit_InputHandleKey(&s, CLAYKIT_KEY_RIGHT, 0);
+    test_text_input_frame(&ctx, &s, runs, 4);
+    ASSERT_EQ_FLOAT(ClayKit_TextInputScroll(&ctx, "Field", 5), 0.0f, 0.001f);
+    ASSERT(runs[0].chars == buf && runs[0].length == 3);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+TEST(text_input_scroll_follows_deletes) {
+    char buf[256];
+    uint32_t calls = 0;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_kerned_width;
+    ctx.measure_text_user_data = &calls;
+
+    memset(buf, 'x', 120);
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 120, .cursor = 120, .select_start = 120, .flags = 0 };
+    ClayKit_InputSetGapBuffer(&s, true);
+
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    Clay_StringSlice runs[4];
+    test_text_input_frame(&ctx, &s, runs, 4);
+    test_text_input_frame(&ctx, &s, runs, 4);
+    float before = ClayKit_TextInputScroll(&ctx, "Field", 5);
+    ASSERT(before > 0.0f);
+
+    /* Deleting at the end pulls the text back instead of leaving a blank */
+    for (int i = 0; i < 10; i++) ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    ASSERT_EQ(test_text_input_frame(&ctx, &s, runs, 4), 1);
+    ASSERT(ClayKit_TextInputScroll(&ctx, "Field", 5) < before);
+    ASSERT(runs[0].chars + runs[0].length == buf + 110);
+
+    /* Text shorter than the box is not scrolled */
+    for (int i = 0; i < 100; i++) ClayKit_InputHandleKey(&s, CLAYKIT_KEY_BACKSPACE, 0);
+    test_text_input_frame(&ctx, &s, runs, 4);
+    ASSERT_EQ_FLOAT(ClayKit_TextInputScroll(&ctx, "Field", 5), 0.0f, 0.001f);
+    ASSERT(runs[0].chars == buf && runs[0].length == 10);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Text Area Tests
+ * ============================================================================ */
+
+/* Checks the line index against a scan of the text */
+static bool test_lines_match(ClayKit_InputState *s) {
+    static char text[4096];
+    memcpy(text, ClayKit_InputText(s), s->len);
+    uint32_t line = 0;
+    uint32_t start = 0;
+    for (uint32_t i = 0; i <= s->len; i++) {
+        if (i < s->len && text[i] != '\n') continue;
+        if (ClayKit_InputLineStart(s, line) != start) return false;
+        if (ClayKit_InputLineEnd(s, line) != i) return false;
+        if (ClayKit_InputLineAt(s, start) != line || ClayKit_InputLineAt(s, i) != line) return false;
+        line++;
+        start = i + 1;
+    }
+    return ClayKit_InputLineCount(s) == line;
+}
+
+TEST(line_index_tracks_edits) {
+    static const char *pieces[] = { "a", "\n", "bc\nd", "\n\n", "xyz", "e\nf\ng" };
+    char buf[1024];
+    uint32_t starts[256];
+    uint8_t history_mem[2048];
+    uint32_t seed = 11;
+
+    for (int gap = 0; gap < 2; gap++) {
+        ClayKit_InputLineIndex lines;
+        ClayKit_InputHistory history;
+        ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+        ClayKit_InputSetGapBuffer(&s, gap != 0);
+        ClayKit_InputSetHistory(&s, &history, history_mem, sizeof(history_mem));
+        ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 256));
+        ASSERT_EQ(ClayKit_InputLineCount(&s), 1);
+
+        for (int i = 0; i < 400; i++) {
+            seed = seed * 1103515245u + 12345u;
+            uint32_t r = seed >> 16;
+            uint32_t a = s.len ? r % (s.len + 1) : 0;
+            uint32_t b = s.len ? (r >> 3) % (s.len + 1) : 0;
+            switch (r % 5) {
+                case 0:
+                case 1: {
+                    const char *piece = pieces[(r >> 5) % 6];
+                    ClayKit_InputReplaceRange(&s, a, a, piece, (uint32_t)strlen(piece));
+                    break;
+                }
+                case 2:
+                    ClayKit_InputReplaceRange(&s, a < b ? a : b, a < b ? b : a, "q\n", 2);
+                    break;
+                case 3:
+                    s.cursor = s.select_start = a;
+                    ClayKit_InputHandleKey(&s, (r & 64) ? CLAYKIT_KEY_BACKSPACE : CLAYKIT_KEY_ENTER, 0);
+                    break;
+                default:
+                    if (r & 32) ClayKit_InputUndo(&s); else ClayKit_InputRedo(&s);
+                    break;
+            }
+            if (s.len > 900) ClayKit_InputReplaceRange(&s, 0, 400, NULL, 0);
+            ASSERT(test_lines_match(&s));
+        }
+    }
+
+    TEST_PASS();
+}
+
+TEST(line_index_limits_lines) {
+    char buf[64];
+    uint32_t starts[3];
+    ClayKit_InputLineIndex lines;
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 0, .cursor = 0, .select_start = 0, .flags = 0 };
+
+    /* Text with more lines than fit is rejected */
+    memcpy(buf, "a\nb\nc\nd", 7);
+    s.len = 7;
+    ASSERT(!ClayKit_InputSetLineIndex(&s, &lines, starts, 3));
+    ASSERT_NULL(s.lines);
+    s.len = 5;
+    ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 3));
+
+    /* Pastes stop before the first newline without a line */
+    s.cursor = s.select_start = 5;
+    ASSERT_EQ(ClayKit_InputInsertText(&s, "x\ny\nz", 5), 1);
+    ASSERT_EQ(s.len, 6);
+    ASSERT(!ClayKit_InputHandleKey(&s, CLAYKIT_KEY_ENTER, 0));
+
+    /* Replacing a newline frees its line */
+    s.cursor = 0;
+    s.select_start = 3;
+    ASSERT(ClayKit_InputHandleKey(&s, CLAYKIT_KEY_ENTER, 0));
+    ASSERT_EQ(ClayKit_InputLineCount(&s), 3);
+    ASSERT(test_lines_match(&s));
+
+    /* Single-line inputs ignore Enter and the vertical keys */
+    ClayKit_InputSetLineIndex(&s, NULL, NULL, 0);
+    ASSERT(!ClayKit_InputHandleKey(&s, CLAYKIT_KEY_ENTER, 0));
+    ASSERT(!ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DOWN, 0));
+    ASSERT_EQ(ClayKit_InputLineCount(&s), 1);
+
+    TEST_PASS();
+}
+
+TEST(text_area_vertical_keys) {
+    char buf[128] = "first line\nab\n\xc3\xa9t\xc3\xa9 long line\nend";
+    uint32_t starts[16];
+    ClayKit_InputLineIndex lines;
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = (uint32_t)strlen(buf), .cursor = 4, .select_start = 4, .flags = 0 };
+    ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 16));
+    ASSERT_EQ(ClayKit_InputLineCount(&s), 4);
+
+    /* Down clamps to a short line's end, the next Down keeps counting
+     * codepoints rather than bytes */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DOWN, 0);
+    ASSERT_EQ(s.cursor, 13);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_DOWN, 0);
+    ASSERT_EQ(s.cursor, 17);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_UP, CLAYKIT_MOD_SHIFT);
+    ASSERT_EQ(s.cursor, 13);
+    ASSERT_EQ(s.select_start, 17);
+
+    /* Home and End stay on the line; Ctrl goes to the ends of the text */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_HOME, 0);
+    ASSERT_EQ(s.cursor, 11);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_END, 0);
+    ASSERT_EQ(s.cursor, 13);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_END, CLAYKIT_MOD_CTRL);
+    ASSERT_EQ(s.cursor, s.len);
+
+    /* Pages move by the rows the text area last showed */
+    lines.page = 2;
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_PAGE_UP, 0);
+    ASSERT_EQ(ClayKit_InputLineAt(&s, s.cursor), 1);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_PAGE_UP, 0);
+    ASSERT_EQ(s.cursor, 0);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_PAGE_DOWN, 0);
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_PAGE_DOWN, 0);
+    ASSERT_EQ(s.cursor, s.len);
+
+    /* Enter splits the line */
+    s.cursor = s.select_start = 1;
+    ASSERT(ClayKit_InputHandleKey(&s, CLAYKIT_KEY_ENTER, 0));
+    ASSERT_EQ(ClayKit_InputLineCount(&s), 5);
+    ASSERT_EQ(ClayKit_InputLineStart(&s, 1), 2);
+    ASSERT(test_lines_match(&s));
+
+    TEST_PASS();
+}
+
+/* Lays out one frame with a 5-row text area and returns its text runs */
+static int test_text_area_frame(ClayKit_Context *ctx, ClayKit_InputState *s, Clay_StringSlice *runs, int max_runs) {
+    ClayKit_InputConfig cfg = {0};
+    cfg.rows = 5;
+    cfg.width = 300;
+    ClayKit_BeginFrame(ctx);
+    Clay_BeginLayout();
+    ClayKit_TextArea(ctx, "Notes", 5, s, cfg, NULL, 0);
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    int n = 0;
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT && n < max_runs) {
+            runs[n++] = cmd->renderData.text.stringContents;
+        }
+    }
+    return n;
+}
+
+TEST(text_area_renders_visible_lines) {
+    static char buf[64 * 1024];
+    static uint32_t starts[8192];
+    ClayKit_InputLineIndex lines;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+
+    uint32_t len = 0;
+    for (int i = 0; i < 5000; i++) {
+        len += (uint32_t)sprintf(buf + len, "line %d\n", i);
+    }
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = len, .cursor = 0, .select_start = 0, .flags = CLAYKIT_INPUT_FOCUSED };
+    ClayKit_InputSetGapBuffer(&s, true);
+    ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 8192));
+    ASSERT_EQ(ClayKit_InputLineCount(&s), 5001);
+
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    Clay_StringSlice runs[16];
+
+    /* Only the first five lines are laid out */
+    ASSERT_EQ(test_text_area_frame(&ctx, &s, runs, 16), 5);
+    ASSERT(runs[0].length == 6 && memcmp(runs[0].chars, "line 0", 6) == 0);
+    ASSERT(runs[4].length == 6 && memcmp(runs[4].chars, "line 4", 6) == 0);
+    ASSERT_EQ(lines.page, 5);
+
+    /* Jumping to line 3000 scrolls it to the bottom row; the cursor line is
+     * split around the cursor */
+    s.cursor = s.select_start = ClayKit_InputLineStart(&s, 3000) + 2;
+    ASSERT_EQ(test_text_area_frame(&ctx, &s, runs, 16), 6);
+    ASSERT(runs[0].length == 9 && memcmp(runs[0].chars, "line 2996", 9) == 0);
+    ASSERT(runs[4].length == 2 && memcmp(runs[4].chars, "li", 2) == 0);
+    ASSERT(runs[5].length == 7 && memcmp(runs[5].chars, "ne 3000", 7) == 0);
+
+    /* Typing goes through the gap at the cursor */
+    ClayKit_InputHandleChar(&s, 'X');
+    ASSERT_EQ(test_text_area_frame(&ctx, &s, runs, 16), 6);
+    ASSERT(runs[4].length == 3 && memcmp(runs[4].chars, "liX", 3) == 0);
+    ASSERT_EQ(s.gap, s.cursor);
+
+    /* Moving up within the view keeps the scroll */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_UP, 0);
+    test_text_area_frame(&ctx, &s, runs, 16);
+    ASSERT(runs[0].length == 9 && memcmp(runs[0].chars, "line 2996", 9) == 0);
+
+    /* The empty last line still gets a row */
+    ClayKit_InputHandleKey(&s, CLAYKIT_KEY_END, CLAYKIT_MOD_CTRL);
+    ASSERT_EQ(test_text_area_frame(&ctx, &s, runs, 16), 4);
+    ASSERT(runs[3].length == 9 && memcmp(runs[3].chars, "line 4999", 9) == 0);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+TEST(text_area_hit_test) {
+    char buf[256] = "alpha\nbeta\ngamma\ndelta\nepsilon\nzeta\neta";
+    uint32_t starts[16];
+    ClayKit_InputLineIndex lines;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_byte_width;
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = (uint32_t)strlen(buf), .cursor = 0, .select_start = 0, .flags = 0 };
+    ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 16));
+    s.cursor = s.select_start = s.len;
+
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    Clay_StringSlice runs[16];
+    test_text_area_frame(&ctx, &s, runs, 16);
+    test_text_area_frame(&ctx, &s, runs, 16);
+
+    /* Rows show lines 2..6; the second row is "delta" */
+    ClayKit_InputConfig cfg = {0};
+    cfg.rows = 5;
+    cfg.width = 300;
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(&ctx, cfg, false);
+    Clay_String id_str = { false, 5, "Notes" };
+    Clay_ElementData elem = Clay_GetElementData(Clay__HashString(id_str, 0, 0));
+    ASSERT(elem.found);
+    float line_height = (float)(style.font_size + style.font_size / 4);
+    float x = elem.boundingBox.x + style.padding_x + 21.0f;
+    float y = elem.boundingBox.y + style.padding_y + 1.5f * line_height;
+    ASSERT_EQ(ClayKit_TextAreaHitTest(&ctx, "Notes", 5, &s, cfg, x, y), ClayKit_InputLineStart(&s, 3) + 2);
+
+    /* Past the end of a line lands on its end; far below the rows on the last line */
+    x = elem.boundingBox.x + 500.0f;
+    ASSERT_EQ(ClayKit_TextAreaHitTest(&ctx, "Notes", 5, &s, cfg, x, y), ClayKit_InputLineEnd(&s, 3));
+    y = elem.boundingBox.y + 1000.0f;
+    ASSERT_EQ(ClayKit_TextAreaHitTest(&ctx, "Notes", 5, &s, cfg, x, y), s.len);
+    ASSERT_EQ(ClayKit_TextAreaHitTest(&ctx, "Missing", 7, &s, cfg, x, y), s.cursor);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Text Selection Tests
+ * ============================================================================ */
+
+typedef struct {
+    Clay_StringSlice runs[16];
+    Clay_BoundingBox run_boxes[16];
+    Clay_BoundingBox highlights[8];
+    int run_count;
+    int highlight_count;
+} TestSelectionFrame;
+
+/* Collects text runs and selection highlights from one frame of a text
+ * input (rows == 0) or text area */
+static void test_selection_frame(ClayKit_Context *ctx, ClayKit_InputState *s, uint16_t rows, TestSelectionFrame *out) {
+    ClayKit_InputConfig cfg = {0};
+    cfg.width = 300;
+    cfg.rows = rows;
+    Clay_Color highlight = ClayKit_ComputeInputStyle(ctx, cfg, true).selection_color;
+    ClayKit_BeginFrame(ctx);
+    Clay_BeginLayout();
+    if (rows > 0) {
+        ClayKit_TextArea(ctx, "Notes", 5, s, cfg, NULL, 0);
+    } else {
+        ClayKit_TextInput(ctx, "Field", 5, s, cfg, NULL, 0);
+    }
+    Clay_RenderCommandArray cmds = Clay_EndLayout();
+    memset(out, 0, sizeof(*out));
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT && out->run_count < 16) {
+            out->run_boxes[out->run_count] = cmd->boundingBox;
+            out->runs[out->run_count++] = cmd->renderData.text.stringContents;
+        } else if (cmd->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE && out->highlight_count < 8 &&
+                   memcmp(&cmd->renderData.rectangle.backgroundColor, &highlight, sizeof(highlight)) == 0) {
+            out->highlights[out->highlight_count++] = cmd->boundingBox;
+        }
+    }
+}
+
+static bool test_run_is(Clay_StringSlice run, const char *text) {
+    return run.length == (int32_t)strlen(text) && memcmp(run.chars, text, strlen(text)) == 0;
+}
+
+TEST(text_input_renders_selection) {
+    char buf[32] = "hello world";
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_byte_width;
+    static TestSelectionFrame f;
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 11, .cursor = 7, .select_start = 2, .flags = CLAYKIT_INPUT_FOCUSED };
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+
+    /* Before, highlighted and after runs; the highlight sits behind its run */
+    test_selection_frame(&ctx, &s, 0, &f);
+    ASSERT_EQ(f.run_count, 3);
+    ASSERT(test_run_is(f.runs[0], "he"));
+    ASSERT(test_run_is(f.runs[1], "llo w"));
+    ASSERT(test_run_is(f.runs[2], "orld"));
+    ASSERT_EQ(f.highlight_count, 1);
+    ASSERT_EQ_FLOAT(f.highlights[0].x, f.run_boxes[1].x, 0.001f);
+    ASSERT_EQ_FLOAT(f.highlights[0].width, f.run_boxes[1].width, 0.001f);
+
+    /* Direction doesn't matter, and the selection stays visible unfocused */
+    s.cursor = 2;
+    s.select_start = 7;
+    s.flags = 0;
+    test_selection_frame(&ctx, &s, 0, &f);
+    ASSERT_EQ(f.run_count, 3);
+    ASSERT(test_run_is(f.runs[1], "llo w"));
+    ASSERT_EQ(f.highlight_count, 1);
+
+    /* Selecting back over typed text leaves the gap where it is (the
+     * advance cache keeps the viewport from reading the text contiguously) */
+    float mem[32];
+    ClayKit_InputAdvanceCache cache;
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 32);
+    ClayKit_InputSetGapBuffer(&s, true);
+    s.cursor = s.select_start = 5;
+    ClayKit_InputHandleChar(&s, '!');
+    for (int i = 0; i < 3; i++) ClayKit_InputHandleKey(&s, CLAYKIT_KEY_LEFT, CLAYKIT_MOD_SHIFT);
+    test_selection_frame(&ctx, &s, 0, &f);
+    ASSERT_EQ(s.gap, 6);
+    ASSERT(test_run_is(f.runs[0], "hel"));
+    ASSERT(test_run_is(f.runs[1], "lo!"));
+    ASSERT(test_run_is(f.runs[2], " world"));
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+TEST(text_area_renders_selection) {
+    char buf[64] = "alpha\nbeta\ngamma";
+    uint32_t starts[8];
+    ClayKit_InputLineIndex lines;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    static TestSelectionFrame f;
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 16, .cursor = 13, .select_start = 2, .flags = CLAYKIT_INPUT_FOCUSED };
+    ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 8));
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+
+    /* Each line shows its part of the selection on its own highlight */
+    test_selection_frame(&ctx, &s, 5, &f);
+    ASSERT_EQ(f.run_count, 5);
+    ASSERT(test_run_is(f.runs[0], "al"));
+    ASSERT(test_run_is(f.runs[1], "pha"));
+    ASSERT(test_run_is(f.runs[2], "beta"));
+    ASSERT(test_run_is(f.runs[3], "ga"));
+    ASSERT(test_run_is(f.runs[4], "mma"));
+    ASSERT_EQ(f.highlight_count, 3);
+    ASSERT_EQ_FLOAT(f.highlights[2].y, f.run_boxes[3].y, 0.001f);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+TEST(text_input_pointer_drag) {
+    char buf[64] = "The quick brown fox";
+    float mem[64];
+    uint32_t calls = 0;
+    ClayKit_InputAdvanceCache cache;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_kerned_width;
+    ctx.measure_text_user_data = &calls;
+    static TestSelectionFrame f;
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 19, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputSetAdvanceCache(&s, &cache, mem, 64);
+    ClayKit_InputConfig cfg = {0};
+    cfg.width = 300;
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    test_selection_frame(&ctx, &s, 0, &f);
+
+    Clay_String id_str = { false, 5, "Field" };
+    Clay_BoundingBox box = Clay_GetElementData(Clay__HashString(id_str, 0, 0)).boundingBox;
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(&ctx, cfg, true);
+    float x0 = box.x + (float)style.padding_x + 0.5f;
+    float y = box.y + box.height / 2.0f;
+#define TEST_X_OF(offset) (x0 + ClayKit_InputOffsetX(&ctx, &s, style.font_id, style.font_size, (offset)))
+
+    /* A press focuses and places the cursor */
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, TEST_X_OF(4), y, true, true, 0));
+    ASSERT_EQ(s.cursor, 4);
+    ASSERT_EQ(s.select_start, 4);
+    ASSERT(s.flags & CLAYKIT_INPUT_FOCUSED);
+    ASSERT(s.flags & CLAYKIT_INPUT_DRAGGING);
+
+    /* Dragging extends the selection; once the widths are cached, moving
+     * back and forth measures nothing */
+    float x9 = TEST_X_OF(9);
+    float x6 = TEST_X_OF(6);
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x9, y, false, true, 0));
+    ASSERT_EQ(s.cursor, 9);
+    calls = 0;
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, false, true, 0));
+    ASSERT_EQ(s.cursor, 6);
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x9, y, false, true, 0));
+    ASSERT_EQ(s.cursor, 9);
+    ASSERT_EQ(calls, 0);
+    ASSERT_EQ(s.select_start, 4);
+
+    test_selection_frame(&ctx, &s, 0, &f);
+    ASSERT_EQ(f.run_count, 3);
+    ASSERT(test_run_is(f.runs[1], "quick"));
+
+    /* Releasing ends the drag; moving afterwards changes nothing */
+    ASSERT(!ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, false, false, 0));
+    ASSERT(!(s.flags & CLAYKIT_INPUT_DRAGGING));
+    ASSERT(!ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x0, y, false, false, 0));
+    ASSERT_EQ(s.cursor, 9);
+
+    /* Shift+press extends from the existing anchor */
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, TEST_X_OF(15), y, true, true, CLAYKIT_MOD_SHIFT));
+    ASSERT_EQ(s.cursor, 15);
+    ASSERT_EQ(s.select_start, 4);
+
+    /* A press elsewhere unfocuses */
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x0, box.y - 5.0f, true, true, 0));
+    ASSERT(!(s.flags & CLAYKIT_INPUT_FOCUSED));
+    ASSERT_EQ(s.cursor, 15);
+#undef TEST_X_OF
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+TEST(text_input_double_click_selects_word) {
+    char buf[64] = "The quick brown fox";
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_byte_width;
+    static TestSelectionFrame f;
+
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = 19, .cursor = 0, .select_start = 0, .flags = 0 };
+    ClayKit_InputConfig cfg = {0};
+    cfg.width = 300;
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    test_selection_frame(&ctx, &s, 0, &f);
+
+    Clay_String id_str = { false, 5, "Field" };
+    Clay_BoundingBox box = Clay_GetElementData(Clay__HashString(id_str, 0, 0)).boundingBox;
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(&ctx, cfg, true);
+    float x6 = box.x + (float)style.padding_x + 60.5f;
+    float y = box.y + box.height / 2.0f;
+
+    /* The first press only focuses and places the cursor */
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, true, true, 0));
+    ASSERT_EQ(s.cursor, 6);
+    ASSERT_EQ(s.select_start, 6);
+    ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, false, false, 0);
+
+    /* A quick second press on the same spot selects the word, and holding
+     * the button keeps it */
+    ctx.cursor_blink_time = 0.1f;
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, true, true, 0));
+    ASSERT_EQ(s.select_start, 4);
+    ASSERT_EQ(s.cursor, 9);
+    ASSERT(!ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6 + 30.0f, y, false, true, 0));
+    ASSERT_EQ(s.cursor, 9);
+    ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, false, false, 0);
+
+    /* A third press collapses the selection again */
+    ASSERT(ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, true, true, 0));
+    ASSERT_EQ(s.cursor, 6);
+    ASSERT_EQ(s.select_start, 6);
+    ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, false, false, 0);
+
+    /* Too slow is two single clicks */
+    ctx.cursor_blink_time = CLAYKIT_DOUBLE_CLICK_TIME + 0.1f;
+    ClayKit_TextInputPointer(&ctx, "Field", 5, &s, cfg, x6, y, true, true, 0);
+    ASSERT_EQ(s.cursor, 6);
+    ASSERT_EQ(s.select_start, 6);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+TEST(text_area_pointer_drag_scrolls) {
+    char buf[256];
+    uint32_t starts[32];
+    ClayKit_InputLineIndex lines;
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[8];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 8);
+    ctx.measure_text = test_byte_width;
+
+    uint32_t len = 0;
+    for (int i = 0; i < 20; i++) {
+        len += (uint32_t)sprintf(buf + len, "line%02d\n", i);
+    }
+    ClayKit_InputState s = { .buf = buf, .cap = sizeof(buf), .len = len - 1, .cursor = 0, .select_start = 0, .flags = 0 };
+    ASSERT(ClayKit_InputSetLineIndex(&s, &lines, starts, 32));
+
+    void *clay_mem = test_clay_begin(64, 256, (Clay_ErrorHandler){0});
+    Clay_StringSlice runs[16];
+    test_text_area_frame(&ctx, &s, runs, 16);
+
+    ClayKit_InputConfig cfg = {0};
+    cfg.rows = 5;
+    cfg.width = 300;
+    ClayKit_InputStyle style = ClayKit_ComputeInputStyle(&ctx, cfg, true);
+    Clay_String id_str = { false, 5, "Notes" };
+    Clay_BoundingBox box = Clay_GetElementData(Clay__HashString(id_str, 0, 0)).boundingBox;
+    float line_height = (float)(style.font_size + style.font_size / 4);
+    float x = box.x + (float)style.padding_x + 21.0f;
+    float top = box.y + (float)style.padding_y;
+
+    /* Press on the second row, third column */
+    ASSERT(ClayKit_TextAreaPointer(&ctx, "Notes", 5, &s, cfg, x, top + 1.5f * line_height, true, true, 0));
+    ASSERT_EQ(s.cursor, ClayKit_InputLineStart(&s, 1) + 2);
+
+    /* Holding half a row below the text scrolls one line per frame */
+    for (int i = 0; i < 10; i++) {
+        ClayKit_TextAreaPointer(&ctx, "Notes", 5, &s, cfg, x, top + 5.5f * line_height, false, true, 0);
+        test_text_area_frame(&ctx, &s, runs, 16);
+    }
+    ASSERT_EQ(ClayKit_InputLineAt(&s, s.cursor), 14);
+    ASSERT_EQ(s.cursor, ClayKit_InputLineStart(&s, 14) + 2);
+    ASSERT_EQ(s.select_start, ClayKit_InputLineStart(&s, 1) + 2);
+    ASSERT(test_run_is(runs[0], "line10"));
+
+    /* And above the text scrolls back up */
+    for (int i = 0; i < 3; i++) {
+        ClayKit_TextAreaPointer(&ctx, "Notes", 5, &s, cfg, x, top - 0.5f * line_height, false, true, 0);
+        test_text_area_frame(&ctx, &s, runs, 16);
+    }
+    ASSERT_EQ(ClayKit_InputLineAt(&s, s.cursor), 7);
+
+    test_clay_end(clay_mem);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Tooltip Size Tests
+ * ============================================================================ */
+
+TEST(tooltip_style_sizes) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    /* All positions should return same style */
+    ClayKit_TooltipStyle top = ClayKit_ComputeTooltipStyle(&ctx, (ClayKit_TooltipConfig){ .position = CLAYKIT_TOOLTIP_TOP });
+    ClayKit_TooltipStyle bottom = ClayKit_ComputeTooltipStyle(&ctx, (ClayKit_TooltipConfig){ .position = CLAYKIT_TOOLTIP_BOTTOM });
+
+    ASSERT_EQ(top.font_size, bottom.font_size);
+    ASSERT_EQ(top.padding_x, bottom.padding_x);
+    ASSERT_EQ(top.corner_radius, bottom.corner_radius);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Alert Icon Size Tests
+ * ============================================================================ */
+
+TEST(alert_style_icon_size) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    /* Default icon size when not specified */
+    ClayKit_AlertConfig cfg1 = { .icon = { .id = 1, .size = 0 } };
+    ClayKit_AlertStyle style1 = ClayKit_ComputeAlertStyle(&ctx, cfg1);
+    ASSERT_EQ(style1.icon_size, 20);
+
+    /* Custom icon size */
+    ClayKit_AlertConfig cfg2 = { .icon = { .id = 1, .size = 32 } };
+    ClayKit_AlertStyle style2 = ClayKit_ComputeAlertStyle(&ctx, cfg2);
+    ASSERT_EQ(style2.icon_size, 32);
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Checkbox/Switch Disabled Tests
+ * ============================================================================ */
+
+TEST(checkbox_disabled_state) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    ClayKit_State state_buf[4];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 4);
+
+    ClayKit_CheckboxConfig cfg = { .color_scheme = CLAYKIT_COLOR_PRIMARY, .disabled = true };
+
+    /* Disabled checked: muted color */
+    Clay_Color disabled_checked = ClayKit_CheckboxBgColor(&ctx, cfg, true, false);
     ASSERT_EQ(disabled_checked.r, theme.muted.r);
 
     /* Disabled unchecked: border color */
@@ -2858,6 +6233,20 @@ int main(void) {
     RUN_TEST(get_state_after_create);
     RUN_TEST(state_capacity_limit);
     RUN_TEST(multiple_states);
+    RUN_TEST(state_full_table_lookups);
+    RUN_TEST(state_zero_id_rejected);
+    RUN_TEST(state_lookup_stamps_frame);
+    RUN_TEST(evict_stale_states);
+    RUN_TEST(evict_keeps_probe_chains_intact);
+    RUN_TEST(begin_frame_auto_evicts);
+
+    printf("\nState Pool:\n");
+    RUN_TEST(state_blob_create_and_find);
+    RUN_TEST(state_blob_same_class_contiguous);
+    RUN_TEST(state_blob_limits);
+    RUN_TEST(state_blob_page_reuse);
+    RUN_TEST(state_blob_grows_size_class);
+    RUN_TEST(state_blob_freed_on_eviction);
 
     printf("\nFocus Management:\n");
     RUN_TEST(focus_initial_state);
@@ -2896,11 +6285,52 @@ int main(void) {
     RUN_TEST(input_type_replaces_selection);
     RUN_TEST(input_ctrl_left_word);
     RUN_TEST(input_ctrl_right_word);
+    RUN_TEST(input_ctrl_word_stops_at_punctuation);
+    RUN_TEST(input_ctrl_backspace_delete_word);
+    RUN_TEST(input_select_word);
     RUN_TEST(input_backspace_empty);
     RUN_TEST(input_full_selection_replace);
     RUN_TEST(input_home_shift_select);
     RUN_TEST(input_double_backspace);
 
+    printf("\nUTF-8 Input:\n");
+    RUN_TEST(input_utf8_insert_encodes);
+    RUN_TEST(input_utf8_capacity_is_all_or_nothing);
+    RUN_TEST(input_utf8_moves_and_deletes_codepoints);
+    RUN_TEST(input_utf8_word_motion_long_text);
+    RUN_TEST(input_utf8_cursor_from_x_on_boundaries);
+
+    printf("\nBulk Insert:\n");
+    RUN_TEST(input_insert_text_replaces_selection);
+    RUN_TEST(input_insert_text_truncates_on_codepoint);
+    RUN_TEST(input_replace_range_matches_typing);
+
+    printf("\nUndo History:\n");
+    RUN_TEST(input_undo_coalesces_typing);
+    RUN_TEST(input_undo_restores_selection);
+    RUN_TEST(input_undo_ring_drops_oldest);
+
+    printf("\nEdit Delta:\n");
+    RUN_TEST(input_delta_reports_edits);
+    RUN_TEST(input_delta_replays_to_same_text);
+
+    printf("\nHit-Test Cache:\n");
+    RUN_TEST(input_hit_test_matches_linear_scan);
+    RUN_TEST(input_advance_cache_invalidation);
+
+    printf("\nFont Metrics:\n");
+    RUN_TEST(font_metrics_measure_without_callback);
+    RUN_TEST(font_metrics_kerning_and_replace);
+    RUN_TEST(font_metrics_drive_hit_test);
+    RUN_TEST(clay_measure_shares_callback);
+    RUN_TEST(clay_measure_has_no_length_limit);
+    RUN_TEST(measure_batch_skips_registered_fonts);
+    RUN_TEST(measure_batch_hit_test_matches_single);
+
+    printf("\nText Truncation:\n");
+    RUN_TEST(text_truncate_fits_and_cuts);
+    RUN_TEST(text_truncated_uses_previous_width);
+
     printf("\nTypography:\n");
     RUN_TEST(text_style_defaults);
     RUN_TEST(text_style_custom_size);
@@ -2910,7 +6340,67 @@ int main(void) {
 
     printf("\nIcon Data:\n");
     RUN_TEST(icon_render_data_stores_values);
-    RUN_TEST(icon_render_data_ring_wraps);
+    RUN_TEST(icon_render_data_does_not_wrap);
+
+    printf("\nFrame Arena:\n");
+    RUN_TEST(frame_arena_alloc_aligns);
+    RUN_TEST(frame_arena_overflow);
+    RUN_TEST(frame_arena_reset_by_begin_frame);
+    RUN_TEST(frame_arena_unset);
+
+    printf("\nMemory Planning:\n");
+    RUN_TEST(memory_requirements_counts);
+    RUN_TEST(memory_requirements_keeps_clay_context);
+    RUN_TEST(memory_requirements_state_pool);
+    RUN_TEST(memory_requirements_match_clay_layout);
+
+    printf("\nStats:\n");
+    RUN_TEST(stats_state_slots);
+    RUN_TEST(stats_state_pool_pages);
+    RUN_TEST(stats_frame_arena_icons_and_numbers);
+    RUN_TEST(icon_emit_with_and_without_arena);
+    RUN_TEST(stats_clay_elements_and_words);
+    RUN_TEST(stats_measure_calls_and_clay_hits);
+    RUN_TEST(stats_recommend_and_resize_measure_cache);
+    RUN_TEST(stats_reset);
+
+    printf("\nSnapshot:\n");
+    RUN_TEST(snapshot_round_trip);
+    RUN_TEST(snapshot_keeps_input_mode_flags);
+    RUN_TEST(snapshot_little_endian_header);
+    RUN_TEST(snapshot_rejects_invalid);
+
+    printf("\nStyle Cache:\n");
+    RUN_TEST(style_cache_hits_match_uncached);
+    RUN_TEST(style_cache_variant_is_part_of_key);
+    RUN_TEST(style_cache_theme_changes);
+
+    printf("\nCompiled Theme:\n");
+    RUN_TEST(compile_theme_matches_helpers);
+    RUN_TEST(compiled_theme_follows_theme_changes);
+
+    printf("\nGap Buffer:\n");
+    RUN_TEST(input_gap_buffer_matches_contiguous);
+    RUN_TEST(input_gap_buffer_edits_at_gap);
+    RUN_TEST(input_gap_buffer_snapshot_and_render);
+
+    printf("\nText Input Viewport:\n");
+    RUN_TEST(text_input_scrolls_to_cursor);
+    RUN_TEST(text_input_scroll_follows_deletes);
+
+    printf("\nText Area:\n");
+    RUN_TEST(line_index_tracks_edits);
+    RUN_TEST(line_index_limits_lines);
+    RUN_TEST(text_area_vertical_keys);
+    RUN_TEST(text_area_renders_visible_lines);
+    RUN_TEST(text_area_hit_test);
+
+    printf("\nText Selection:\n");
+    RUN_TEST(text_input_renders_selection);
+    RUN_TEST(text_area_renders_selection);
+    RUN_TEST(text_input_pointer_drag);
+    RUN_TEST(text_input_double_click_selects_word);
+    RUN_TEST(text_area_pointer_drag_scrolls);
 
     printf("\nLayout Primitives:\n");
     RUN_TEST(box_layout_padding);
@@ -0,0 +1,129 @@
+/*
+ * State pool tests for clay_kit.h at the largest page size
+ *
+ * With CLAYKIT_POOL_PAGE_SIZE at its limit a page holds 255 blobs of the
+ * smallest class, the most its live count can track. Fills pages that full
+ * and checks no live blob is reclaimed or overwritten.
+ *
+ * Compile: gcc -std=c99 -Wall -Wextra -I. -Ivendor tests/test_pool_pages.c -o tests/test_pool_pages -lm
+ * Run: ./tests/test_pool_pages
+ */
+
+#define CLAYKIT_POOL_PAGE_SIZE 4080
+
+#define CLAY_IMPLEMENTATION
+#include "../vendor/clay.h"
+
+#define CLAYKIT_IMPLEMENTATION
+#include "../clay_kit.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * Minimal Test Framework
+ * ============================================================================ */
+
+static int g_tests_run = 0;
+static int g_tests_passed = 0;
+static int g_tests_failed = 0;
+static const char *g_current_test = NULL;
+
+#define TEST(name) \
+    static void test_##name(void); \
+    static void run_test_##name(void) { \
+        g_current_test = #name; \
+        g_tests_run++; \
+        test_##name(); \
+    } \
+    static void test_##name(void)
+
+#define RUN_TEST(name) run_test_##name()
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("  FAIL: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        g_tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("  FAIL: %s:%d: %s == %s (got %d, expected %d)\n", \
+               __FILE__, __LINE__, #a, #b, (int)(a), (int)(b)); \
+        g_tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define TEST_PASS() do { \
+    g_tests_passed++; \
+    printf("  PASS: %s\n", g_current_test); \
+} while(0)
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+#define TEST_BLOBS 300
+
+TEST(full_pages_keep_live_blobs) {
+    ClayKit_Theme theme = CLAYKIT_THEME_LIGHT;
+    static ClayKit_State state_buf[512];
+    static uint8_t pool[3 * (CLAYKIT_POOL_PAGE_SIZE + 2) + 15];
+    ClayKit_Context ctx;
+    ClayKit_Init(&ctx, &theme, state_buf, 512);
+    ClayKit_SetStatePool(&ctx, pool, sizeof(pool));
+    ASSERT_EQ(ctx.state_pool.page_count, 3);
+
+    /* Fills page 0 with 255 blobs and spills onto page 1 */
+    for (uint32_t i = 1; i <= TEST_BLOBS; i++) {
+        uint32_t *blob = (uint32_t *)ClayKit_GetStateBlob(&ctx, i, 16);
+        ASSERT(blob != NULL);
+        *blob = i;
+    }
+    ASSERT_EQ(ctx.state_pool.page_live[0], 255);
+    ASSERT_EQ(ctx.state_pool.page_live[1], TEST_BLOBS - 255);
+    ASSERT_EQ(ctx.state_pool.pages_used, 2);
+
+    /* The last page goes to the 256-byte class; once it is full, neither
+     * page of live 16-byte blobs may be reclaimed */
+    for (uint32_t i = 0; i < CLAYKIT_POOL_PAGE_SIZE / 256; i++) {
+        ASSERT(ClayKit_GetStateBlob(&ctx, 1000 + i, 256) != NULL);
+    }
+    ASSERT(ClayKit_GetStateBlob(&ctx, 2000, 256) == NULL);
+    ASSERT_EQ(ctx.state_pool.free_page_count, 0);
+
+    for (uint32_t i = 1; i <= TEST_BLOBS; i++) {
+        uint32_t *blob = (uint32_t *)ClayKit_FindStateBlob(&ctx, i);
+        ASSERT(blob != NULL);
+        ASSERT_EQ(*blob, i);
+    }
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void) {
+    printf("\n=== ClayKit State Pool Page Tests ===\n\n");
+
+    printf("State Pool:\n");
+    RUN_TEST(full_pages_keep_live_blobs);
+
+    printf("\n=== Results ===\n");
+    printf("Tests run:    %d\n", g_tests_run);
+    printf("Tests passed: %d\n", g_tests_passed);
+    printf("Tests failed: %d\n", g_tests_failed);
+
+    if (g_tests_failed > 0) {
+        printf("\nSOME TESTS FAILED!\n");
+        return 1;
+    }
+
+    printf("\nALL TESTS PASSED!\n");
+    return 0;
+}
@@ -0,0 +1,278 @@
+/*
+ * Multi-threaded layout tests for clay_kit.h
+ *
+ * Builds several independent ClayKit/Clay contexts on worker threads at the
+ * same time and checks each produces the same render commands as a serial
+ * build.
+ *
+ * Compile: gcc -std=c99 -Wall -Wextra -I. -Ivendor tests/test_threads.c -o tests/test_threads -lm -lpthread
+ * Run: ./tests/test_threads
+ */
+
+/* Clay keeps its current context in a plain global. ClayKit holds all of its
+ * own mutable state in ClayKit_Context, but parallel builds also need Clay's
+ * current context to be per-thread. Route it through a thread-local slot. */
+struct Clay_Context;
+struct Clay_Context **test_thread_clay_context(void);
+#define Clay__currentContext (*test_thread_clay_context())
+
+#define CLAY_IMPLEMENTATION
+#include "../vendor/clay.h"
+
+#define CLAYKIT_IMPLEMENTATION
+#include "../clay_kit.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static __thread Clay_Context *g_thread_clay_context;
+
+struct Clay_Context **test_thread_clay_context(void) {
+    return &g_thread_clay_context;
+}
+
+/* ============================================================================
+ * Minimal Test Framework
+ * ============================================================================ */
+
+static int g_tests_run = 0;
+static int g_tests_passed = 0;
+static int g_tests_failed = 0;
+static const char *g_current_test = NULL;
+
+#define TEST(name) \
+    static void test_##name(void); \
+    static void run_test_##name(void) { \
+        g_current_test = #name; \
+        g_tests_run++; \
+        test_##name(); \
+    } \
+    static void test_##name(void)
+
+#define RUN_TEST(name) run_test_##name()
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("  FAIL: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        g_tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        printf("  FAIL: %s:%d: %s == %s (got %d, expected %d)\n", \
+               __FILE__, __LINE__, #a, #b, (int)(a), (int)(b)); \
+        g_tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define TEST_PASS() do { \
+    g_tests_passed++; \
+    printf("  PASS: %s\n", g_current_test); \
+} while(0)
+
+/* ============================================================================
+ * Panels
+ * ============================================================================ */
+
+#define PANEL_COUNT 8
+#define PANEL_FRAMES 20
+
+typedef struct Panel {
+    int variant;
+    void *clay_memory;
+    Clay_Context *clay;
+    ClayKit_Theme theme;
+    ClayKit_State state_buf[64];
+    ClayKit_Context kit;
+    uint8_t frame_arena[8 * 1024];
+    uint64_t digests[PANEL_FRAMES];
+} Panel;
+
+static Clay_Dimensions measure_text(Clay_StringSlice text, Clay_TextElementConfig *config, void *user_data) {
+    (void)user_data;
+    Clay_Dimensions d;
+    d.width = (float)text.length * (float)config->fontSize * 0.5f;
+    d.height = (float)config->fontSize;
+    return d;
+}
+
+static void panel_init(Panel *p, int variant) {
+    uint32_t size = Clay_MinMemorySize();
+    p->variant = variant;
+    p->clay_memory = malloc(size);
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(size, p->clay_memory);
+    p->clay = Clay_Initialize(arena, (Clay_Dimensions){ 800, 600 }, (Clay_ErrorHandler){0});
+    Clay_SetMeasureTextFunction(measure_text, NULL);
+
+    p->theme = (variant % 2) ? CLAYKIT_THEME_DARK : CLAYKIT_THEME_LIGHT;
+    ClayKit_Init(&p->kit, &p->theme, p->state_buf, 64);
+    ClayKit_SetFrameArena(&p->kit, p->frame_arena, sizeof(p->frame_arena));
+}
+
+static void panel_free(Panel *p) {
+    free(p->clay_memory);
+}
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= bytes[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/* Hashes everything a renderer would see, following custom data pointers */
+static uint64_t digest_commands(Clay_RenderCommandArray cmds) {
+    uint64_t h = 14695981039346656037ull;
+    h = fnv1a(h, &cmds.length, sizeof(cmds.length));
+    for (int32_t i = 0; i < cmds.length; i++) {
+        Clay_RenderCommand *cmd = Clay_RenderCommandArray_Get(&cmds, i);
+        h = fnv1a(h, &cmd->commandType, sizeof(cmd->commandType));
+        h = fnv1a(h, &cmd->boundingBox, sizeof(cmd->boundingBox));
+        h = fnv1a(h, &cmd->id, sizeof(cmd->id));
+        switch (cmd->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_TextRenderData *t = &cmd->renderData.text;
+                h = fnv1a(h, t->stringContents.chars, (size_t)t->stringContents.length);
+                h = fnv1a(h, &t->textColor, sizeof(t->textColor));
+                h = fnv1a(h, &t->fontSize, sizeof(t->fontSize));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                h = fnv1a(h, &cmd->renderData.rectangle.backgroundColor,
+                          sizeof(cmd->renderData.rectangle.backgroundColor));
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                ClayKit_IconRenderData *icon = (ClayKit_IconRenderData *)cmd->renderData.custom.customData;
+                h = fnv1a(h, &icon->type, sizeof(icon->type));
+                h = fnv1a(h, &icon->icon_id, sizeof(icon->icon_id));
+                h = fnv1a(h, &icon->color, sizeof(icon->color));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return h;
+}
+
+static uint64_t panel_build(Panel *p, int frame) {
+    ClayKit_Context *ctx = &p->kit;
+    static const char *labels[] = { "Save", "Open", "Close", "Export" };
+
+    ClayKit_BeginFrame(ctx);
+    Clay_BeginLayout();
+
+    Clay__OpenElement();
+    Clay_ElementDeclaration root = {0};
+    root.layout.sizing.width.type = CLAY__SIZING_TYPE_GROW;
+    root.layout.sizing.height.type = CLAY__SIZING_TYPE_GROW;
+    root.layout.layoutDirection = CLAY_TOP_TO_BOTTOM;
+    Clay__ConfigureOpenElement(root);
+
+    /* Icon-heavy toolbar: more icons than the old 32-entry ring */
+    for (int i = 0; i < 24; i++) {
+        ClayKit_ButtonConfig cfg = {0};
+        cfg.color_scheme = (ClayKit_ColorScheme)((i + p->variant) % 5);
+        cfg.icon_left = (ClayKit_Icon){ (uint16_t)(1 + (i + p->variant) % 9), 0 };
+        cfg.icon_right = (ClayKit_Icon){ (uint16_t)(10 + (i * 3 + frame) % 7), 0 };
+        const char *label = labels[(i + p->variant) % 4];
+        ClayKit_Button(ctx, label, (int32_t)strlen(label), cfg);
+    }
+
+    /* Ordered list longer than the old 64-entry number ring */
+    ClayKit_ListConfig list_cfg = {0};
+    list_cfg.ordered = true;
+    ClayKit_ListBegin(ctx, list_cfg);
+    for (uint32_t i = 0; i < (uint32_t)(80 + p->variant * 10); i++) {
+        ClayKit_ListItemRaw(ctx, "Row", 3, i, list_cfg);
+    }
+    ClayKit_ListEnd();
+
+    Clay__CloseElement();
+
+    return digest_commands(Clay_EndLayout());
+}
+
+static void *panel_thread(void *arg) {
+    Panel *p = (Panel *)arg;
+    Clay_SetCurrentContext(p->clay);
+    for (int f = 0; f < PANEL_FRAMES; f++) {
+        p->digests[f] = panel_build(p, f);
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+TEST(parallel_build_matches_serial) {
+    static Panel serial[PANEL_COUNT];
+    static Panel parallel[PANEL_COUNT];
+    pthread_t threads[PANEL_COUNT];
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        panel_init(&serial[i], i);
+        panel_init(&parallel[i], i);
+    }
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        panel_thread(&serial[i]);
+    }
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        ASSERT_EQ(pthread_create(&threads[i], NULL, panel_thread, &parallel[i]), 0);
+    }
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        for (int f = 0; f < PANEL_FRAMES; f++) {
+            ASSERT(serial[i].digests[f] == parallel[i].digests[f]);
+        }
+        /* Panels differ from each other, so a shared buffer would show up */
+        if (i > 0) {
+            ASSERT(serial[i].digests[0] != serial[i - 1].digests[0]);
+        }
+        ASSERT_EQ(parallel[i].kit.stats.frame_arena.frame_overflows, 0);
+    }
+
+    for (int i = 0; i < PANEL_COUNT; i++) {
+        panel_free(&serial[i]);
+        panel_free(&parallel[i]);
+    }
+
+    TEST_PASS();
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void) {
+    printf("\n=== ClayKit Thread Tests ===\n\n");
+
+    printf("Parallel Layout:\n");
+    RUN_TEST(parallel_build_matches_serial);
+
+    printf("\n=== Results ===\n");
+    printf("Tests run:    %d\n", g_tests_run);
+    printf("Tests passed: %d\n", g_tests_passed);
+    printf("Tests failed: %d\n", g_tests_failed);
+
+    if (g_tests_failed > 0) {
+        printf("\nSOME TESTS FAILED!\n");
+        return 1;
+    }
+
+    printf("\nALL TESTS PASSED!\n");
+    return 0;
+}